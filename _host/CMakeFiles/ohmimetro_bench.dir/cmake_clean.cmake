@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ohmimetro_bench.dir/host/bench.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/host/bench.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/acquisition.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/acquisition.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/calibration.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/calibration.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/crc.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/crc.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/eseries.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/eseries.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/flash_log.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/flash_log.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/layout.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/layout.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/mains_filter.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/mains_filter.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/measurement.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/measurement.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/multichannel.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/multichannel.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/probe.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/probe.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/profile.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/profile.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/ranging.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/ranging.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/sample_stats.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/sample_stats.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/sorting.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/sorting.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/spsc_queue.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/spsc_queue.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/ssd1306.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/ssd1306.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/telemetry.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/telemetry.c.o.d"
+  "CMakeFiles/ohmimetro_bench.dir/lib/telemetry_frame.c.o"
+  "CMakeFiles/ohmimetro_bench.dir/lib/telemetry_frame.c.o.d"
+  "ohmimetro_bench"
+  "ohmimetro_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ohmimetro_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ohmimetro_bench_float.dir/host/bench.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/host/bench.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/acquisition.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/acquisition.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/calibration.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/calibration.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/crc.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/crc.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/eseries.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/eseries.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/flash_log.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/flash_log.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/layout.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/layout.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/mains_filter.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/mains_filter.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/measurement.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/measurement.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/multichannel.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/multichannel.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/probe.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/probe.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/profile.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/profile.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/ranging.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/ranging.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/sample_stats.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/sample_stats.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/sorting.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/sorting.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/spsc_queue.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/spsc_queue.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/ssd1306.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/ssd1306.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/telemetry.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/telemetry.c.o.d"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/telemetry_frame.c.o"
+  "CMakeFiles/ohmimetro_bench_float.dir/lib/telemetry_frame.c.o.d"
+  "ohmimetro_bench_float"
+  "ohmimetro_bench_float.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ohmimetro_bench_float.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
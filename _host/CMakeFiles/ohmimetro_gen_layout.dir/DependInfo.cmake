@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/host/gen_layout.c" "CMakeFiles/ohmimetro_gen_layout.dir/host/gen_layout.c.o" "gcc" "CMakeFiles/ohmimetro_gen_layout.dir/host/gen_layout.c.o.d"
+  "/root/repo/lib/layout.c" "CMakeFiles/ohmimetro_gen_layout.dir/lib/layout.c.o" "gcc" "CMakeFiles/ohmimetro_gen_layout.dir/lib/layout.c.o.d"
+  "/root/repo/lib/ssd1306.c" "CMakeFiles/ohmimetro_gen_layout.dir/lib/ssd1306.c.o" "gcc" "CMakeFiles/ohmimetro_gen_layout.dir/lib/ssd1306.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
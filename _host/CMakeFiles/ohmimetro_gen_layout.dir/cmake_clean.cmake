@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ohmimetro_gen_layout.dir/host/gen_layout.c.o"
+  "CMakeFiles/ohmimetro_gen_layout.dir/host/gen_layout.c.o.d"
+  "CMakeFiles/ohmimetro_gen_layout.dir/lib/layout.c.o"
+  "CMakeFiles/ohmimetro_gen_layout.dir/lib/layout.c.o.d"
+  "CMakeFiles/ohmimetro_gen_layout.dir/lib/ssd1306.c.o"
+  "CMakeFiles/ohmimetro_gen_layout.dir/lib/ssd1306.c.o.d"
+  "ohmimetro_gen_layout"
+  "ohmimetro_gen_layout.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ohmimetro_gen_layout.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/host/hal_sim.c" "CMakeFiles/ohmimetro_sim.dir/host/hal_sim.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/host/hal_sim.c.o.d"
+  "/root/repo/lib/acquisition.c" "CMakeFiles/ohmimetro_sim.dir/lib/acquisition.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/acquisition.c.o.d"
+  "/root/repo/lib/calibration.c" "CMakeFiles/ohmimetro_sim.dir/lib/calibration.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/calibration.c.o.d"
+  "/root/repo/lib/crc.c" "CMakeFiles/ohmimetro_sim.dir/lib/crc.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/crc.c.o.d"
+  "/root/repo/lib/eseries.c" "CMakeFiles/ohmimetro_sim.dir/lib/eseries.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/eseries.c.o.d"
+  "/root/repo/lib/flash_log.c" "CMakeFiles/ohmimetro_sim.dir/lib/flash_log.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/flash_log.c.o.d"
+  "/root/repo/lib/mains_filter.c" "CMakeFiles/ohmimetro_sim.dir/lib/mains_filter.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/mains_filter.c.o.d"
+  "/root/repo/lib/measurement.c" "CMakeFiles/ohmimetro_sim.dir/lib/measurement.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/measurement.c.o.d"
+  "/root/repo/lib/multichannel.c" "CMakeFiles/ohmimetro_sim.dir/lib/multichannel.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/multichannel.c.o.d"
+  "/root/repo/lib/probe.c" "CMakeFiles/ohmimetro_sim.dir/lib/probe.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/probe.c.o.d"
+  "/root/repo/lib/profile.c" "CMakeFiles/ohmimetro_sim.dir/lib/profile.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/profile.c.o.d"
+  "/root/repo/lib/ranging.c" "CMakeFiles/ohmimetro_sim.dir/lib/ranging.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/ranging.c.o.d"
+  "/root/repo/lib/sample_stats.c" "CMakeFiles/ohmimetro_sim.dir/lib/sample_stats.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/sample_stats.c.o.d"
+  "/root/repo/lib/scheduler.c" "CMakeFiles/ohmimetro_sim.dir/lib/scheduler.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/scheduler.c.o.d"
+  "/root/repo/lib/sorting.c" "CMakeFiles/ohmimetro_sim.dir/lib/sorting.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/sorting.c.o.d"
+  "/root/repo/lib/spsc_queue.c" "CMakeFiles/ohmimetro_sim.dir/lib/spsc_queue.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/spsc_queue.c.o.d"
+  "/root/repo/lib/ssd1306.c" "CMakeFiles/ohmimetro_sim.dir/lib/ssd1306.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/ssd1306.c.o.d"
+  "/root/repo/lib/telemetry.c" "CMakeFiles/ohmimetro_sim.dir/lib/telemetry.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/telemetry.c.o.d"
+  "/root/repo/lib/telemetry_frame.c" "CMakeFiles/ohmimetro_sim.dir/lib/telemetry_frame.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/lib/telemetry_frame.c.o.d"
+  "/root/repo/main.c" "CMakeFiles/ohmimetro_sim.dir/main.c.o" "gcc" "CMakeFiles/ohmimetro_sim.dir/main.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ohmimetro_sim.dir/host/hal_sim.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/host/hal_sim.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/acquisition.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/acquisition.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/calibration.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/calibration.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/crc.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/crc.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/eseries.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/eseries.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/flash_log.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/flash_log.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/mains_filter.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/mains_filter.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/measurement.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/measurement.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/multichannel.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/multichannel.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/probe.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/probe.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/profile.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/profile.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/ranging.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/ranging.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/sample_stats.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/sample_stats.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/scheduler.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/scheduler.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/sorting.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/sorting.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/spsc_queue.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/spsc_queue.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/ssd1306.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/ssd1306.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/telemetry.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/telemetry.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/lib/telemetry_frame.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/lib/telemetry_frame.c.o.d"
+  "CMakeFiles/ohmimetro_sim.dir/main.c.o"
+  "CMakeFiles/ohmimetro_sim.dir/main.c.o.d"
+  "ohmimetro_sim"
+  "ohmimetro_sim.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ohmimetro_sim.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
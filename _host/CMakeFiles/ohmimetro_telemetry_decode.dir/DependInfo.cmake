@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/host/telemetry_decode.c" "CMakeFiles/ohmimetro_telemetry_decode.dir/host/telemetry_decode.c.o" "gcc" "CMakeFiles/ohmimetro_telemetry_decode.dir/host/telemetry_decode.c.o.d"
+  "/root/repo/lib/crc.c" "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/crc.c.o" "gcc" "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/crc.c.o.d"
+  "/root/repo/lib/telemetry_frame.c" "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/telemetry_frame.c.o" "gcc" "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/telemetry_frame.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ohmimetro_telemetry_decode.dir/host/telemetry_decode.c.o"
+  "CMakeFiles/ohmimetro_telemetry_decode.dir/host/telemetry_decode.c.o.d"
+  "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/crc.c.o"
+  "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/crc.c.o.d"
+  "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/telemetry_frame.c.o"
+  "CMakeFiles/ohmimetro_telemetry_decode.dir/lib/telemetry_frame.c.o.d"
+  "ohmimetro_telemetry_decode"
+  "ohmimetro_telemetry_decode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ohmimetro_telemetry_decode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,2519 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include "../lib/hal.h"
+#include "../lib/ssd1306.h"
+#include "../lib/font.h"
+#include "../lib/layout.h"
+#include "../lib/layout_bitmap.h"
+#include "../lib/spsc_queue.h"
+#include "../lib/measurement.h"
+#include "../lib/sample_stats.h"
+#include "../lib/acquisition.h"
+#include "../lib/mains_filter.h"
+#include "../lib/ranging.h"
+#include "../lib/calibration.h"
+#include "../lib/crc.h"
+#include "../lib/telemetry.h"
+#include "../lib/telemetry_frame.h"
+#include "../lib/sorting.h"
+#include "../lib/probe.h"
+#include "../lib/multichannel.h"
+#include "../lib/flash_log.h"
+#include "../lib/profile.h"
+#include "../lib/ws2818b.h"
+
+// Benchmarks de host dos kernels do ohmímetro. Cada caso imprime uma linha
+// "nome,ns_por_op" com o menor tempo entre várias rodadas; as linhas com '#'
+// são informativas.
+//
+// Comparação com uma execução anterior: OHMIMETRO_BENCH_BASELINE aponta para
+// a saída salva do mesmo bench, e OHMIMETRO_BENCH_THRESHOLD é a piora aceita
+// em % (padrão 20). Os casos presentes na referência ganham as colunas
+// "ns_referencia,variacao_%"; as pioras acima do limite vão para o stderr e o
+// bench termina com código 2 (as verificações que falham terminam com 1).
+
+#define BENCH_ROUNDS 7
+#define BENCH_BASELINE_MAX 128
+#define BENCH_DEFAULT_THRESHOLD 20.0
+
+// Impede que o compilador descarte o resultado dos kernels
+static volatile uint8_t bench_sink;
+
+// O driver do display só precisa de um destino para o I2C; as escritas
+// assíncronas terminam imediatamente
+void hal_i2c_write(uint8_t port, uint8_t address, const uint8_t *src, size_t len) {
+  (void)port;
+  (void)address;
+  (void)len;
+  bench_sink = src[0];
+}
+
+// GDDRAM do display, no layout do ram_buffer, montada a partir das janelas
+// enviadas. Com `bench_i2c_fail_at` em 0, a escrita seguinte não começa (I2C
+// ou DMA ocupados).
+static uint8_t bench_gddram[WIDTH * HEIGHT / 8 + 1];
+static int bench_i2c_fail_at = -1;
+
+bool hal_i2c_write_async(uint8_t port, uint8_t address, const uint8_t *src, size_t len,
+                         hal_i2c_done_cb_t cb, void *ctx) {
+  if (bench_i2c_fail_at >= 0 && bench_i2c_fail_at-- == 0) return false;
+
+  // Janela: 6 comandos de endereçamento (0x80, comando) e os dados após 0x40
+  if (len > 13 && src[0] == 0x80 && src[12] == 0x40) {
+    uint8_t c0 = src[3], c1 = src[5], p0 = src[9], p1 = src[11];
+    size_t k = 13;
+    for (uint16_t x = c0; x <= c1; ++x)
+      for (uint8_t p = p0; p <= p1 && k < len; ++p)
+        bench_gddram[x * (HEIGHT / 8) + p + 1] = src[k++];
+  }
+
+  hal_i2c_write(port, address, src, len);
+  if (cb) cb(ctx);
+  return true;
+}
+
+void hal_idle_wait(void) {
+}
+
+// A matriz de LEDs só monta o quadro; o envio termina imediatamente
+void hal_ws2818b_init(uint pin) {
+  (void)pin;
+}
+
+static uint32_t bench_led_writes;
+
+bool hal_ws2818b_write(const uint32_t *words, size_t count) {
+  bench_sink = words[count - 1] >> 8;
+  bench_led_writes++;
+  return true;
+}
+
+bool hal_ws2818b_busy(void) {
+  return false;
+}
+
+// As faixas de referência acionam GPIOs; aqui o divisor é simulado à parte
+void hal_gpio_output(uint gpio, bool high) {
+  (void)gpio;
+  (void)high;
+}
+
+void hal_gpio_float(uint gpio) {
+  (void)gpio;
+}
+
+void hal_sim_divider_attach(uint gpio, double ohms) {
+  (void)gpio;
+  (void)ohms;
+}
+
+void hal_sim_channel_attach(uint8_t input, uint gpio, double ohms) {
+  (void)input;
+  (void)gpio;
+  (void)ohms;
+}
+
+// Flash reservada em RAM, com a semântica de NOR da placa virtual. Com
+// `bench_flash_cut` em 0, a operação seguinte é interrompida por uma falta de
+// energia: só os primeiros `bench_flash_cut_bytes` bytes são apagados ou
+// gravados, e o controle volta ao setjmp de `bench_flash_power`.
+static uint8_t bench_flash[HAL_FLASH_RESERVED_SIZE];
+static int32_t bench_flash_cut = -1;
+static size_t bench_flash_cut_bytes;
+static jmp_buf bench_flash_power;
+
+static size_t bench_flash_op(size_t len) {
+  if (bench_flash_cut < 0 || bench_flash_cut-- > 0) return len;
+  return bench_flash_cut_bytes % len;
+}
+
+void hal_flash_read(uint32_t offset, void *dst, size_t len) {
+  memcpy(dst, bench_flash + offset, len);
+}
+
+void hal_flash_erase_sector(uint32_t offset) {
+  size_t len = bench_flash_op(HAL_FLASH_SECTOR_SIZE);
+  memset(bench_flash + offset, 0xFF, len);
+  if (len < HAL_FLASH_SECTOR_SIZE) longjmp(bench_flash_power, 1);
+}
+
+void hal_flash_program(uint32_t offset, const void *src, size_t len) {
+  const uint8_t *bytes = src;
+  size_t done = bench_flash_op(len);
+  for (size_t i = 0; i < done; ++i)
+    bench_flash[offset + i] &= bytes[i];
+  if (done < len) longjmp(bench_flash_power, 1);
+}
+
+// Relógio controlado pelos testes da telemetria
+static uint64_t bench_clock_us;
+
+uint64_t hal_time_us(void) {
+  return bench_clock_us;
+}
+
+// As sondas do perfil contam o mesmo relógio, em ciclos
+uint32_t hal_cycles(void) {
+  return (uint32_t)(bench_clock_us * HAL_CYCLES_PER_US) & HAL_CYCLES_MASK;
+}
+
+// Serial USB: guarda os bytes aceitos, até `bench_usb_limit` por chamada
+#define BENCH_USB_CAPACITY (1 << 16)
+
+static uint8_t bench_usb[BENCH_USB_CAPACITY];
+static size_t bench_usb_len;
+static size_t bench_usb_limit;
+
+size_t hal_usb_write(const uint8_t *src, size_t len) {
+  if (len > bench_usb_limit) len = bench_usb_limit;
+  if (len > BENCH_USB_CAPACITY - bench_usb_len) len = BENCH_USB_CAPACITY - bench_usb_len;
+  memcpy(bench_usb + bench_usb_len, src, len);
+  bench_usb_len += len;
+  return len;
+}
+
+// O anel do ADC não roda; o callback de bloco da aquisição é chamado direto
+static hal_adc_block_cb_t bench_adc_block_cb;
+
+void hal_adc_stream_init(uint8_t input, uint32_t sample_rate_hz, uint16_t *ring,
+                         size_t block_len, size_t block_count, hal_adc_block_cb_t cb) {
+  (void)input;
+  (void)sample_rate_hz;
+  (void)ring;
+  (void)block_len;
+  (void)block_count;
+  bench_adc_block_cb = cb;
+}
+
+void hal_adc_stream_start(void) {
+}
+
+void hal_adc_stream_stop(void) {
+}
+
+void hal_adc_stream_set_round_robin(uint8_t mask) {
+  (void)mask;
+}
+
+static double bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef struct {
+  char name[48];
+  double ns;
+} bench_baseline_t;
+
+static bench_baseline_t bench_baseline[BENCH_BASELINE_MAX];
+static size_t bench_baseline_count;
+static double bench_threshold = BENCH_DEFAULT_THRESHOLD;
+static unsigned bench_regressions;
+
+static void bench_load_baseline(void) {
+  const char *path = getenv("OHMIMETRO_BENCH_BASELINE");
+  const char *threshold = getenv("OHMIMETRO_BENCH_THRESHOLD");
+  char line[128];
+
+  if (threshold) bench_threshold = atof(threshold);
+  if (!path) return;
+
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "bench: referência %s não encontrada\n", path);
+    exit(1);
+  }
+  while (fgets(line, sizeof(line), file) && bench_baseline_count < BENCH_BASELINE_MAX) {
+    bench_baseline_t *entry = &bench_baseline[bench_baseline_count];
+    if (line[0] == '#' || sscanf(line, "%47[^,],%lf", entry->name, &entry->ns) != 2) continue;
+    bench_baseline_count++;
+  }
+  fclose(file);
+}
+
+static const bench_baseline_t *bench_find_baseline(const char *name) {
+  for (size_t i = 0; i < bench_baseline_count; ++i)
+    if (strcmp(bench_baseline[i].name, name) == 0) return &bench_baseline[i];
+  return NULL;
+}
+
+static void bench_run(const char *name, void (*fn)(void), unsigned iterations) {
+  double best = 0;
+
+  for (int round = 0; round < BENCH_ROUNDS; ++round) {
+    double start = bench_now_ns();
+    for (unsigned i = 0; i < iterations; ++i)
+      fn();
+    double elapsed = (bench_now_ns() - start) / iterations;
+    if (round == 0 || elapsed < best) best = elapsed;
+  }
+
+  const bench_baseline_t *baseline = bench_find_baseline(name);
+  if (!baseline || baseline->ns <= 0) {
+    printf("%s,%.1f\n", name, best);
+    return;
+  }
+
+  double change = (best / baseline->ns - 1.0) * 100.0;
+  printf("%s,%.1f,%.1f,%+.1f\n", name, best, baseline->ns, change);
+  if (change > bench_threshold) {
+    fprintf(stderr, "bench: %s piorou %.1f%% (%.1f ns, referência %.1f ns)\n", name, change, best, baseline->ns);
+    bench_regressions++;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Raster: caminho antigo pixel a pixel (referência) x núcleo por página
+// -----------------------------------------------------------------------------
+
+static ssd1306_t ssd;
+
+static void ref_pixel(ssd1306_t *s, uint8_t x, uint8_t y, bool value) {
+  uint16_t index = (y >> 3) + (x << 3) + 1;
+  uint8_t pixel = (y & 0b111);
+  if (value)
+    s->ram_buffer[index] |= (1 << pixel);
+  else
+    s->ram_buffer[index] &= ~(1 << pixel);
+}
+
+static void ref_fill(ssd1306_t *s, bool value) {
+  for (uint8_t y = 0; y < s->height; ++y)
+    for (uint8_t x = 0; x < s->width; ++x)
+      ref_pixel(s, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *s, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value) {
+  for (uint8_t x = left; x < left + width; ++x) {
+    ref_pixel(s, x, top, value);
+    ref_pixel(s, x, top + height - 1, value);
+  }
+  for (uint8_t y = top; y < top + height; ++y) {
+    ref_pixel(s, left, y, value);
+    ref_pixel(s, left + width - 1, y, value);
+  }
+}
+
+static void ref_line(ssd1306_t *s, int x0, int y0, int x1, int y1, bool value) {
+  int dx = abs(x1 - x0), dy = abs(y1 - y0);
+  int sx = (x0 < x1) ? 1 : -1, sy = (y0 < y1) ? 1 : -1;
+  int err = dx - dy;
+
+  while (true) {
+    ref_pixel(s, x0, y0, value);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = err * 2;
+    if (e2 > -dy) { err -= dy; x0 += sx; }
+    if (e2 < dx) { err += dx; y0 += sy; }
+  }
+}
+
+static void ref_draw_string(ssd1306_t *s, const char *str, uint8_t x, uint8_t y) {
+  while (*str) {
+    char c = *str++;
+    uint16_t index = ((unsigned char)c >= ' ' && (unsigned char)c <= 0x7F) ? (c - ' ') * 8 : 0;
+    for (uint8_t i = 0; i < 8; ++i)
+      for (uint8_t j = 0; j < 8; ++j)
+        ref_pixel(s, x + i, y + j, font[index + i] & (1 << j));
+    x += 8;
+    if (x + 8 >= s->width) { x = 0; y += 8; }
+    if (y + 8 >= s->height) break;
+  }
+}
+
+static void bench_fill_pixel(void) { ref_fill(&ssd, false); }
+static void bench_fill_page(void) { ssd1306_fill(&ssd, false); }
+
+static void bench_rect_pixel(void) { ref_rect(&ssd, 1, 1, 126, 62, true); }
+static void bench_rect_page(void) { ssd1306_rect(&ssd, 1, 1, 126, 62, true, false); }
+
+static void bench_hline_pixel(void) { ref_line(&ssd, 10, 22, 50, 22, true); }
+static void bench_hline_page(void) { ssd1306_line(&ssd, 10, 22, 50, 22, true); }
+
+static void bench_vline_pixel(void) { ref_line(&ssd, 8, 15, 8, 57, true); }
+static void bench_vline_page(void) { ssd1306_line(&ssd, 8, 15, 8, 57, true); }
+
+static void bench_dline_pixel(void) { ref_line(&ssd, 3, 60, 120, 4, true); }
+static void bench_dline_page(void) { ssd1306_line(&ssd, 3, 60, 120, 4, true); }
+
+static void bench_string_pixel(void) { ref_draw_string(&ssd, "vermelho", 60, 31); }
+static void bench_string_page(void) { ssd1306_draw_string(&ssd, "vermelho", 60, 31); }
+
+// Pixels avulsos pela API: uma diagonal da tela
+static void bench_pixel_set(void) {
+  for (uint8_t x = 0; x < WIDTH; ++x)
+    ssd1306_pixel(&ssd, x, x / 2, true);
+}
+
+// -----------------------------------------------------------------------------
+// Quadro base: layout redesenhado a cada ciclo x camada estática em flash
+// -----------------------------------------------------------------------------
+
+static void bench_layout_draw(void) {
+  ssd1306_fill(&ssd, false);
+  draw_display_layout(&ssd);
+  draw_static_labels(&ssd);
+}
+
+static void bench_layout_compose(void) { ssd1306_compose(&ssd, layout_background); }
+
+// Quadro completo da medição, como em render_task_run e display_task_run:
+// layout, valor, cores das faixas e a montagem das janelas sujas para o I2C.
+// Dois valores se alternam para que cada quadro tenha regiões alteradas.
+static const eseries_value_t frame_values[2] = {{47, 2}, {22, 4}};
+
+static void bench_frame_full(void) {
+  static unsigned frame;
+  char text[16];
+
+  const eseries_value_t *value = &frame_values[frame++ & 1];
+  get_band_color(value);
+
+  ssd1306_compose(&ssd, layout_background);
+  measurement_format_engineering(text, sizeof(text), value);
+  ssd1306_draw_text(&ssd, text, 77, 5, SSD1306_ALIGN_CENTER);
+  ssd1306_draw_string(&ssd, resistor_band_colors[2], 60, 31);
+  ssd1306_draw_string(&ssd, resistor_band_colors[1], 60, 42);
+  ssd1306_draw_string(&ssd, resistor_band_colors[0], 60, 52);
+  ssd1306_send_data(&ssd);
+}
+
+// Uma janela que não começa não pode travar o display: o envio termina e as
+// janelas que faltaram vão no próximo, mesmo sem quadro novo
+static bool display_matches(void) {
+  return memcmp(bench_gddram + 1, ssd.ram_buffer + 1, ssd.bufsize - 1) == 0;
+}
+
+static void check_display_retry(void) {
+  for (int fail_at = 0; fail_at < 3; ++fail_at) {
+    ssd1306_fill(&ssd, false);
+    ssd1306_send_data(&ssd);
+    memset(bench_gddram, 0, sizeof(bench_gddram));
+
+    // Textos em páginas e colunas distantes: uma janela por texto
+    ssd1306_draw_string(&ssd, "falha", 0, 0);
+    ssd1306_draw_string(&ssd, "no", 104, 24);
+    ssd1306_draw_string(&ssd, "I2C", 40, 56);
+    bench_i2c_fail_at = fail_at;
+    bool started = ssd1306_send_data(&ssd);
+    bench_i2c_fail_at = -1;
+
+    if (started != (fail_at > 0) || ssd1306_flush_busy(&ssd) || display_matches()) {
+      fprintf(stderr, "display: falha na janela %d com envio %d e busy %d\n", fail_at, started,
+              ssd1306_flush_busy(&ssd));
+      exit(1);
+    }
+    if (!ssd1306_send_data(&ssd) || !display_matches()) {
+      fprintf(stderr, "display: janelas da falha na janela %d não reenviadas\n", fail_at);
+      exit(1);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Matriz de LEDs: quadro empacotado (brilho e ordem GRB) de npWrite
+// -----------------------------------------------------------------------------
+
+// Mapeamento em serpentina (o mesmo da placa virtual), desenhos e o quadro
+// igual ao anterior, que não deve chegar à PIO
+
+static unsigned count_lit_leds(void) {
+  unsigned lit = 0;
+  for (uint i = 0; i < LED_COUNT; ++i)
+    lit += leds[i].R || leds[i].G || leds[i].B;
+  return lit;
+}
+
+static void check_matrix(void) {
+  static const uint8_t zero[3] = {1, 1, 1}, bar[3] = {0, 0, 9};
+  static const np_sprite_t cross = {0x11, 0x0A, 0x04, 0x0A, 0x11};
+  uint32_t seen = 0;
+
+  for (uint y = 0; y < MATRIX_SIZE; ++y)
+    for (uint x = 0; x < MATRIX_SIZE; ++x)
+      seen |= 1u << npIndex(x, y);
+  if (seen != (1u << LED_COUNT) - 1 || npIndex(0, 0) != 24 || npIndex(4, 0) != 20 || npIndex(4, 1) != 19 ||
+      npIndex(1, 2) != 13 || npIndex(3, 2) != 11 || npIndex(4, 4) != 0) {
+    fprintf(stderr, "matriz: mapeamento da serpentina\n");
+    exit(1);
+  }
+
+  npClear();
+  npDrawSprite(cross, 9, 0, 0);
+  npSetPixel(5, 0, 9, 9, 9);
+  npSetPixel(-1, 2, 9, 9, 9);
+  if (count_lit_leds() != 9 || leds[npIndex(2, 2)].R != 9 || leds[npIndex(1, 0)].R != 0) {
+    fprintf(stderr, "matriz: desenho\n");
+    exit(1);
+  }
+
+  // Indicador: zero sozinho, um LED a 1/4 da escala (arredondado), dois
+  // saturados; barra de 3/5
+  static const struct { int32_t value; int left, right; } gauges[] = {
+    {0, 0, 0}, {12000, 0, 0}, {13000, 0, 1}, {-13000, 1, 0}, {-37000, 1, 0}, {38000, 0, 2}, {-900000, 2, 0},
+  };
+  for (size_t i = 0; i < sizeof(gauges) / sizeof(gauges[0]); ++i) {
+    npClear();
+    npDrawGauge(4, gauges[i].value, 50000, zero, bar);
+    int left = (leds[npIndex(1, 4)].B == 9) + (leds[npIndex(0, 4)].B == 9);
+    int right = (leds[npIndex(3, 4)].B == 9) + (leds[npIndex(4, 4)].B == 9);
+    if (leds[npIndex(2, 4)].R != 1 || left != gauges[i].left || right != gauges[i].right ||
+        count_lit_leds() != 1u + left + right) {
+      fprintf(stderr, "matriz: indicador com %d ppm: %d a esquerda, %d a direita\n", gauges[i].value, left, right);
+      exit(1);
+    }
+  }
+  npClear();
+  npDrawBar(0, 60, 100, 0, 9, 0);
+  if (count_lit_leds() != 3 || leds[npIndex(2, 0)].G != 9) {
+    fprintf(stderr, "matriz: barra\n");
+    exit(1);
+  }
+
+  // Quadro repetido: só o primeiro vai para a PIO; a tabela de gama e brilho
+  // entra no quadro
+  npSetLED(0, 200, 100, 50);
+  uint32_t writes = bench_led_writes;
+  npWrite();
+  npWrite();
+  uint32_t packed = ((uint32_t)brightness_lut[100] << 24) | ((uint32_t)brightness_lut[200] << 16) |
+                    ((uint32_t)brightness_lut[50] << 8);
+  if (np_frame[0] != packed || brightness_lut[128] == 128) {
+    fprintf(stderr, "matriz: quadro %08x sem a gama\n", np_frame[0]);
+    exit(1);
+  }
+  npSetLED(0, 201, 100, 50);
+  npWrite();
+  npSetLED(1, 0, 0, 255);
+  npWrite();
+  if (bench_led_writes - writes != 3 || np_frames_skipped != 1) {
+    fprintf(stderr, "matriz: %u quadros enviados, %u pulados\n", bench_led_writes - writes, np_frames_skipped);
+    exit(1);
+  }
+}
+
+static void bench_leds_write(void) {
+  static uint8_t shade;
+
+  shade++;
+  for (uint i = 0; i < LED_COUNT; ++i)
+    npSetLED(i, shade + i, shade ^ i, 255 - shade);
+  npWrite();
+}
+
+// -----------------------------------------------------------------------------
+// Fila SPSC entre núcleos: produtor e consumidor em threads separadas. Além do
+// tempo por registro, verifica que o consumidor nunca vê um registro rasgado
+// nem fora de ordem, mesmo com o produtor sobrescrevendo os mais antigos.
+// -----------------------------------------------------------------------------
+
+#define QUEUE_STRESS_RECORDS 2000000u
+
+static spsc_queue_t queue;
+static atomic_bool queue_done;
+
+static void *queue_producer(void *arg) {
+  (void)arg;
+  measurement_record_t record = {0};
+
+  for (uint32_t i = 1; i <= QUEUE_STRESS_RECORDS; ++i) {
+    record.timestamp_ms = i;
+    record.average_adc = (float)(i & 0xFFFF);
+    record.resistance = (float)(i & 0xFFFF) * 2.0f;
+    spsc_queue_push(&queue, &record);
+  }
+
+  atomic_store(&queue_done, true);
+  return NULL;
+}
+
+static void bench_queue_stress(void) {
+  spsc_queue_init(&queue);
+  atomic_store(&queue_done, false);
+
+  pthread_t producer;
+  double start = bench_now_ns();
+  pthread_create(&producer, NULL, queue_producer, NULL);
+
+  measurement_record_t record;
+  uint32_t last = 0, received = 0;
+
+  while (true) {
+    bool done = atomic_load(&queue_done);
+    if (!spsc_queue_pop(&queue, &record)) {
+      if (done) break;
+      continue;
+    }
+
+    if (record.timestamp_ms <= last ||
+        record.average_adc != (float)(record.timestamp_ms & 0xFFFF) ||
+        record.resistance != record.average_adc * 2.0f) {
+      fprintf(stderr, "queue.spsc: registro inconsistente (%u depois de %u)\n", record.timestamp_ms, last);
+      exit(1);
+    }
+    last = record.timestamp_ms;
+    received++;
+  }
+
+  pthread_join(producer, NULL);
+  double elapsed = (bench_now_ns() - start) / QUEUE_STRESS_RECORDS;
+
+  if (last != QUEUE_STRESS_RECORDS || received + queue.dropped != QUEUE_STRESS_RECORDS) {
+    fprintf(stderr, "queue.spsc: %u recebidos + %u descartados != %u\n", received, queue.dropped, QUEUE_STRESS_RECORDS);
+    exit(1);
+  }
+
+  printf("queue.spsc.stress,%.1f\n", elapsed);
+}
+
+// -----------------------------------------------------------------------------
+// Séries E: busca antiga (normalização por divisões, varredura linear e powf)
+// x extração da década e busca binária nos pontos médios
+// -----------------------------------------------------------------------------
+
+static const float ref_e24_values[24] = {1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0, 3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1};
+
+// Divisor em float, como o pipeline antes do ponto fixo
+static float ref_resistance(float reference_resistor, float average_adc) {
+  return (reference_resistor * average_adc) / (ADC_RESOLUTION - average_adc);
+}
+
+static float nearest_float(eseries_t series, float value) {
+  eseries_value_t nearest;
+  if (!eseries_nearest(series, value, &nearest)) return 0.0f;
+  return eseries_to_float(nearest);
+}
+
+static float ref_closest_e24(float resistor_value) {
+  if (resistor_value <= 0) return 0.0;
+
+  float normalized_resistor = resistor_value;
+  float exponent = 0.0f;
+  while (normalized_resistor >= 10) {
+    normalized_resistor = normalized_resistor / 10;
+    exponent = exponent + 1.0;
+  }
+
+  float closest_resistor = ref_e24_values[0];
+  float min_diff = fabs(normalized_resistor - ref_e24_values[0]);
+  for (int i = 0; i < 24; i++) {
+    float curr_diff = fabs(normalized_resistor - ref_e24_values[i]);
+    if (curr_diff < min_diff) {
+      min_diff = curr_diff;
+      closest_resistor = ref_e24_values[i];
+    }
+  }
+
+  return closest_resistor * powf(10.0, exponent);
+}
+
+// Entradas de uma medição típica: todos os códigos do ADC com R_ref = 470
+#define ESERIES_INPUTS 4094
+static float eseries_inputs[ESERIES_INPUTS];
+static volatile float eseries_sink;
+
+static void bench_e24_linear(void) {
+  for (int i = 0; i < ESERIES_INPUTS; i += 37) eseries_sink = ref_closest_e24(eseries_inputs[i]);
+}
+
+static void bench_e24_lookup(void) {
+  for (int i = 0; i < ESERIES_INPUTS; i += 37) eseries_sink = nearest_float(ESERIES_E24, eseries_inputs[i]);
+}
+
+static void bench_e192_lookup(void) {
+  for (int i = 0; i < ESERIES_INPUTS; i += 37) eseries_sink = nearest_float(ESERIES_E192, eseries_inputs[i]);
+}
+
+static void bench_bands_e96(void) {
+  eseries_value_t nearest;
+  for (int i = 0; i < ESERIES_INPUTS; i += 37) {
+    eseries_nearest(ESERIES_E96, eseries_inputs[i], &nearest);
+    get_band_color_series(ESERIES_E96, &nearest);
+  }
+}
+
+// Compara a busca nova com a antiga em todos os códigos do ADC e, de 1 Ω a
+// 10 MΩ, em um de cada 16 floats. A única divergência aceita é a da busca
+// antiga depois de 9.55 na década, que volta para 9.1 em vez de subir para
+// 10; além dela, só empates a menos de 1e-5 de um ponto médio. Também confere
+// que todo valor de cada série, de 1 mΩ a 1 GΩ, é o mais próximo de si mesmo.
+static void check_eseries(void) {
+  uint32_t checked = 0, wraps = 0, ties = 0;
+
+  for (uint32_t bits = 0x3F800000u; ; bits += 16) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value >= 1e7f) break;
+
+    float expected = ref_closest_e24(value), got = nearest_float(ESERIES_E24, value);
+    checked++;
+    if (fabsf(got - expected) <= expected * 1e-6f) continue;
+
+    // 9.1 x 10^k na busca antiga e 10^(k+1) na nova
+    float decade = expected / 9.1f;
+    if (fabsf(got - decade * 10.0f) <= got * 1e-5f && value >= decade * 9.5f) {
+      wraps++;
+      continue;
+    }
+
+    // Empate: a entrada está no ponto médio entre as duas respostas
+    float midpoint = (got + expected) * 0.5f;
+    if (fabsf(value - midpoint) <= midpoint * 1e-5f) {
+      ties++;
+      continue;
+    }
+
+    fprintf(stderr, "eseries: %.9g => %.9g (antiga: %.9g)\n", value, got, expected);
+    exit(1);
+  }
+
+  for (int i = 0; i < ESERIES_INPUTS; ++i) {
+    float value = eseries_inputs[i];
+    float expected = ref_closest_e24(value), got = nearest_float(ESERIES_E24, value);
+    if (value >= 1.0f && fabsf(got - expected) > expected * 1e-6f && fabsf(expected / 9.1f * 10.0f - got) > got * 1e-5f) {
+      fprintf(stderr, "eseries: código %d (%.9g) => %.9g (antiga: %.9g)\n", i + 1, value, got, expected);
+      exit(1);
+    }
+  }
+
+  // Varredura de 1 mΩ a 1 GΩ em passos de 0.02%, bem menores que o intervalo
+  // entre valores da E192: cada década precisa produzir exatamente os valores
+  // da série, em ordem
+  for (eseries_t series = ESERIES_E6; series <= ESERIES_E192; ++series) {
+    eseries_value_t last = {0, 0}, value, self;
+    uint32_t distinct = 0;
+
+    for (float probe = 1e-3f; probe < 1e9f; probe *= 1.0002f) {
+      eseries_nearest(series, probe, &value);
+      if (value.mantissa == last.mantissa && value.exponent == last.exponent) continue;
+
+      if (distinct > 0 && eseries_to_float(value) <= eseries_to_float(last)) {
+        fprintf(stderr, "eseries: série %d volta de %.9g para %.9g\n", series, eseries_to_float(last), eseries_to_float(value));
+        exit(1);
+      }
+      if (!eseries_nearest(series, eseries_to_float(value), &self) || self.mantissa != value.mantissa || self.exponent != value.exponent) {
+        fprintf(stderr, "eseries: série %d, %.9g não é o mais próximo de si mesmo\n", series, eseries_to_float(value));
+        exit(1);
+      }
+      last = value;
+      distinct++;
+    }
+
+    // 12 décadas mais o 1 GΩ do fim da última
+    if (distinct != 12u * eseries_size(series) + 1) {
+      fprintf(stderr, "eseries: série %d com %u valores\n", series, distinct);
+      exit(1);
+    }
+  }
+
+  printf("# eseries: %u entradas, %u na virada de década, %u empates\n", checked, wraps, ties);
+}
+
+// -----------------------------------------------------------------------------
+// Estatística adaptativa: medições sobre sinais sintéticos com ruído. Cada
+// caso informa quantas amostras a regra de parada usou em média e o maior
+// erro da resistência estimada, e falha se o erro passar do limite do caso.
+// -----------------------------------------------------------------------------
+
+#define STATS_MEASUREMENTS 500
+#define STATS_RATE_HZ 2500
+
+typedef struct {
+  const char *name;
+  float code;         // Código verdadeiro do ADC
+  float noise;        // Ruído uniforme, em LSB (+-)
+  float hum;          // Amplitude do zumbido de 60 Hz, em LSB
+  uint32_t bounce;    // A cada quantos blocos um sai saturado (0 = nunca)
+  sample_stats_estimator_t estimator;
+  float max_error;    // Erro relativo máximo aceito na resistência
+} stats_trace_t;
+
+static uint32_t stats_lcg = 12345;
+
+static float stats_noise(float amplitude) {
+  stats_lcg = stats_lcg * 1664525u + 1013904223u;
+  return ((float)(stats_lcg >> 8) / 16777216.0f * 2.0f - 1.0f) * amplitude;
+}
+
+static void stats_block(const stats_trace_t *trace, uint64_t first_sample, uint32_t block,
+                        acquisition_result_t *result) {
+  result->sum = 0;
+  result->count = ACQUISITION_BLOCK_LEN;
+
+  for (uint32_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i) {
+    float t = (float)(first_sample + i) / STATS_RATE_HZ;
+    float code = trace->code + stats_noise(trace->noise) + trace->hum * sinf(2.0f * (float)M_PI * 60.0f * t);
+    if (trace->bounce && block % trace->bounce == trace->bounce - 1) code = ADC_RESOLUTION;
+    if (code < 0) code = 0;
+    if (code > ADC_RESOLUTION) code = ADC_RESOLUTION;
+    result->sum += (uint32_t)(code + 0.5f);
+  }
+}
+
+static void check_stats_trace(const stats_trace_t *trace) {
+  sample_stats_config_t config = {
+    .estimator = trace->estimator,
+    .min_samples = 300,
+    .max_samples = 1000,
+    .relative_step = eseries_relative_step(ESERIES_E24),
+    .step_fraction = FRACTION(0.1),
+  };
+  float truth = ref_resistance(470, trace->code);
+  uint64_t sample = 0, total_samples = 0;
+  uint32_t block = 0;
+  float worst = 0.0f;
+  sample_stats_t stats;
+  acquisition_result_t result;
+
+  for (int m = 0; m < STATS_MEASUREMENTS; ++m) {
+    sample_stats_reset(&stats);
+    do {
+      stats_block(trace, sample, block++, &result);
+      sample += result.count;
+      sample_stats_add_block(&stats, result.sum, result.count);
+    } while (!sample_stats_done(&stats, &config));
+
+    float estimate = adc_mean_to_float(sample_stats_estimate(&stats, &config));
+    float error = fabsf(ref_resistance(470, estimate) - truth) / truth;
+    if (error > worst) worst = error;
+    total_samples += stats.samples;
+  }
+
+  printf("# stats.%s: %.0f amostras por medição, erro máximo %.3f%%\n",
+         trace->name, (double)total_samples / STATS_MEASUREMENTS, worst * 100.0f);
+
+  if (worst > trace->max_error) {
+    fprintf(stderr, "stats.%s: erro %.3f%% acima de %.3f%%\n", trace->name, worst * 100.0f, trace->max_error * 100.0f);
+    exit(1);
+  }
+}
+
+static void check_stats(void) {
+  static const stats_trace_t traces[] = {
+    {"stable",  2000.0f,  2.0f,  0.0f, 0, SAMPLE_STATS_TRIMMED_MEAN, 0.002f},
+    {"noisy",   2000.0f, 80.0f,  0.0f, 0, SAMPLE_STATS_TRIMMED_MEAN, 0.02f},
+    {"hum",     2000.0f,  2.0f, 30.0f, 0, SAMPLE_STATS_TRIMMED_MEAN, 0.01f},
+    {"bounce.mean",   2000.0f, 2.0f, 0.0f, 5, SAMPLE_STATS_MEAN, 1.0f},
+    {"bounce.trimmed", 2000.0f, 2.0f, 0.0f, 5, SAMPLE_STATS_TRIMMED_MEAN, 0.01f},
+    {"bounce.median",  2000.0f, 2.0f, 0.0f, 5, SAMPLE_STATS_MEDIAN, 0.01f},
+    {"low",       40.0f,  2.0f,  0.0f, 0, SAMPLE_STATS_TRIMMED_MEAN, 0.03f},
+  };
+
+  for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); ++i)
+    check_stats_trace(&traces[i]);
+}
+
+// -----------------------------------------------------------------------------
+// Faixa automática: divisor ideal com ruído de +-2 LSB, de 1 Ω a 1 MΩ. Compara
+// a referência fixa de 470 Ω com a escolha automática entre 47 Ω e 470 kΩ,
+// usando a mesma regra de parada do firmware.
+// -----------------------------------------------------------------------------
+
+static const reference_range_t bench_ranges[] = {
+  {16, RESISTANCE_OHMS(47), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {17, RESISTANCE_OHMS(470), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {18, RESISTANCE_OHMS(4700), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {19, RESISTANCE_OHMS(47000), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {20, RESISTANCE_OHMS(470000), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+};
+
+static void divider_block(float rx, float reference, acquisition_result_t *result) {
+  float code = ADC_RESOLUTION * rx / (reference + rx);
+
+  result->sum = 0;
+  result->count = ACQUISITION_BLOCK_LEN;
+  for (uint32_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i) {
+    float sample = code + stats_noise(2.0f);
+    if (sample < 0) sample = 0;
+    if (sample > ADC_RESOLUTION) sample = ADC_RESOLUTION;
+    result->sum += (uint32_t)(sample + 0.5f);
+  }
+}
+
+// Uma medição como no laço do firmware. Com `autorange` falso fica na faixa
+// de 470 Ω. Retorna o erro relativo e preenche as amostras usadas, incluindo
+// os blocos da leitura rápida.
+static float divider_measure(float rx, bool autorange, uint32_t *samples) {
+  sample_stats_config_t config = {
+    .estimator = SAMPLE_STATS_TRIMMED_MEAN,
+    .min_samples = 300,
+    .max_samples = 1000,
+    .relative_step = eseries_relative_step(ESERIES_E24),
+    .step_fraction = FRACTION(0.1),
+  };
+  acquisition_result_t result;
+  sample_stats_t stats;
+  uint32_t coarse = 0;
+
+  ranging_init(bench_ranges, 5, 1);
+  while (true) {
+    divider_block(rx, resistance_to_ohms(bench_ranges[ranging_current()].reference), &result);
+    uint8_t best = ranging_choose(measurement_average(result.sum, result.count));
+    if (!autorange || best == ranging_current() || coarse >= 5) break;
+
+    ranging_select(best);
+    // Bloco em andamento descartado na troca
+    coarse += 2 * ACQUISITION_BLOCK_LEN;
+  }
+
+  sample_stats_reset(&stats);
+  sample_stats_add_block(&stats, result.sum, result.count);
+  while (!sample_stats_done(&stats, &config)) {
+    divider_block(rx, resistance_to_ohms(bench_ranges[ranging_current()].reference), &result);
+    sample_stats_add_block(&stats, result.sum, result.count);
+  }
+
+  *samples = coarse + stats.samples;
+  return fabsf(resistance_to_ohms(ranging_resistance(sample_stats_estimate(&stats, &config))) - rx) / rx;
+}
+
+static void check_ranging(void) {
+  for (float rx = 1.0f; rx <= 1e6f; rx *= 10.0f) {
+    uint32_t fixed_samples, auto_samples;
+    float fixed_error = divider_measure(rx, false, &fixed_samples);
+    float auto_error = divider_measure(rx, true, &auto_samples);
+
+    printf("# ranging.%.0f: fixa 470 %u amostras, erro %.3f%%; automática (%.0f) %u amostras, erro %.3f%%\n",
+           rx, fixed_samples, fixed_error * 100.0f,
+           resistance_to_ohms(bench_ranges[ranging_current()].reference), auto_samples, auto_error * 100.0f);
+
+    if (auto_error > 0.01f) {
+      fprintf(stderr, "ranging.%.0f: erro %.3f%% na faixa automática\n", rx, auto_error * 100.0f);
+      exit(1);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Pipeline de medição por estágio: média, divisor, série E24 e texto. O mesmo
+// código roda em ohmimetro_bench (ponto fixo) e ohmimetro_bench_float (float);
+// os nomes dos casos indicam a versão.
+// -----------------------------------------------------------------------------
+
+#ifdef OHMIMETRO_FIXED_POINT
+#define PIPELINE_VARIANT "fixed"
+#else
+#define PIPELINE_VARIANT "float"
+#endif
+
+#define PIPELINE_INPUTS 64
+#define PIPELINE_BLOCK_SAMPLES 300
+
+static uint32_t pipeline_sums[PIPELINE_INPUTS];
+static adc_mean_t pipeline_means[PIPELINE_INPUTS];
+static resistance_t pipeline_resistances[PIPELINE_INPUTS];
+static eseries_value_t pipeline_values[PIPELINE_INPUTS];
+static char pipeline_text[16];
+
+static void bench_pipeline_average(void) {
+  for (int i = 0; i < PIPELINE_INPUTS; ++i)
+    pipeline_means[i] = measurement_average(pipeline_sums[i], PIPELINE_BLOCK_SAMPLES);
+}
+
+static void bench_pipeline_resistance(void) {
+  for (int i = 0; i < PIPELINE_INPUTS; ++i)
+    pipeline_resistances[i] = measurement_resistance(RESISTANCE_OHMS(470), pipeline_means[i]);
+}
+
+static void bench_pipeline_nearest(void) {
+  for (int i = 0; i < PIPELINE_INPUTS; ++i)
+    get_closest_e24_resistor(pipeline_resistances[i], &pipeline_values[i]);
+}
+
+static void bench_pipeline_format(void) {
+  for (int i = 0; i < PIPELINE_INPUTS; ++i)
+    bench_sink = measurement_format_ohms(pipeline_text, &pipeline_values[i]);
+}
+
+// Todos os códigos do ADC, de 0 a 4095, pela média, resistência, valor da E24
+// e cores das faixas; o tempo é o da varredura inteira
+static void bench_pipeline_sweep(void) {
+  eseries_value_t value;
+
+  for (uint32_t code = 0; code <= ADC_RESOLUTION; ++code) {
+    adc_mean_t mean = measurement_average(code * PIPELINE_BLOCK_SAMPLES + code % 7, PIPELINE_BLOCK_SAMPLES);
+    get_closest_e24_resistor(measurement_resistance(RESISTANCE_OHMS(470), mean), &value);
+    get_band_color(&value);
+  }
+  bench_sink = resistor_band_color_indexes[0];
+}
+
+static void bench_pipeline_bands(void) {
+  for (int i = 0; i < PIPELINE_INPUTS; ++i)
+    get_band_color(&pipeline_values[i]);
+}
+
+static void bench_pipeline(void) {
+  // Códigos espalhados pela escala, longe da saturação
+  for (int i = 0; i < PIPELINE_INPUTS; ++i)
+    pipeline_sums[i] = (uint32_t)(20 + i * 63) * PIPELINE_BLOCK_SAMPLES + i * 7;
+
+  bench_pipeline_average();
+  bench_pipeline_resistance();
+  bench_pipeline_nearest();
+
+  bench_run("pipeline." PIPELINE_VARIANT ".average", bench_pipeline_average, 200000);
+  bench_run("pipeline." PIPELINE_VARIANT ".resistance", bench_pipeline_resistance, 200000);
+  bench_run("pipeline." PIPELINE_VARIANT ".nearest", bench_pipeline_nearest, 50000);
+  bench_run("pipeline." PIPELINE_VARIANT ".format", bench_pipeline_format, 50000);
+  bench_run("pipeline." PIPELINE_VARIANT ".bands", bench_pipeline_bands, 50000);
+  bench_run("pipeline." PIPELINE_VARIANT ".sweep", bench_pipeline_sweep, 200);
+}
+
+#ifdef OHMIMETRO_FIXED_POINT
+// Compara o pipeline inteiro com a referência em double para todos os códigos
+// de 0 a 4095, inteiros (uma amostra) e fracionários (todas as somas de 300
+// amostras), em cada faixa de referência:
+// - a média em Q16 é a soma / contagem arredondada;
+// - a resistência fica a até 1 mΩ mais o efeito de meio LSB de Q16 no divisor;
+// - o valor da E24 é o da busca em float, salvo empates no ponto médio;
+// - o texto é igual ao "%.0f" do valor em float, para toda a E24 e a E192.
+static void check_pipeline_sum(resistance_t reference, uint32_t sum, uint32_t count, uint32_t *ties) {
+  adc_mean_t mean = measurement_average(sum, count);
+  uint64_t expected_mean = (uint64_t)llround((double)sum * 65536.0 / count);
+  if (mean != expected_mean) {
+    fprintf(stderr, "pipeline: média %u/%u => %u (esperado %llu)\n", sum, count, mean, (unsigned long long)expected_mean);
+    exit(1);
+  }
+
+  double code = (double)sum / count;
+  resistance_t resistance = measurement_resistance(reference, mean);
+  if (code >= ADC_RESOLUTION) {
+    if (resistance != RESISTANCE_INVALID) {
+      fprintf(stderr, "pipeline: fundo de escala sem RESISTANCE_INVALID\n");
+      exit(1);
+    }
+    return;
+  }
+
+  double expected = (double)reference * code / (ADC_RESOLUTION - code);
+  double slope = (double)reference * ADC_RESOLUTION / ((ADC_RESOLUTION - code) * (ADC_RESOLUTION - code));
+  if (fabs((double)resistance - expected) > 1.0 + slope / 65536.0) {
+    fprintf(stderr, "pipeline: código %.6f, R_ref %llu mΩ => %llu mΩ (esperado %.3f)\n",
+            code, (unsigned long long)reference, (unsigned long long)resistance, expected);
+    exit(1);
+  }
+
+  eseries_value_t got, want;
+  bool got_valid = get_closest_e24_resistor(resistance, &got);
+  // A busca parte da resistência já quantizada em mΩ, como no firmware
+  bool want_valid = eseries_nearest(ESERIES_E24, (float)(resistance / 1000.0), &want);
+  if (got_valid != want_valid) {
+    // Só nas bordas da faixa aceita (1 mΩ e 10 GΩ)
+    if (resistance < 2 || resistance > 9900000000000ull) return;
+    fprintf(stderr, "pipeline: %llu mΩ fora da faixa em uma das versões\n", (unsigned long long)resistance);
+    exit(1);
+  }
+  if (!got_valid || (got.mantissa == want.mantissa && got.exponent == want.exponent)) return;
+
+  double midpoint = (eseries_to_float(got) + eseries_to_float(want)) * 500.0;
+  if (fabs((double)resistance - midpoint) <= midpoint * 1e-5) {
+    (*ties)++;
+    return;
+  }
+
+  fprintf(stderr, "pipeline: %llu mΩ => %u e%d (float: %u e%d)\n", (unsigned long long)resistance,
+          got.mantissa, got.exponent, want.mantissa, want.exponent);
+  exit(1);
+}
+
+static void check_pipeline_format(eseries_t series) {
+  char expected[24];
+
+  for (int8_t exponent = -5; exponent <= 7; ++exponent) {
+    for (float probe = 1.0f; probe < 10.0f; probe *= 1.002f) {
+      eseries_value_t value;
+      eseries_nearest(series, probe, &value);
+      value.exponent += exponent + 2;
+
+      measurement_format_ohms(pipeline_text, &value);
+      snprintf(expected, sizeof(expected), "%.0f", (double)value.mantissa * pow(10.0, value.exponent));
+      if (strcmp(pipeline_text, expected) != 0) {
+        fprintf(stderr, "pipeline: %u e%d => \"%s\" (float: \"%s\")\n", value.mantissa, value.exponent, pipeline_text, expected);
+        exit(1);
+      }
+    }
+  }
+}
+
+static void check_pipeline(void) {
+  uint32_t checked = 0, ties = 0;
+
+  for (size_t r = 0; r < sizeof(bench_ranges) / sizeof(bench_ranges[0]); ++r) {
+    resistance_t reference = bench_ranges[r].reference;
+
+    for (uint32_t code = 0; code <= ADC_RESOLUTION; ++code, ++checked)
+      check_pipeline_sum(reference, code, 1, &ties);
+
+    for (uint32_t sum = 0; sum <= ADC_RESOLUTION * PIPELINE_BLOCK_SAMPLES; ++sum, ++checked)
+      check_pipeline_sum(reference, sum, PIPELINE_BLOCK_SAMPLES, &ties);
+  }
+
+  check_pipeline_format(ESERIES_E24);
+  check_pipeline_format(ESERIES_E192);
+
+  printf("# pipeline: %u médias conferidas com a referência em float, %u empates na E24\n", checked, ties);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Calibração do ADC contra um modelo sintético do RP2040: offset, erro de
+// ganho, INL em arco e degraus de DNL nos códigos 512, 1536, 2560 e 3584
+// -----------------------------------------------------------------------------
+
+#define ADC_MODEL_OFFSET 6.5
+#define ADC_MODEL_GAIN 0.985
+#define ADC_MODEL_BOW 2.5
+#define ADC_MODEL_DNL_STEP -0.8
+
+// Código médio (contínuo) lido com a entrada em `ideal` códigos
+static double adc_model_mean(double ideal) {
+  double code = ADC_MODEL_GAIN * ideal + ADC_MODEL_OFFSET + ADC_MODEL_BOW * sin(M_PI * ideal / ADC_RESOLUTION);
+  for (int edge = 512; edge < ADC_RESOLUTION; edge += 1024)
+    if (code > edge) code += ADC_MODEL_DNL_STEP;
+  return code;
+}
+
+// Amostras quantizadas com ruído uniforme de +-2 LSB em volta da média
+static void adc_model_block(double ideal, uint16_t *samples, size_t count) {
+  static uint32_t lcg = 7;
+  double mean = adc_model_mean(ideal);
+
+  for (size_t i = 0; i < count; ++i) {
+    lcg = lcg * 1664525u + 1013904223u;
+    double code = mean + (double)(lcg >> 8) / 16777216.0 * 4.0 - 2.0;
+    code = floor(code + 0.5);
+    samples[i] = code < 0 ? 0 : code > ADC_RESOLUTION ? ADC_RESOLUTION : (uint16_t)code;
+  }
+}
+
+static acquisition_result_t calibration_result;
+
+static void calibration_capture(void) {
+  acquisition_poll(&calibration_result);
+}
+
+// Média de 20 blocos da aquisição (2000 amostras), com a tabela em uso
+static double calibration_measure(double ideal) {
+  uint16_t samples[ACQUISITION_BLOCK_LEN];
+  uint64_t sum = 0, count = 0;
+
+  for (int block = 0; block < 20; ++block) {
+    adc_model_block(ideal, samples, ACQUISITION_BLOCK_LEN);
+    bench_adc_block_cb(samples, ACQUISITION_BLOCK_LEN);
+    calibration_capture();
+    sum += calibration_result.sum;
+    count += calibration_result.count;
+  }
+  return (double)sum / count;
+}
+
+static uint16_t calibration_lut[CALIBRATION_LUT_SIZE];
+
+// Ajusta com `count` referências espalhadas pela escala, aplica a tabela na
+// aquisição e retorna o maior erro (em LSB) numa varredura de 40 a 4055
+static double calibration_trial(const char *name, const double *ideals, size_t count) {
+  calibration_point_t points[80];
+  calibration_t calibration;
+
+  acquisition_set_correction(NULL);
+  for (size_t i = 0; i < count; ++i) {
+    points[i].measured = ADC_MEAN(calibration_measure(ideals[i]));
+    points[i].expected = ADC_MEAN(ideals[i]);
+  }
+  if (!calibration_fit(points, count, &calibration)) {
+    fprintf(stderr, "calibration.%s: ajuste recusado\n", name);
+    exit(1);
+  }
+  calibration_build_lut(&calibration, calibration_lut);
+
+  double raw_error = 0.0, corrected_error = 0.0;
+  for (double ideal = 40.0; ideal <= 4055.0; ideal += 13.7) {
+    acquisition_set_correction(NULL);
+    double raw = fabs(calibration_measure(ideal) - ideal);
+    acquisition_set_correction(calibration_lut);
+    double corrected = fabs(calibration_measure(ideal) - ideal);
+    if (raw > raw_error) raw_error = raw;
+    if (corrected > corrected_error) corrected_error = corrected;
+  }
+
+  printf("# calibration.%s: %zu referências, erro máximo %.2f LSB sem correção, %.2f LSB com correção\n",
+         name, count, raw_error, corrected_error);
+  return corrected_error;
+}
+
+static void check_calibration(void) {
+  if (crc32_update(0, "123456789", 9) != 0xCBF43926u) {
+    fprintf(stderr, "crc32: valor de verificação incorreto\n");
+    exit(1);
+  }
+
+  acquisition_config_t config = {.input = 2, .sample_rate_hz = 2500, .correction = NULL};
+  acquisition_init(&config);
+  acquisition_start();
+
+  // Tabela neutra: mesmos códigos, em 1/16
+  calibration_t calibration;
+  calibration_identity(&calibration);
+  calibration_build_lut(&calibration, calibration_lut);
+  for (uint32_t code = 0; code < CALIBRATION_LUT_SIZE; ++code) {
+    uint32_t expected = code > ADC_RESOLUTION ? ADC_RESOLUTION : code;
+    if (calibration_lut[code] != expected << CALIBRATION_FRACTION_BITS) {
+      fprintf(stderr, "calibration: tabela neutra altera o código %u\n", code);
+      exit(1);
+    }
+  }
+
+  // Procedimento do firmware: curto, 100, 220, 470, 1k e 2k2 na faixa de 470
+  // ohms e ponteiras abertas
+  static const float resistors[] = {0, 100, 220, 470, 1000, 2200};
+  double device[sizeof(resistors) / sizeof(resistors[0]) + 1];
+  size_t device_count = 0;
+  for (size_t i = 0; i < sizeof(resistors) / sizeof(resistors[0]); ++i)
+    device[device_count++] = adc_mean_to_float(calibration_divider_code(RESISTANCE_OHMS(470), RESISTANCE_OHMS(resistors[i])));
+  device[device_count++] = adc_mean_to_float(calibration_divider_code(RESISTANCE_OHMS(470), RESISTANCE_INVALID));
+
+  // Varredura densa, como a de uma fonte de precisão registrada em bancada
+  double sweep[65];
+  for (size_t i = 0; i < 65; ++i)
+    sweep[i] = i * (ADC_RESOLUTION / 64.0);
+
+  double device_error = calibration_trial("device", device, device_count);
+  double sweep_error = calibration_trial("sweep", sweep, 65);
+  if (device_error > 1.0 || sweep_error > 1.0) {
+    fprintf(stderr, "calibration: correção acima do limite\n");
+    exit(1);
+  }
+
+  // Registro na flash: ida e volta, corrupção e flash apagada
+  calibration_t loaded;
+  calibration_t fitted;
+  calibration_point_t pair[2] = {{ADC_MEAN(10), ADC_MEAN(0)}, {ADC_MEAN(4000), ADC_MEAN(4095)}};
+  calibration_fit(pair, 2, &fitted);
+
+  memset(bench_flash, 0xFF, sizeof(bench_flash));
+  bool blank = calibration_load(&loaded);
+  calibration_save(&fitted);
+  bool saved = calibration_load(&loaded) && loaded.offset == fitted.offset && loaded.gain == fitted.gain &&
+               memcmp(loaded.inl, fitted.inl, sizeof(loaded.inl)) == 0;
+  bench_flash[CALIBRATION_FLASH_OFFSET + 12] ^= 0x10;
+  bool corrupted = calibration_load(&loaded);
+  if (blank || !saved || corrupted) {
+    fprintf(stderr, "calibration: registro da flash (apagada %d, gravada %d, corrompida %d)\n", blank, saved, corrupted);
+    exit(1);
+  }
+
+  acquisition_set_correction(NULL);
+}
+
+static uint16_t bench_adc_samples[ACQUISITION_BLOCK_LEN];
+
+static void bench_acquisition_block(void) {
+  bench_adc_block_cb(bench_adc_samples, ACQUISITION_BLOCK_LEN);
+  calibration_capture();
+}
+
+// Passagem dos blocos da IRQ ao leitor: um aviso e um resumo por bloco, em
+// ordem; com o leitor atrasado, só os mais recentes; e, depois de
+// acquisition_flush, nada do bloco em andamento
+static uint32_t handoff_notifies;
+
+static void handoff_notify(void) {
+  handoff_notifies++;
+}
+
+static void handoff_block(uint16_t level) {
+  uint16_t samples[ACQUISITION_BLOCK_LEN];
+  for (size_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i)
+    samples[i] = level + (i & 1 ? 3 : -3);
+  bench_adc_block_cb(samples, ACQUISITION_BLOCK_LEN);
+}
+
+static void check_acquisition(void) {
+  acquisition_config_t config = {.input = 2, .sample_rate_hz = 10000, .on_block = handoff_notify};
+  acquisition_result_t result;
+
+  acquisition_init(&config);
+  acquisition_start();
+  handoff_notifies = 0;
+
+  for (uint16_t block = 0; block < 6; ++block) {
+    uint16_t level = 1000 + 500 * block;
+    handoff_block(level);
+    if (handoff_notifies != block + 1u || !acquisition_poll(&result) ||
+        result.sum != level * ACQUISITION_BLOCK_LEN || result.count != ACQUISITION_BLOCK_LEN ||
+        acquisition_poll(&result)) {
+      fprintf(stderr, "acquisition: bloco %u não entregue uma vez com a soma dele\n", block);
+      exit(1);
+    }
+
+    // Divisor de 470 ohms pela média do bloco, contra o float
+    double code = level;
+    double expected = 470.0 * code / (ADC_RESOLUTION - code);
+    double ohms = resistance_to_ohms(measurement_resistance(RESISTANCE_OHMS(470),
+                                                            measurement_average(result.sum, result.count)));
+    if (fabs(ohms - expected) > expected * 1e-4) {
+      fprintf(stderr, "acquisition: código %u => %.3f ohms (esperado %.3f)\n", level, ohms, expected);
+      exit(1);
+    }
+  }
+
+  // Leitor atrasado: os resumos que sobram são os mais recentes, em sequência
+  for (uint16_t block = 0; block < 40; ++block)
+    handoff_block(2000 + block);
+  uint32_t kept = 0, last = 0;
+  while (acquisition_poll(&result)) {
+    uint32_t level = result.sum / ACQUISITION_BLOCK_LEN;
+    if (kept && level != last + 1) {
+      fprintf(stderr, "acquisition: resumo %u depois de %u com o leitor atrasado\n", level, last);
+      exit(1);
+    }
+    last = level;
+    kept++;
+  }
+  if (last != 2039 || kept < ACQUISITION_BLOCK_COUNT || kept >= 40) {
+    fprintf(stderr, "acquisition: %u resumos guardados, o último %u\n", kept, last);
+    exit(1);
+  }
+
+  // O bloco em andamento no flush é descartado; o seguinte chega
+  handoff_block(3000);
+  acquisition_flush();
+  handoff_block(3001);
+  bool dropped = !acquisition_poll(&result);
+  handoff_block(3002);
+  if (!dropped || !acquisition_poll(&result) || result.sum != 3002u * ACQUISITION_BLOCK_LEN) {
+    fprintf(stderr, "acquisition: flush não descartou só o bloco em andamento\n");
+    exit(1);
+  }
+
+  config.on_block = NULL;
+  acquisition_init(&config);
+  acquisition_start();
+}
+
+static void bench_acquisition(void) {
+  adc_model_block(2000.0, bench_adc_samples, ACQUISITION_BLOCK_LEN);
+
+  acquisition_set_correction(NULL);
+  bench_run("acquisition.block.raw", bench_acquisition_block, 200000);
+  acquisition_set_correction(calibration_lut);
+  bench_run("acquisition.block.corrected", bench_acquisition_block, 200000);
+  acquisition_set_correction(NULL);
+}
+
+// -----------------------------------------------------------------------------
+// Modo ratiométrico: divisor de 470 ohms e 1k alimentado por um trilho que cai
+// até 3% durante uma medição (display e matriz), com ondulação de 100 Hz e
+// ruído. O erro do modo simples não cai com mais amostras; o do ratiométrico,
+// com o topo do divisor amostrado por um divisor 1:2, cai.
+// -----------------------------------------------------------------------------
+
+#define RAIL_DROOP_MAX 0.03
+#define RAIL_RIPPLE 0.005
+#define RAIL_NOISE 0.005
+#define RAIL_TRIALS 200
+
+static const uint32_t rail_sample_counts[] = {100, 200, 500, 1000};
+
+typedef struct {
+  double droop;
+  double phase;
+  uint32_t lcg;
+  uint64_t sample;
+} rail_model_t;
+
+static double rail_uniform(rail_model_t *rail, double amplitude) {
+  rail->lcg = rail->lcg * 1664525u + 1013904223u;
+  return (double)(rail->lcg >> 8) / 16777216.0 * (2.0 * amplitude) - amplitude;
+}
+
+// Código da próxima amostra (10 kHz) com a entrada em `fraction` do trilho
+static uint16_t rail_sample(rail_model_t *rail, double fraction) {
+  double t = rail->sample++ * 1e-4;
+  double supply = 1.0 - rail->droop + RAIL_RIPPLE * sin(2.0 * M_PI * 100.0 * t + rail->phase) +
+                  rail_uniform(rail, RAIL_NOISE);
+  double code = floor(ADC_RESOLUTION * supply * fraction + rail_uniform(rail, 2.0) + 0.5);
+  return code < 0 ? 0 : code > ADC_RESOLUTION ? ADC_RESOLUTION : (uint16_t)code;
+}
+
+// Média do nó em `count` amostras dele, pela aquisição, no modo configurado
+static double rail_measure(rail_model_t *rail, bool ratiometric, double ratio, uint32_t count) {
+  uint16_t samples[ACQUISITION_BLOCK_LEN];
+  uint64_t sum = 0, seen = 0;
+
+  acquisition_start();
+  while (seen < count) {
+    for (size_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i)
+      samples[i] = rail_sample(rail, ratiometric && (i & 1) ? 0.5 : ratio);
+    bench_adc_block_cb(samples, ACQUISITION_BLOCK_LEN);
+    calibration_capture();
+    sum += calibration_result.sum;
+    seen += calibration_result.count;
+  }
+  return (double)sum / seen;
+}
+
+static void rail_configure(bool ratiometric) {
+  acquisition_config_t config = {
+    .input = 2,
+    .sample_rate_hz = 10000,
+    .ratiometric = ratiometric,
+    .reference_input = 1,
+    .reference_gain_q16 = 2u << 16,
+  };
+  acquisition_init(&config);
+}
+
+// Erro RMS (em LSB) da média em RAIL_TRIALS medições de `count` amostras
+static double rail_error(bool ratiometric, uint32_t count) {
+  const double ratio = 1000.0 / 1470.0;
+  rail_model_t rail = {.lcg = 11};
+  double squares = 0.0;
+
+  rail_configure(ratiometric);
+  for (int trial = 0; trial < RAIL_TRIALS; ++trial) {
+    rail.droop = (double)trial / (RAIL_TRIALS - 1) * RAIL_DROOP_MAX;
+    rail.phase = rail_uniform(&rail, M_PI);
+    double error = rail_measure(&rail, ratiometric, ratio, count) - ADC_RESOLUTION * ratio;
+    squares += error * error;
+  }
+  return sqrt(squares / RAIL_TRIALS);
+}
+
+static void check_ratiometric(void) {
+  double previous = INFINITY;
+
+  for (size_t i = 0; i < sizeof(rail_sample_counts) / sizeof(rail_sample_counts[0]); ++i) {
+    uint32_t count = rail_sample_counts[i];
+    double single = rail_error(false, count);
+    double ratio = rail_error(true, count);
+
+    // Erro relativo de R_x = R_ref * a / (4095 - a): da / (a * (1 - a / 4095))
+    double code = ADC_RESOLUTION * 1000.0 / 1470.0;
+    double scale = 100.0 / (code * (1.0 - code / ADC_RESOLUTION));
+    printf("# ratiometric.%u: erro rms %.2f LSB (%.2f%%) simples, %.2f LSB (%.3f%%) ratiométrico\n",
+           count, single, single * scale, ratio, ratio * scale);
+
+    // A queda do trilho sai da razão e sobra o ruído, que a média reduz
+    if (ratio > single / 10.0 || ratio >= previous) {
+      fprintf(stderr, "ratiometric.%u: erro %.2f LSB acima do esperado (simples %.2f LSB)\n", count, ratio, single);
+      exit(1);
+    }
+    previous = ratio;
+  }
+
+  // Trilho ideal, sem ruído: a razão devolve o código exato do divisor
+  rail_configure(true);
+  uint16_t samples[ACQUISITION_BLOCK_LEN];
+  for (size_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i)
+    samples[i] = i & 1 ? 2000 : 3000;
+  acquisition_start();
+  bench_adc_block_cb(samples, ACQUISITION_BLOCK_LEN);
+  calibration_capture();
+  if (calibration_result.count != ACQUISITION_BLOCK_LEN / 2 ||
+      calibration_result.sum != (uint32_t)(ACQUISITION_BLOCK_LEN / 2 * 3071.25 + 0.5)) {
+    fprintf(stderr, "ratiometric: bloco ideal com soma %u em %u amostras\n",
+            calibration_result.sum, calibration_result.count);
+    exit(1);
+  }
+
+  rail_configure(false);
+}
+
+static void bench_ratiometric(void) {
+  for (size_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i)
+    bench_adc_samples[i] = i & 1 ? 2030 : 2790;
+
+  rail_configure(true);
+  acquisition_start();
+  acquisition_set_correction(NULL);
+  bench_run("acquisition.block.ratiometric", bench_acquisition_block, 200000);
+  acquisition_set_correction(calibration_lut);
+  bench_run("acquisition.block.ratiometric.corrected", bench_acquisition_block, 200000);
+  acquisition_set_correction(NULL);
+  rail_configure(false);
+  acquisition_start();
+}
+
+// -----------------------------------------------------------------------------
+// Filtro da rede: zumbido sintético de 20 LSB com terceira harmônica de 7 LSB,
+// na frequência nominal e 1% acima e abaixo, comparado com os blocos sem filtro
+// -----------------------------------------------------------------------------
+
+#define HUM_AMPLITUDE 20.0
+#define HUM_THIRD 7.0
+#define HUM_BLOCKS 120
+
+static void mains_configure(uint16_t mains_hz, uint32_t sample_rate_hz) {
+  acquisition_config_t config = {.input = 2, .sample_rate_hz = sample_rate_hz, .mains_hz = mains_hz};
+  if (!acquisition_init(&config)) {
+    fprintf(stderr, "mains: sem janela de ciclos de %u Hz a %u Hz\n", mains_hz, sample_rate_hz);
+    exit(1);
+  }
+  acquisition_start();
+}
+
+// Desvio RMS (em LSB) das médias publicadas em relação ao nível sem zumbido
+static double hum_residual(uint16_t mains_hz, uint32_t sample_rate_hz, double hum_hz) {
+  const double level = 2000.0;
+  uint16_t samples[ACQUISITION_BLOCK_LEN];
+  double squares = 0.0;
+  uint32_t windows = 0;
+
+  mains_configure(mains_hz, sample_rate_hz);
+  for (uint32_t block = 0; block < HUM_BLOCKS; ++block) {
+    for (size_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i) {
+      double t = (double)(block * ACQUISITION_BLOCK_LEN + i) / sample_rate_hz;
+      double code = level + HUM_AMPLITUDE * sin(2.0 * M_PI * hum_hz * t + 0.3) +
+                    HUM_THIRD * sin(2.0 * M_PI * 3.0 * hum_hz * t + 1.1);
+      samples[i] = (uint16_t)floor(code + 0.5);
+    }
+    bench_adc_block_cb(samples, ACQUISITION_BLOCK_LEN);
+    while (acquisition_poll(&calibration_result)) {
+      double error = (double)calibration_result.sum / calibration_result.count - level;
+      squares += error * error;
+      windows++;
+    }
+  }
+  // Sem zumbido residual algum, limita a atenuação a 120 dB
+  return fmax(sqrt(squares / windows), HUM_AMPLITUDE * 1e-6);
+}
+
+static void check_mains_window(uint32_t mains_hz, uint32_t sample_rate_hz, uint8_t expected) {
+  uint8_t blocks = mains_filter_window_blocks(mains_hz, sample_rate_hz, ACQUISITION_BLOCK_LEN);
+  if (blocks != expected) {
+    fprintf(stderr, "mains: janela de %u blocos para %u Hz a %u Hz (esperado %u)\n",
+            blocks, mains_hz, sample_rate_hz, expected);
+    exit(1);
+  }
+}
+
+static void check_mains(void) {
+  check_mains_window(0, 10000, 1);
+  check_mains_window(50, 10000, 2);
+  check_mains_window(60, 12000, 2);
+  check_mains_window(60, 10000, 5);
+  check_mains_window(60, 36000, 6); // Multicanal
+  check_mains_window(50, 12000, 0); // 12 blocos
+
+  static const uint16_t mains[] = {50, 60};
+  for (size_t i = 0; i < 2; ++i) {
+    uint32_t rate = 200u * mains[i];
+    double attenuation[3];
+
+    for (int k = 0; k < 3; ++k) {
+      double hum_hz = mains[i] * (0.99 + 0.01 * k);
+      attenuation[k] = 20.0 * log10(hum_residual(0, rate, hum_hz) / hum_residual(mains[i], rate, hum_hz));
+    }
+    printf("# mains.%u: atenuação do zumbido em relação aos blocos de %u amostras: %.1f dB em %.1f Hz, "
+           "%.1f dB em %u Hz, %.1f dB em %.1f Hz\n",
+           mains[i], ACQUISITION_BLOCK_LEN, attenuation[0], mains[i] * 0.99, attenuation[1], mains[i],
+           attenuation[2], mains[i] * 1.01);
+
+    if (attenuation[1] < 40.0 || attenuation[0] < 25.0 || attenuation[2] < 25.0) {
+      fprintf(stderr, "mains.%u: atenuação abaixo do esperado\n", mains[i]);
+      exit(1);
+    }
+  }
+
+  // 60 Hz a 10 kHz: janelas de 3 ciclos (5 blocos)
+  double attenuation = 20.0 * log10(hum_residual(0, 10000, 60.0) / hum_residual(60, 10000, 60.0));
+  printf("# mains.60.10k: atenuação %.1f dB com janelas de 5 blocos\n", attenuation);
+  if (attenuation < 40.0) {
+    fprintf(stderr, "mains.60.10k: atenuação abaixo do esperado\n");
+    exit(1);
+  }
+}
+
+static void bench_mains(void) {
+  adc_model_block(2000.0, bench_adc_samples, ACQUISITION_BLOCK_LEN);
+  mains_configure(60, 12000);
+  bench_run("acquisition.block.mains", bench_acquisition_block, 200000);
+  rail_configure(false);
+  acquisition_start();
+}
+
+// -----------------------------------------------------------------------------
+// Telemetria: COBS, ida e volta pelo anel e pelos pacotes USB, perda de
+// registros com a USB parada e ressincronização após lixo no fluxo
+// -----------------------------------------------------------------------------
+
+static void check_cobs(void) {
+  static uint8_t src[600], encoded[610], decoded[610];
+  uint32_t lcg = 3;
+
+  for (size_t len = 1; len <= sizeof(src); ++len) {
+    for (size_t i = 0; i < len; ++i) {
+      lcg = lcg * 1664525u + 1013904223u;
+      // Densidade de zeros variando com o tamanho, inclusive sem nenhum
+      src[i] = (lcg >> 24) % (len % 7 + 1) ? (uint8_t)(lcg >> 16) | 1 : 0;
+    }
+
+    size_t encoded_len = cobs_encode(src, len, encoded);
+    size_t decoded_len = cobs_decode(encoded, encoded_len, decoded);
+    if (memchr(encoded, 0, encoded_len) || decoded_len != len || memcmp(src, decoded, len) != 0) {
+      fprintf(stderr, "cobs: ida e volta falhou com %zu bytes\n", len);
+      exit(1);
+    }
+  }
+}
+
+static measurement_record_t telemetry_record(uint32_t i) {
+  measurement_record_t record = {
+    .timestamp_ms = 1000 + i * 3,
+    .average_adc = ADC_MEAN((i * 37 % 65520) / 16.0),
+    .adc_variance = i * 101,
+    .sample_count = 300 + i % 700,
+    .range = i % 5,
+    .resistance = i % 50 == 7 ? RESISTANCE_INVALID : RESISTANCE_OHMS(i * 13 % 100000),
+    .closest_e24 = {(uint16_t)(100 + i % 900), (int8_t)(i % 13 - 3)},
+  };
+  return record;
+}
+
+// Separa o fluxo nos delimitadores e confere cada registro com o que foi
+// enviado (pela sequência). Retorna os quadros válidos.
+static uint32_t telemetry_decode_stream(uint32_t *invalid, uint32_t *lost) {
+  telemetry_sample_t sample;
+  uint32_t valid = 0;
+  size_t start = 0;
+  bool has_previous = false;
+  uint16_t previous = 0;
+
+  *invalid = *lost = 0;
+  for (size_t i = 0; i < bench_usb_len; ++i) {
+    if (bench_usb[i] != 0) continue;
+    size_t len = i - start;
+
+    if (len && telemetry_decode_frame(bench_usb + start, len, &sample)) {
+      measurement_record_t record = telemetry_record(sample.sequence);
+      uint64_t resistance = record.resistance == RESISTANCE_INVALID
+                              ? UINT64_MAX : (uint64_t)llround(resistance_to_ohms(record.resistance) * 1000.0);
+      if (sample.type != TELEMETRY_RECORD_MEASUREMENT || sample.timestamp_ms != record.timestamp_ms ||
+          sample.range != record.range ||
+          sample.adc_mean_q16 != (uint32_t)llround(adc_mean_to_float(record.average_adc) * 65536.0) ||
+          sample.adc_variance != record.adc_variance || sample.sample_count != record.sample_count ||
+          sample.resistance_milliohms != resistance || sample.series != ESERIES_E24 ||
+          sample.closest.mantissa != record.closest_e24.mantissa ||
+          sample.closest.exponent != record.closest_e24.exponent) {
+        fprintf(stderr, "telemetria: registro %u não confere\n", sample.sequence);
+        exit(1);
+      }
+
+      if (has_previous) *lost += (uint16_t)(sample.sequence - previous - 1);
+      previous = sample.sequence;
+      has_previous = true;
+      valid++;
+    } else if (len) {
+      (*invalid)++;
+    }
+    start = i + 1;
+  }
+  return valid;
+}
+
+// Envia `count` registros a partir de `first`, com a USB aceitando até
+// `limit` bytes por chamada, e esvazia o buffer no fim
+static void telemetry_stream(uint32_t first, uint32_t count, size_t limit) {
+  bench_usb_limit = limit;
+  for (uint32_t i = first; i < first + count; ++i) {
+    measurement_record_t record = telemetry_record(i);
+    telemetry_push(&record);
+    bench_clock_us += 2000;
+    telemetry_flush();
+  }
+
+  bench_usb_limit = BENCH_USB_CAPACITY;
+  for (int i = 0; i < 64; ++i) {
+    bench_clock_us += TELEMETRY_MAX_LATENCY_US;
+    telemetry_flush();
+  }
+}
+
+static void check_telemetry(void) {
+  uint32_t invalid, lost;
+  check_cobs();
+
+  // USB lenta, mas sem perdas: todos os registros chegam, em pacotes inteiros
+  telemetry_init();
+  bench_usb_len = 0;
+  telemetry_stream(0, 1000, 50);
+  uint32_t valid = telemetry_decode_stream(&invalid, &lost);
+  if (valid != 1000 || invalid || lost || telemetry_dropped()) {
+    fprintf(stderr, "telemetria: %u válidos, %u inválidos, %u perdidos\n", valid, invalid, lost);
+    exit(1);
+  }
+
+  // USB parada: o anel e o buffer de transmissão guardam os mais antigos
+  // que couberem, o resto é descartado e aparece como lacuna na sequência
+  telemetry_init();
+  bench_usb_len = 0;
+  telemetry_stream(0, 200, 0);
+  uint32_t kept = telemetry_decode_stream(&invalid, &lost);
+  if (kept + telemetry_dropped() != 200 || lost != telemetry_dropped() || invalid) {
+    fprintf(stderr, "telemetria: USB parada, %u recebidos, %u descartados, %u perdidos\n",
+            kept, telemetry_dropped(), lost);
+    exit(1);
+  }
+
+  // Texto do stdio no meio do fluxo e um byte corrompido: só os quadros
+  // atingidos se perdem
+  telemetry_init();
+  bench_usb_len = 0;
+  telemetry_stream(0, 10, BENCH_USB_CAPACITY);
+  const char *text = "sched nucleo0 ...\n";
+  memcpy(bench_usb + bench_usb_len, text, strlen(text));
+  bench_usb_len += strlen(text);
+  size_t corrupt_at = bench_usb_len;
+  telemetry_stream(10, 10, BENCH_USB_CAPACITY);
+  // O texto se junta ao quadro seguinte (registro 10); o byte corrompido fica
+  // no registro 15
+  for (int delimiters = 0; delimiters < 5; ++corrupt_at)
+    if (bench_usb[corrupt_at] == 0) delimiters++;
+  bench_usb[corrupt_at + 5] ^= 0x40;
+  valid = telemetry_decode_stream(&invalid, &lost);
+  if (valid != 18 || invalid != 2 || lost != 2) {
+    fprintf(stderr, "telemetria: ressincronização, %u válidos, %u inválidos, %u perdidos\n", valid, invalid, lost);
+    exit(1);
+  }
+
+  printf("# telemetry: %d bytes por registro; USB parada: %u de 200 registros guardados\n",
+         TELEMETRY_FRAME_MAX, kept);
+}
+
+static uint32_t bench_telemetry_index;
+
+static void bench_telemetry_record(void) {
+  measurement_record_t record = telemetry_record(bench_telemetry_index++);
+  telemetry_push(&record);
+  telemetry_flush();
+  if (bench_usb_len > BENCH_USB_CAPACITY / 2) bench_usb_len = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Triagem: fluxos simulados de peças (desvios aleatórios em torno do alvo,
+// peças de outros valores misturadas, ponteiras abertas entre peças e
+// medições repetidas da mesma peça) conferidos contra uma classificação de
+// referência em double
+// -----------------------------------------------------------------------------
+
+#define SORTING_PART_INTERVAL_MS 700
+
+static uint32_t sorting_lcg = 777;
+
+static double sorting_random(void) {
+  sorting_lcg = sorting_lcg * 1664525u + 1013904223u;
+  return (sorting_lcg >> 8) / 16777216.0;
+}
+
+// Compartimento de referência; false perto de um limite (da tolerância ou
+// de uma classe do histograma), onde o arredondamento de cada versão pode
+// decidir para qualquer lado
+static bool ref_sorting_bin(double ohms, double target, double tolerance, sorting_bin_t *bin) {
+  double deviation = ohms / target - 1.0;
+  double closest = nearest_float(ESERIES_E24, (float)ohms);
+  double closest_deviation = ohms / closest - 1.0;
+  double steps = deviation * 1e6 / SORTING_HISTOGRAM_STEP_PPM;
+
+  if (fabs(fabs(deviation) - tolerance) < 1e-4 || fabs(fabs(closest_deviation) - tolerance) < 1e-4 ||
+      fabs(fabs(steps - trunc(steps)) - 0.5) < 1e-2)
+    return false;
+
+  if (fabs(deviation) <= tolerance) *bin = SORTING_IN_TOLERANCE;
+  else if (fabs(closest - target) > 1e-6 * target && fabs(closest_deviation) <= tolerance) *bin = SORTING_WRONG_VALUE;
+  else *bin = SORTING_OUT_OF_TOLERANCE;
+  return true;
+}
+
+static void check_sorting_stream(double target, uint32_t tolerance_ppm, uint32_t parts) {
+  static const double mixed[] = {0.91, 1.1, 2.0, 0.47};
+  double tolerance = tolerance_ppm / 1e6;
+  uint32_t expected[SORTING_BIN_COUNT] = {0}, histogram[SORTING_HISTOGRAM_BINS] = {0};
+  sorting_t sorting;
+  uint32_t t_ms = 0;
+
+  sorting_init(&sorting, tolerance_ppm);
+
+  for (uint32_t i = 0; i < parts; ++i) {
+    double ohms;
+    sorting_bin_t bin;
+
+    // A primeira peça é a referência; as demais desviam até 3x a tolerância
+    // ou são de outro valor
+    do {
+      if (i == 0) ohms = target * 1.003;
+      else if (sorting_random() < 0.1) ohms = target * mixed[i % 4] * (1.0 + (sorting_random() - 0.5) * tolerance);
+      else ohms = target * (1.0 + (sorting_random() * 2.0 - 1.0) * 3.0 * tolerance);
+      ohms = resistance_to_ohms(RESISTANCE_OHMS(ohms)); // Resolução de cada versão
+    } while (!ref_sorting_bin(ohms, target, tolerance, &bin));
+
+    expected[bin]++;
+    int step = (int)lround((ohms / target - 1.0) * 1e6 / SORTING_HISTOGRAM_STEP_PPM);
+    if (step < -SORTING_HISTOGRAM_BINS / 2) step = -SORTING_HISTOGRAM_BINS / 2;
+    if (step > SORTING_HISTOGRAM_BINS / 2) step = SORTING_HISTOGRAM_BINS / 2;
+    histogram[step + SORTING_HISTOGRAM_BINS / 2]++;
+
+    // Até três medições com a peça nas ponteiras; só a primeira conta
+    uint32_t readings = 1 + i % 3;
+    for (uint32_t r = 0; r < readings; ++r) {
+      bool counted = sorting_feed(&sorting, RESISTANCE_OHMS(ohms), t_ms + r * 120);
+      if (counted != (r == 0) || (counted && sorting.last.bin != bin)) {
+        fprintf(stderr, "sorting: peça %u (%.2f ohms) esperada no compartimento %d, obtido %d\n",
+                i, ohms, bin, counted ? (int)sorting.last.bin : -1);
+        exit(1);
+      }
+    }
+    sorting_feed(&sorting, RESISTANCE_INVALID, t_ms + 500);
+    t_ms += SORTING_PART_INTERVAL_MS;
+  }
+
+  if (nearest_float(ESERIES_E24, eseries_to_float(sorting.target)) != nearest_float(ESERIES_E24, (float)target) ||
+      memcmp(expected, sorting.bins, sizeof(expected)) != 0 ||
+      memcmp(histogram, sorting.histogram, sizeof(histogram)) != 0) {
+    fprintf(stderr, "sorting.%.0f: contagens ou histograma não conferem\n", target);
+    exit(1);
+  }
+
+  uint32_t rate = sorting_parts_per_minute(&sorting);
+  if (rate != (60000 + SORTING_PART_INTERVAL_MS / 2) / SORTING_PART_INTERVAL_MS) {
+    fprintf(stderr, "sorting.%.0f: %u peças/min\n", target, rate);
+    exit(1);
+  }
+
+  printf("# sorting.%.0f.%u%%: dentro %u, fora %u, errado %u, %u peças/min\n", target, tolerance_ppm / 10000,
+         sorting.bins[SORTING_IN_TOLERANCE], sorting.bins[SORTING_OUT_OF_TOLERANCE],
+         sorting.bins[SORTING_WRONG_VALUE], rate);
+}
+
+static void check_sorting(void) {
+  check_sorting_stream(4700.0, 50000, 2000);
+  check_sorting_stream(4700.0, 10000, 2000);
+  check_sorting_stream(10.0, 20000, 2000);
+  check_sorting_stream(1.0e6, 50000, 2000);
+}
+
+static sorting_t bench_sorter;
+static uint32_t bench_sorting_index;
+
+static void bench_sorting_feed(void) {
+  uint32_t i = bench_sorting_index++;
+  sorting_feed(&bench_sorter, RESISTANCE_OHMS(4700.0f * (0.9f + (i % 64) / 320.0f)), i * 700);
+  sorting_feed(&bench_sorter, RESISTANCE_INVALID, i * 700 + 500);
+}
+
+// -----------------------------------------------------------------------------
+// Detector das ponteiras: sequência de médias de bloco com partida aberta,
+// inserção com contato oscilando, curto, troca de faixa e retirada
+// -----------------------------------------------------------------------------
+
+static const probe_config_t bench_probe_config = {
+  .open_code = ADC_MEAN(ADC_RESOLUTION - 2),
+  .short_code = ADC_MEAN(2),
+  .settle_codes = ADC_MEAN(4),
+  .settle_blocks = 2,
+};
+
+static void check_probe(void) {
+  static const struct {
+    float mean;
+    probe_event_t event;
+    probe_state_t state;
+  } steps[] = {
+    {4094.6f, PROBE_EVENT_REMOVED , PROBE_OPEN    }, // Partida com as ponteiras abertas
+    {4095.0f, PROBE_EVENT_NONE    , PROBE_OPEN    },
+    {3100.0f, PROBE_EVENT_INSERTED, PROBE_SETTLING}, // Bloco misturado
+    {2000.0f, PROBE_EVENT_NONE    , PROBE_SETTLING},
+    {2090.0f, PROBE_EVENT_NONE    , PROBE_SETTLING}, // Contato oscilando
+    {4095.0f, PROBE_EVENT_REMOVED , PROBE_OPEN    },
+    {2050.0f, PROBE_EVENT_INSERTED, PROBE_SETTLING},
+    {2052.5f, PROBE_EVENT_SETTLED , PROBE_SETTLED },
+    {2300.0f, PROBE_EVENT_NONE    , PROBE_SETTLED }, // Variação fica para a estatística
+    {0.4f   , PROBE_EVENT_SHORTED , PROBE_SHORT   },
+    {0.0f   , PROBE_EVENT_NONE    , PROBE_SHORT   },
+    {4095.0f, PROBE_EVENT_REMOVED , PROBE_OPEN    },
+    {12.0f  , PROBE_EVENT_INSERTED, PROBE_SETTLING},
+    {12.5f  , PROBE_EVENT_SETTLED , PROBE_SETTLED },
+  };
+  probe_t probe;
+
+  probe_init(&probe, &bench_probe_config);
+  for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); ++i) {
+    probe_event_t event = probe_update(&probe, ADC_MEAN(steps[i].mean));
+    if (event != steps[i].event || probe.state != steps[i].state) {
+      fprintf(stderr, "probe: passo %zu (%.1f): evento %d estado %d, esperado %d %d\n", i, steps[i].mean,
+              event, probe.state, steps[i].event, steps[i].state);
+      exit(1);
+    }
+  }
+
+  // Troca de faixa com a peça presente: acomoda de novo, sem eventos de
+  // retirada, a partir do primeiro bloco da faixa nova
+  probe_restart(&probe);
+  if (probe_update(&probe, ADC_MEAN(3000)) != PROBE_EVENT_NONE ||
+      probe_update(&probe, ADC_MEAN(3001)) != PROBE_EVENT_SETTLED) {
+    fprintf(stderr, "probe: troca de faixa\n");
+    exit(1);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Multicanal: três divisores intercalados no round-robin a 36 kHz (janelas de
+// 6 blocos, 200 amostras de cada canal por ciclo de 60 Hz). Cada canal sai com
+// o seu nível, um degrau em um deles não passa para os outros, e as três peças
+// são medidas no tempo de uma.
+// -----------------------------------------------------------------------------
+
+#define MULTICHANNEL_RATE_HZ 36000
+#define MULTICHANNEL_WINDOWS 60 // 1 s
+
+static const reference_range_t bench_channel_references[3] = {
+  {16, RESISTANCE_OHMS(470)  , RESISTANCE_OHMS(0) , ADC_MEAN(0)},
+  {17, RESISTANCE_OHMS(4700) , RESISTANCE_OHMS(25), ADC_MEAN(0)},
+  {18, RESISTANCE_OHMS(47000), RESISTANCE_OHMS(0) , ADC_MEAN(0)},
+};
+
+static uint32_t multichannel_lcg = 99;
+static uint64_t multichannel_sample; // Posição no round-robin
+
+static void multichannel_configure(void) {
+  acquisition_config_t config = {.input = 0, .channels = 3, .sample_rate_hz = MULTICHANNEL_RATE_HZ, .mains_hz = 60};
+  if (!acquisition_init(&config)) {
+    fprintf(stderr, "multichannel: sem janela de ciclos de 60 Hz a %u Hz\n", MULTICHANNEL_RATE_HZ);
+    exit(1);
+  }
+  acquisition_start();
+  multichannel_sample = 0;
+}
+
+// Próximo bloco do round-robin, com cada canal em `codes[canal]` e ruído
+// uniforme de 2 LSB
+static void multichannel_block(const double codes[3], uint16_t *samples) {
+  for (size_t i = 0; i < ACQUISITION_BLOCK_LEN; ++i) {
+    multichannel_lcg = multichannel_lcg * 1664525u + 1013904223u;
+    double noise = (double)(multichannel_lcg >> 8) / 16777216.0 * 4.0 - 2.0;
+    double code = floor(codes[multichannel_sample++ % 3] + noise + 0.5);
+    samples[i] = code < 0 ? 0 : code > ADC_RESOLUTION ? ADC_RESOLUTION : (uint16_t)code;
+  }
+}
+
+// Uma janela completa; preenche `results` por canal e retorna quantos saíram
+static uint32_t multichannel_window(const double codes[3], acquisition_result_t results[3]) {
+  uint16_t samples[ACQUISITION_BLOCK_LEN];
+  acquisition_result_t result;
+  uint32_t published = 0;
+
+  for (uint32_t block = 0; block < 6; ++block) {
+    multichannel_block(codes, samples);
+    bench_adc_block_cb(samples, ACQUISITION_BLOCK_LEN);
+  }
+  while (acquisition_poll(&result)) {
+    if (result.channel >= 3) {
+      fprintf(stderr, "multichannel: resumo do canal %u\n", result.channel);
+      exit(1);
+    }
+    results[result.channel] = result;
+    published++;
+  }
+  return published;
+}
+
+// Código do divisor da referência do canal com `rx` embaixo (aberto em infinito)
+static double multichannel_code(const reference_range_t *reference, double rx) {
+  if (isinf(rx)) return ADC_RESOLUTION;
+  double top = resistance_to_ohms(reference->reference) + resistance_to_ohms(reference->series);
+  return ADC_RESOLUTION * rx / (top + rx);
+}
+
+static void check_multichannel(void) {
+  acquisition_result_t results[3];
+
+  // Degrau de 1500 LSB no canal 1, no fim de uma janela e no meio de outra
+  double codes[3] = {1000.0, 2000.0, 3000.0};
+  double leak = 0.0;
+  multichannel_configure();
+  for (int window = 0; window < 12; ++window) {
+    if (window == 4) codes[1] = 3500.0;
+    if (window == 8) codes[1] = 500.0;
+    if (multichannel_window(codes, results) != 3) {
+      fprintf(stderr, "multichannel: janela %d sem os três canais\n", window);
+      exit(1);
+    }
+    for (int channel = 0; channel < 3; ++channel) {
+      double mean = (double)results[channel].sum / results[channel].count;
+      if (results[channel].count != 200 || fabs(mean - codes[channel]) > 0.5) {
+        fprintf(stderr, "multichannel: canal %d com média %.2f em %u amostras (esperado %.0f)\n",
+                channel, mean, results[channel].count, codes[channel]);
+        exit(1);
+      }
+      if (channel != 1) leak = fmax(leak, fabs(mean - codes[channel]));
+    }
+  }
+  printf("# multichannel: desvio máximo dos canais 0 e 2 com degraus de 1500 LSB no canal 1: %.2f LSB\n", leak);
+
+  // Três peças inseridas ao mesmo tempo, com as ponteiras abertas antes
+  static const double parts[3] = {820.0, 6800.0, 33000.0};
+  const sample_stats_config_t stats_config = {
+    .estimator = SAMPLE_STATS_TRIMMED_MEAN,
+    .min_samples = 300,
+    .max_samples = 1000,
+    .relative_step = eseries_relative_step(ESERIES_E24),
+    .step_fraction = FRACTION(0.1),
+  };
+  multichannel_channel_t channels[3];
+  uint32_t first[3] = {0}, measured[3] = {0};
+
+  for (int channel = 0; channel < 3; ++channel)
+    multichannel_init(&channels[channel], channel, &bench_channel_references[channel], &bench_probe_config);
+
+  multichannel_configure();
+  for (uint32_t window = 0; window < 2 + MULTICHANNEL_WINDOWS; ++window) {
+    for (int channel = 0; channel < 3; ++channel)
+      codes[channel] = multichannel_code(&bench_channel_references[channel], window < 2 ? INFINITY : parts[channel]);
+    multichannel_window(codes, results);
+
+    for (int channel = 0; channel < 3; ++channel) {
+      multichannel_reading_t reading;
+      if (multichannel_update(&channels[channel], &results[channel], &stats_config, &reading) != MULTICHANNEL_MEASURED)
+        continue;
+
+      double ohms = resistance_to_ohms(reading.resistance);
+      if (fabs(ohms - parts[channel]) > parts[channel] * 0.002) {
+        fprintf(stderr, "multichannel: canal %d mediu %.1f ohms (esperado %.0f)\n", channel, ohms, parts[channel]);
+        exit(1);
+      }
+      if (!measured[channel]++) first[channel] = window - 1;
+    }
+  }
+
+  // Na janela da inserção o canal começa a acomodar; a medição sai 2 janelas
+  // (400 amostras) depois e se repete a cada 2
+  for (int channel = 0; channel < 3; ++channel) {
+    if (first[channel] != 3 || measured[channel] < (MULTICHANNEL_WINDOWS - 1) / 2) {
+      fprintf(stderr, "multichannel: canal %d com a primeira medição na janela %u e %u medições em 1 s\n",
+              channel, first[channel], measured[channel]);
+      exit(1);
+    }
+  }
+  printf("# multichannel: 3 peças medidas em %u janelas (%.1f ms) da inserção; %u medições/s (%u por canal)\n",
+         first[0], first[0] * 1000.0 / 60.0, measured[0] + measured[1] + measured[2], measured[0]);
+
+  rail_configure(false);
+  acquisition_start();
+}
+
+static void bench_multichannel(void) {
+  static const double codes[3] = {1000.0, 2000.0, 3000.0};
+
+  multichannel_configure();
+  multichannel_block(codes, bench_adc_samples);
+  acquisition_set_correction(NULL);
+  bench_run("acquisition.block.multichannel", bench_acquisition_block, 200000);
+  acquisition_set_correction(calibration_lut);
+  bench_run("acquisition.block.multichannel.corrected", bench_acquisition_block, 200000);
+  acquisition_set_correction(NULL);
+  rail_configure(false);
+  acquisition_start();
+}
+
+// -----------------------------------------------------------------------------
+// Texto do display: notação de engenharia em inteiros x printf com float, e o
+// alinhamento de ssd1306_draw_text contra ssd1306_draw_char
+// -----------------------------------------------------------------------------
+
+#define FORMAT_INPUTS 64
+
+static eseries_value_t format_values[FORMAT_INPUTS];
+static char format_text[16];
+
+// Referência: "%.3g" do valor escalado pelo prefixo, que já descarta os zeros
+// à direita da parte fracionária
+static void ref_format_engineering(char *text, size_t size, eseries_value_t value) {
+  static const char *prefixes[] = {"m", "", "k", "M", "G"};
+  double ohms = value.mantissa * pow(10.0, value.exponent);
+  int group = (int)floor((value.exponent + 2) / 3.0);
+  snprintf(text, size, "%.3g%s\x7f", ohms / pow(1000.0, group), prefixes[group + 1]);
+}
+
+static void check_format_series(eseries_t series) {
+  char expected[24];
+
+  // Décadas de 100 mΩ a 9,99 GΩ (todos os prefixos)
+  for (int8_t exponent = -3; exponent <= 7; ++exponent) {
+    for (float probe = 1.0f; probe < 10.0f; probe *= 1.002f) {
+      eseries_value_t value;
+      eseries_nearest(series, probe, &value);
+      value.exponent += exponent;
+
+      size_t length = measurement_format_engineering(format_text, sizeof(format_text), &value);
+      ref_format_engineering(expected, sizeof(expected), value);
+      if (strcmp(format_text, expected) != 0 || length != strlen(expected)) {
+        fprintf(stderr, "format: %u e%d => \"%s\" (esperado \"%s\")\n", value.mantissa, value.exponent,
+                format_text, expected);
+        exit(1);
+      }
+
+      // Sem espaço para o terminador: texto vazio
+      if (measurement_format_engineering(format_text, length, &value) != 0 || format_text[0] != '\0') {
+        fprintf(stderr, "format: %u e%d não truncou\n", value.mantissa, value.exponent);
+        exit(1);
+      }
+    }
+  }
+}
+
+// `visible` é o trecho de `text` que deve aparecer a partir da coluna `left`,
+// caractere a caractere (draw_string quebraria a linha antes da coluna 120)
+static void check_text_align(const char *text, int x, ssd1306_align_t align, const char *visible, int left) {
+  static uint8_t expected[sizeof(ssd.ram_buffer)];
+
+  ssd1306_fill(&ssd, false);
+  for (int i = 0; visible[i]; ++i)
+    ssd1306_draw_char(&ssd, visible[i], left + i * SSD1306_GLYPH_WIDTH, 20);
+  memcpy(expected, ssd.ram_buffer, sizeof(expected));
+
+  ssd1306_fill(&ssd, false);
+  ssd1306_draw_text(&ssd, text, x, 20, align);
+  if (memcmp(expected, ssd.ram_buffer, sizeof(expected)) != 0) {
+    fprintf(stderr, "text: \"%s\" alinhado em %d difere de draw_char em %d\n", text, x, left);
+    exit(1);
+  }
+}
+
+static void check_format(void) {
+  eseries_value_t value = {0, 0};
+  if (measurement_format_engineering(format_text, sizeof(format_text), &value) != 1 ||
+      strcmp(format_text, "-") != 0) {
+    fprintf(stderr, "format: valor fora da série\n");
+    exit(1);
+  }
+
+  check_format_series(ESERIES_E24);
+  check_format_series(ESERIES_E192);
+
+  if (ssd1306_text_width("4.7k\x7f") != 5 * SSD1306_GLYPH_WIDTH) {
+    fprintf(stderr, "text: largura\n");
+    exit(1);
+  }
+  check_text_align("470\x7f", 29, SSD1306_ALIGN_LEFT, "470\x7f", 29);
+  check_text_align("4.7k\x7f", 77, SSD1306_ALIGN_CENTER, "4.7k\x7f", 57);
+  check_text_align("1.2M\x7f", 77, SSD1306_ALIGN_CENTER, "1.2M\x7f", 57);
+  check_text_align("100\x7f", 128, SSD1306_ALIGN_RIGHT, "100\x7f", 96);
+
+  // Recorte: só os caracteres inteiros dentro do display
+  check_text_align("xab", 8, SSD1306_ALIGN_RIGHT, "b", 0);
+  check_text_align("abcd", 104, SSD1306_ALIGN_LEFT, "abc", 104);
+}
+
+static void bench_format_sprintf(void) {
+  static const char *prefixes[] = {"m", "", "k", "M", "G"};
+  for (int i = 0; i < FORMAT_INPUTS; ++i) {
+    eseries_value_t value = format_values[i];
+    int group = (int)floorf((value.exponent + 2) / 3.0f);
+    float ohms = eseries_to_float(value);
+    bench_sink = snprintf(format_text, sizeof(format_text), "%.3g%s\x7f", ohms / powf(1000.0f, group),
+                          prefixes[group + 1]);
+  }
+}
+
+static void bench_format_engineering(void) {
+  for (int i = 0; i < FORMAT_INPUTS; ++i)
+    bench_sink = measurement_format_engineering(format_text, sizeof(format_text), &format_values[i]);
+}
+
+static void bench_text_center(void) {
+  ssd1306_draw_text(&ssd, "4.7k\x7f", 77, 5, SSD1306_ALIGN_CENTER);
+}
+
+static void bench_format(void) {
+  // Valores da E24 espalhados por todas as décadas
+  for (int i = 0; i < FORMAT_INPUTS; ++i) {
+    eseries_nearest(ESERIES_E24, 1.0f + (i * 37 % 90) / 10.0f, &format_values[i]);
+    format_values[i].exponent += i % 11 - 3;
+  }
+
+  bench_run("format.sprintf", bench_format_sprintf, 20000);
+  bench_run("format.engineering", bench_format_engineering, 20000);
+  bench_run("text.draw.center", bench_text_center, 200000);
+}
+
+// -----------------------------------------------------------------------------
+// Registro na flash: várias voltas pelos setores com faltas de energia no meio
+// de gravações e apagamentos. Depois de cada partida, a leitura deve devolver,
+// em ordem, as últimas medições de páginas gravadas por completo, e a gravação
+// deve continuar de onde parou. A página interrompida se perde, exceto se a
+// falta vier depois dos bytes que ela altera (o fim da página fica em 0xFF).
+// Depois de uma volta sem faltas, o registro guarda ao menos todos os setores
+// menos um.
+// -----------------------------------------------------------------------------
+
+#define FLASH_LOG_CHECK_RECORDS 30000u
+#define FLASH_LOG_MIN_KEPT ((FLASH_LOG_SECTORS - 1) * FLASH_LOG_PAGES_PER_SECTOR * FLASH_LOG_PAGE_ENTRIES)
+
+static flash_log_t bench_log;
+// Medições de páginas gravadas por completo, em ordem
+static uint32_t flash_log_durable[FLASH_LOG_CHECK_RECORDS + FLASH_LOG_PAGES * FLASH_LOG_PAGE_ENTRIES + 1];
+static uint32_t flash_log_durable_count;
+
+static telemetry_sample_t flash_log_sample(uint32_t id) {
+  telemetry_sample_t sample = {
+    .type = TELEMETRY_RECORD_MEASUREMENT,
+    .range = id % 5,
+    .timestamp_ms = id,
+    .adc_mean_q16 = id * 2654435761u,
+    .sample_count = 300 + id % 70000,
+    .resistance_milliohms = (uint64_t)id * 1000003u,
+    .closest = {(uint16_t)(100 + id % 900), (int8_t)(id % 13 - 3)},
+    .series = ESERIES_E24,
+  };
+  return sample;
+}
+
+static void check_flash_log_contents(const char *when, uint32_t min_kept) {
+  flash_log_cursor_t cursor;
+  telemetry_sample_t sample;
+  uint32_t count = 0, first = 0;
+  uint16_t sequence = 0;
+
+  flash_log_cursor_init(&bench_log, &cursor);
+  while (flash_log_next(&bench_log, &cursor, &sample)) {
+    if (count == 0) {
+      // A primeira medição lida deve ser uma das guardadas
+      while (first < flash_log_durable_count && flash_log_durable[first] != sample.timestamp_ms) first++;
+    }
+    uint32_t index = first + count;
+    telemetry_sample_t expected = index < flash_log_durable_count ? flash_log_sample(flash_log_durable[index])
+                                                                  : flash_log_sample(UINT32_MAX);
+    uint16_t expected_count = expected.sample_count > UINT16_MAX ? UINT16_MAX : expected.sample_count;
+    if (sample.type != TELEMETRY_RECORD_LOG || sample.timestamp_ms != expected.timestamp_ms ||
+        sample.range != expected.range || sample.adc_mean_q16 != expected.adc_mean_q16 ||
+        sample.sample_count != expected_count || sample.adc_variance != 0 ||
+        sample.resistance_milliohms != expected.resistance_milliohms ||
+        sample.closest.mantissa != expected.closest.mantissa ||
+        sample.closest.exponent != expected.closest.exponent || sample.series != expected.series ||
+        (count && sample.sequence != (uint16_t)(sequence + 1))) {
+      fprintf(stderr, "flash_log (%s): medição %u lida fora de ordem ou alterada (id %u)\n", when, count,
+              sample.timestamp_ms);
+      exit(1);
+    }
+    sequence = sample.sequence;
+    count++;
+  }
+
+  if (first + count != flash_log_durable_count || count < min_kept) {
+    fprintf(stderr, "flash_log (%s): %u medições lidas a partir da %u, %u guardadas\n", when, count, first,
+            flash_log_durable_count);
+    exit(1);
+  }
+}
+
+// Medição mais recente na flash (UINT32_MAX com o registro vazio)
+static uint32_t flash_log_newest_id(void) {
+  flash_log_cursor_t cursor;
+  telemetry_sample_t sample;
+  uint32_t newest = UINT32_MAX;
+
+  flash_log_cursor_init(&bench_log, &cursor);
+  while (flash_log_next(&bench_log, &cursor, &sample)) newest = sample.timestamp_ms;
+  return newest;
+}
+
+static void check_flash_log(void) {
+  volatile uint32_t id = 0, power_cuts = 0, lcg = 7;
+
+  memset(bench_flash, 0xFF, sizeof(bench_flash));
+  calibration_t calibration;
+  calibration_identity(&calibration);
+  calibration_save(&calibration);
+
+  flash_log_mount(&bench_log);
+  flash_log_durable_count = 0;
+
+  while (id < FLASH_LOG_CHECK_RECORDS) {
+    // Próxima falta de energia depois de 0 a 49 operações na flash
+    lcg = lcg * 1664525u + 1013904223u;
+    bench_flash_cut = (int32_t)(lcg >> 8) % 50;
+    bench_flash_cut_bytes = (lcg >> 4) % HAL_FLASH_SECTOR_SIZE;
+
+    if (setjmp(bench_flash_power)) {
+      // Partida depois da falta: as medições da RAM se perdem
+      power_cuts++;
+      flash_log_mount(&bench_log);
+      if (flash_log_newest_id() == id - 1)
+        for (uint32_t i = FLASH_LOG_PAGE_ENTRIES; i > 0; --i)
+          flash_log_durable[flash_log_durable_count++] = id - i;
+      check_flash_log_contents("partida", 0);
+      continue;
+    }
+
+    while (id < FLASH_LOG_CHECK_RECORDS) {
+      telemetry_sample_t sample = flash_log_sample(id++);
+      if (!flash_log_append(&bench_log, &sample)) continue;
+
+      flash_log_commit(&bench_log);
+      for (uint32_t i = FLASH_LOG_PAGE_ENTRIES; i > 0; --i)
+        flash_log_durable[flash_log_durable_count++] = id - i;
+    }
+  }
+  bench_flash_cut = -1;
+
+  // Uma volta sem faltas; as medições da RAM aparecem depois das da flash
+  for (uint32_t i = 0; i <= FLASH_LOG_PAGES * FLASH_LOG_PAGE_ENTRIES; ++i) {
+    telemetry_sample_t sample = flash_log_sample(id);
+    if (flash_log_append(&bench_log, &sample)) flash_log_commit(&bench_log);
+    flash_log_durable[flash_log_durable_count++] = id++;
+  }
+  check_flash_log_contents("final", FLASH_LOG_MIN_KEPT);
+
+  calibration_t loaded;
+  if (power_cuts < 50 || !calibration_load(&loaded)) {
+    fprintf(stderr, "flash_log: %u faltas de energia, calibração %s\n", power_cuts,
+            calibration_load(&loaded) ? "preservada" : "perdida");
+    exit(1);
+  }
+}
+
+static uint32_t bench_log_id;
+
+static void bench_flash_log_append(void) {
+  telemetry_sample_t sample = flash_log_sample(bench_log_id++);
+  if (flash_log_append(&bench_log, &sample)) flash_log_commit(&bench_log);
+}
+
+static void bench_flash_log_export(void) {
+  flash_log_cursor_t cursor;
+  telemetry_sample_t sample;
+  flash_log_cursor_init(&bench_log, &cursor);
+  while (flash_log_next(&bench_log, &cursor, &sample)) bench_sink = sample.timestamp_ms;
+}
+
+// -----------------------------------------------------------------------------
+// Perfil: faixas do histograma, resumo contra o cálculo exato (o p99 pode
+// ficar até 25% acima) e as sondas sobre o relógio controlado
+// -----------------------------------------------------------------------------
+
+#define PROFILE_CHECK_SAMPLES 20000
+
+static uint32_t profile_values[PROFILE_CHECK_SAMPLES];
+
+static int compare_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void check_profile_bin(uint32_t value) {
+  uint32_t bin = profile_bin(value);
+  uint32_t upper = profile_bin_upper(bin);
+
+  if (bin >= PROFILE_BINS || value > upper || upper - value > value / 4 ||
+      (bin > 0 && value <= profile_bin_upper(bin - 1))) {
+    fprintf(stderr, "perfil: valor %u na faixa %u (limite %u)\n", value, bin, upper);
+    exit(1);
+  }
+}
+
+static void check_profile_summary(const char *name, size_t count) {
+  profile_histogram_t histogram;
+  profile_summary_t summary;
+  uint64_t sum = 0;
+
+  profile_histogram_reset(&histogram);
+  for (size_t i = 0; i < count; ++i) {
+    profile_histogram_add(&histogram, profile_values[i]);
+    sum += profile_values[i];
+  }
+  profile_histogram_summary(&histogram, &summary);
+
+  qsort(profile_values, count, sizeof(profile_values[0]), compare_u32);
+  uint32_t p99 = profile_values[count - count / 100 - 1];
+  uint32_t mean = (uint32_t)((sum + count / 2) / count);
+
+  if (summary.count != count || summary.min != profile_values[0] || summary.max != profile_values[count - 1] ||
+      summary.mean != mean || summary.p99 < p99 || summary.p99 - p99 > p99 / 4) {
+    fprintf(stderr, "perfil %s: n %u min %u max %u media %u p99 %u, esperado %zu %u %u %u %u\n", name,
+            summary.count, summary.min, summary.max, summary.mean, summary.p99,
+            count, profile_values[0], profile_values[count - 1], mean, p99);
+    exit(1);
+  }
+}
+
+static void check_profile_probe(profile_probe_id_t id, uint64_t start_us, uint32_t elapsed_us) {
+  profile_summary_t summary;
+
+  profile_reset();
+  bench_clock_us = start_us;
+  profile_stop(id); // Sem início: ignorado
+  profile_start(id);
+  bench_clock_us += elapsed_us;
+  profile_stop(id);
+  profile_stop(id);
+  profile_summary(id, &summary);
+
+  if (summary.count != 1 || summary.max != elapsed_us * HAL_CYCLES_PER_US) {
+    fprintf(stderr, "perfil %s: %u amostras, %u ciclos em %u us\n", profile_probes[id].name,
+            summary.count, summary.max, elapsed_us);
+    exit(1);
+  }
+}
+
+static void check_profile(void) {
+  uint32_t lcg = 99;
+
+  for (uint32_t value = 0; value < 100000; ++value)
+    check_profile_bin(value);
+  for (int bit = 3; bit < 32; ++bit) {
+    check_profile_bin((1u << bit) - 1);
+    check_profile_bin(1u << bit);
+    check_profile_bin((1u << bit) + 1);
+  }
+  check_profile_bin(UINT32_MAX);
+  if (profile_bin(UINT32_MAX) != PROFILE_BINS - 1 || profile_bin_upper(PROFILE_BINS - 1) != UINT32_MAX) {
+    fprintf(stderr, "perfil: última faixa\n");
+    exit(1);
+  }
+
+  // Tempo quase constante, com o ruído de poucos ciclos de uma IRQ
+  for (size_t i = 0; i < PROFILE_CHECK_SAMPLES; ++i) {
+    lcg = lcg * 1664525u + 1013904223u;
+    profile_values[i] = 1200 + (lcg >> 28);
+  }
+  check_profile_summary("constante", PROFILE_CHECK_SAMPLES);
+
+  // Cauda longa: 3% das execuções preemptadas por algo 10 a 100 vezes maior
+  for (size_t i = 0; i < PROFILE_CHECK_SAMPLES; ++i) {
+    lcg = lcg * 1664525u + 1013904223u;
+    uint32_t base = 500 + (lcg >> 20) % 300;
+    profile_values[i] = (lcg >> 8) % 100 < 3 ? base * (10 + (lcg >> 12) % 90) : base;
+  }
+  check_profile_summary("cauda", PROFILE_CHECK_SAMPLES);
+
+  // Poucas amostras: o p99 é o máximo
+  for (size_t i = 0; i < 50; ++i) {
+    lcg = lcg * 1664525u + 1013904223u;
+    profile_values[i] = lcg >> 4;
+  }
+  check_profile_summary("poucas", 50);
+  profile_values[0] = 0;
+  check_profile_summary("zero", 1);
+
+  // Sondas: ciclos com a volta do contador no meio e, nas que contam por
+  // hal_time_us, intervalos maiores que uma volta
+  check_profile_probe(PROFILE_ADC_BLOCK, 5, 10);
+  check_profile_probe(PROFILE_LEDS, (HAL_CYCLES_MASK + 1) / HAL_CYCLES_PER_US - 3, 40);
+  check_profile_probe(PROFILE_I2C, 1000000, 1800);
+  check_profile_probe(PROFILE_FLASH, UINT32_MAX - 10, 250000);
+  profile_reset();
+}
+
+static void bench_profile_probe(void) {
+  profile_start(PROFILE_ESERIES);
+  bench_clock_us++;
+  profile_stop(PROFILE_ESERIES);
+}
+
+static void bench_profile_summary(void) {
+  profile_summary_t summary;
+  profile_summary(PROFILE_ESERIES, &summary);
+  bench_sink = summary.p99;
+}
+
+static sample_stats_t bench_stats;
+
+static void bench_stats_block(void) {
+  if (bench_stats.blocks >= SAMPLE_STATS_MAX_BLOCKS) sample_stats_reset(&bench_stats);
+  sample_stats_add_block(&bench_stats, 200000 + bench_stats.blocks, ACQUISITION_BLOCK_LEN);
+  bench_sink = sample_stats_relative_ci(&bench_stats) < FRACTION(0.01);
+}
+
+int main(void) {
+  bench_load_baseline();
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, 1);
+
+  bench_run("raster.fill.pixel", bench_fill_pixel, 2000);
+  bench_run("raster.fill.page", bench_fill_page, 200000);
+  bench_run("raster.rect.pixel", bench_rect_pixel, 20000);
+  bench_run("raster.rect.page", bench_rect_page, 200000);
+  bench_run("raster.hline.pixel", bench_hline_pixel, 200000);
+  bench_run("raster.hline.page", bench_hline_page, 200000);
+  bench_run("raster.vline.pixel", bench_vline_pixel, 200000);
+  bench_run("raster.vline.page", bench_vline_page, 200000);
+  bench_run("raster.dline.pixel", bench_dline_pixel, 200000);
+  bench_run("raster.dline.page", bench_dline_page, 200000);
+  bench_run("raster.pixel.set", bench_pixel_set, 200000);
+  bench_run("raster.string.pixel", bench_string_pixel, 50000);
+  bench_run("raster.string.page", bench_string_page, 200000);
+
+  bench_run("frame.layout.draw", bench_layout_draw, 20000);
+  bench_run("frame.layout.compose", bench_layout_compose, 200000);
+  bench_run("frame.full", bench_frame_full, 50000);
+  check_display_retry();
+
+  npInit(LED_PIN);
+  check_matrix();
+  bench_run("leds.write", bench_leds_write, 200000);
+  bench_run("leds.write.unchanged", npWrite, 200000);
+
+  bench_queue_stress();
+
+  for (int i = 0; i < ESERIES_INPUTS; ++i)
+    eseries_inputs[i] = ref_resistance(470, i + 1);
+
+  check_eseries();
+  bench_run("eseries.e24.linear", bench_e24_linear, 20000);
+  bench_run("eseries.e24.lookup", bench_e24_lookup, 20000);
+  bench_run("eseries.e192.lookup", bench_e192_lookup, 20000);
+  bench_run("eseries.bands.e96", bench_bands_e96, 20000);
+
+  check_stats();
+  check_ranging();
+#ifdef OHMIMETRO_FIXED_POINT
+  check_pipeline();
+#endif
+  bench_pipeline();
+
+  check_calibration();
+  check_acquisition();
+  bench_acquisition();
+  check_ratiometric();
+  bench_ratiometric();
+  check_mains();
+  bench_mains();
+
+  check_telemetry();
+  telemetry_init();
+  bench_usb_limit = BENCH_USB_CAPACITY;
+  bench_run("telemetry.record", bench_telemetry_record, 200000);
+
+  check_format();
+  bench_format();
+
+  check_flash_log();
+  bench_run("flash_log.append", bench_flash_log_append, 200000);
+  bench_run("flash_log.export", bench_flash_log_export, 200);
+
+  check_profile();
+  bench_run("profile.probe", bench_profile_probe, 200000);
+  bench_run("profile.summary", bench_profile_summary, 200000);
+
+  check_probe();
+  check_multichannel();
+  bench_multichannel();
+  check_sorting();
+  sorting_init(&bench_sorter, 50000);
+  bench_run("sorting.part", bench_sorting_feed, 200000);
+  bench_run("stats.block", bench_stats_block, 200000);
+
+  bench_sink = ssd.ram_buffer[1];
+
+  if (bench_regressions) {
+    fprintf(stderr, "bench: %u casos acima de %.0f%% da referência\n", bench_regressions, bench_threshold);
+    return 2;
+  }
+  return 0;
+}
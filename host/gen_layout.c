@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include "../lib/hal.h"
+#include "../lib/ssd1306.h"
+#include "../lib/layout.h"
+
+// Renderiza os elementos estáticos da tela (lib/layout.c) e imprime o quadro
+// resultante como o cabeçalho lib/layout_bitmap.h:
+//
+//   ./ohmimetro_gen_layout > lib/layout_bitmap.h
+
+// Nada é enviado ao display durante a geração
+void hal_i2c_write(uint8_t port, uint8_t address, const uint8_t *src, size_t len) {
+  (void)port;
+  (void)address;
+  (void)src;
+  (void)len;
+}
+
+bool hal_i2c_write_async(uint8_t port, uint8_t address, const uint8_t *src, size_t len,
+                         hal_i2c_done_cb_t cb, void *ctx) {
+  (void)port;
+  (void)address;
+  (void)src;
+  (void)len;
+  if (cb) cb(ctx);
+  return true;
+}
+
+void hal_idle_wait(void) {
+}
+
+int main(void) {
+  ssd1306_t ssd;
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, 1);
+  ssd1306_fill(&ssd, false);
+  draw_display_layout(&ssd);
+  draw_static_labels(&ssd);
+
+  printf("// Gerado por host/gen_layout.c a partir de lib/layout.c. Não editar.\n");
+  printf("//\n");
+  printf("// Quadro estático %dx%d no formato do ram_buffer do SSD1306 (endereçamento\n", WIDTH, HEIGHT);
+  printf("// vertical: %d bytes de página por coluna), sem o byte de controle.\n", ssd.pages);
+  printf("static const uint8_t layout_background[%u] = {\n", (unsigned)(ssd.bufsize - 1));
+
+  for (uint8_t x = 0; x < ssd.width; ++x) {
+    printf("  ");
+    for (uint8_t p = 0; p < ssd.pages; ++p)
+      printf("0x%02X,%s", ssd.ram_buffer[x * ssd.pages + p + 1], p + 1 < ssd.pages ? " " : "");
+    printf(" // x = %u\n", x);
+  }
+
+  printf("};\n");
+  return 0;
+}
@@ -0,0 +1,958 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include "../lib/hal.h"
+
+// Placa virtual: backends simulados para rodar o pipeline do ohmímetro no
+// Linux. O tempo é virtual e avança apenas com esperas e com o tempo de
+// barramento estimado de cada transferência (I2C e PIO), de modo que a
+// latência observada aproxima a do RP2040 sem depender da CPU do host.
+//
+// Variáveis de ambiente:
+//   OHMIMETRO_SIM_SECONDS  duração virtual da simulação (padrão 10 s)
+//   OHMIMETRO_SIM_RX       resistor desconhecido do divisor, em ohms (1000)
+//   OHMIMETRO_SIM_RX_CHANNELS  resistor desconhecido de cada entrada do ADC
+//                          (0, 1 e 2), em ohms separados por vírgula; sem
+//                          ele, todas usam OHMIMETRO_SIM_RX
+//   OHMIMETRO_SIM_RREF     resistor de referência do divisor, em ohms (470),
+//                          usado quando o firmware não liga faixas ao divisor
+//   OHMIMETRO_SIM_PARTS    peças inseridas uma após a outra no lugar de R_x, em
+//                          ohms separados por vírgula (a lista se repete). A
+//                          entrada 2 recebe a peça da vez; as entradas 1 e 0,
+//                          as seguintes da lista (o gabarito multicanal)
+//   OHMIMETRO_SIM_PART_MS  tempo de cada peça nas ponteiras (500 ms), seguido
+//                          de 250 ms com as ponteiras abertas
+//   OHMIMETRO_SIM_HOLD     GPIO de um botão mantido pressionado na partida
+//                          (lido em nível baixo nos primeiros 500 ms); ao ser
+//                          solto, um repique gera uma borda de descida
+//   OHMIMETRO_SIM_NOISE    amplitude do ruído do ADC, em LSB (2)
+//   OHMIMETRO_SIM_RAIL_NOISE  amplitude do ruído do trilho de 3,3 V que
+//                          alimenta o divisor, em fração da tensão (0)
+//   OHMIMETRO_SIM_RAIL_DROOP  queda do trilho enquanto o display ou a matriz
+//                          recebem um quadro, em fração da tensão (0)
+//   OHMIMETRO_SIM_HUM      amplitude do zumbido da rede captado no nó do
+//                          divisor, em LSB (0)
+//   OHMIMETRO_SIM_HUM_HZ   frequência do zumbido (60 Hz)
+//   OHMIMETRO_SIM_CROSSTALK  fração da conversão anterior que fica no
+//                          capacitor de amostragem do ADC ao trocar de
+//                          entrada no round-robin (0)
+//   OHMIMETRO_SIM_OUT      diretório onde gravar cada quadro do display (PBM)
+//                          e da matriz de LEDs (PPM)
+//   OHMIMETRO_SIM_USB      arquivo que recebe os bytes da serial USB (sem ele,
+//                          a USB fica desconectada)
+//   OHMIMETRO_SIM_USB_CMD  texto enviado pelo PC pela serial USB, recebido
+//                          pelo firmware em OHMIMETRO_SIM_USB_CMD_MS (1000 ms)
+//   OHMIMETRO_SIM_FLASH    arquivo com o conteúdo dos setores reservados da
+//                          flash, lido no início e regravado a cada alteração
+
+#define SIM_OLED_WIDTH 128
+#define SIM_OLED_PAGES 8
+#define SIM_LED_COUNT 25
+#define SIM_LED_SCALE 8
+#define SIM_MAX_PARTS 64
+#define SIM_PART_GAP_US 250000
+#define SIM_HOLD_US 500000
+#define SIM_ADC_INPUTS 3 // Entradas externas (GPIO 26 a 28)
+#define SIM_FLASH_ERASE_US 45000 // Apagamento de um setor (típico da W25Q16)
+#define SIM_FLASH_PAGE_US 700    // Gravação de uma página
+
+// -----------------------------------------------------------------------------
+// Configuração e relatório
+// -----------------------------------------------------------------------------
+
+static uint64_t sim_limit_us = 10000000;
+static double sim_rx = 1000.0;
+static double sim_rx_channels[SIM_ADC_INPUTS]; // 0: usa sim_rx
+static double sim_rref = 470.0;
+static uint32_t sim_noise = 2;
+static double sim_rail_noise;
+static double sim_rail_droop;
+static double sim_hum;
+static double sim_hum_hz = 60.0;
+static double sim_crosstalk;
+static double sim_parts[SIM_MAX_PARTS];
+static size_t sim_part_count;
+static uint64_t sim_part_us = 500000;
+static int sim_hold_gpio = -1;
+static const char *sim_out_dir;
+static const char *sim_flash_path;
+static FILE *sim_usb_file;
+static const char *sim_usb_cmd;
+static uint64_t sim_usb_cmd_us = 1000000;
+static uint64_t stat_usb_bytes;
+
+static uint64_t sim_now_us;
+static struct timespec sim_wall_start;
+
+static uint64_t stat_i2c_transfers;
+static uint64_t stat_i2c_bytes;
+static uint64_t stat_oled_frames;
+static uint64_t stat_led_frames;
+static uint64_t stat_adc_blocks;
+static uint64_t stat_flash_erases;
+static uint64_t stat_flash_pages;
+
+// Latência da inserção de cada peça (OHMIMETRO_SIM_PARTS) até o primeiro
+// quadro OLED enviado com ela nas ponteiras
+static uint64_t stat_parts_shown;
+static uint64_t stat_part_latency_us;
+static uint64_t stat_part_latency_max_us;
+static uint64_t stat_open_oled_frames;
+static uint64_t sim_last_shown_part = UINT64_MAX;
+
+static double env_double(const char *name, double fallback) {
+  const char *value = getenv(name);
+  return value ? atof(value) : fallback;
+}
+
+static void sim_report(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  double wall_ms = (now.tv_sec - sim_wall_start.tv_sec) * 1e3 +
+                   (now.tv_nsec - sim_wall_start.tv_nsec) / 1e6;
+
+  fprintf(stderr,
+          "sim: %.3f s virtuais em %.1f ms de CPU do host\n"
+          "sim: %llu blocos ADC, %llu quadros OLED, %llu quadros LED\n"
+          "sim: %llu transferencias I2C, %llu bytes no barramento\n"
+          "sim: %llu bytes na serial USB\n",
+          sim_now_us / 1e6, wall_ms,
+          (unsigned long long)stat_adc_blocks,
+          (unsigned long long)stat_oled_frames,
+          (unsigned long long)stat_led_frames,
+          (unsigned long long)stat_i2c_transfers,
+          (unsigned long long)stat_i2c_bytes,
+          (unsigned long long)stat_usb_bytes);
+
+  if (stat_flash_erases || stat_flash_pages)
+    fprintf(stderr, "sim: %llu setores apagados e %llu paginas gravadas na flash\n",
+            (unsigned long long)stat_flash_erases, (unsigned long long)stat_flash_pages);
+
+  if (sim_part_count)
+    fprintf(stderr,
+            "sim: %llu pecas mostradas, latencia insercao => display media %.1f ms, max %.1f ms\n"
+            "sim: %llu quadros OLED com as ponteiras abertas\n",
+            (unsigned long long)stat_parts_shown,
+            stat_parts_shown ? stat_part_latency_us / 1e3 / stat_parts_shown : 0.0,
+            stat_part_latency_max_us / 1e3,
+            (unsigned long long)stat_open_oled_frames);
+}
+
+__attribute__((constructor)) static void sim_setup(void) {
+  sim_limit_us = (uint64_t)(env_double("OHMIMETRO_SIM_SECONDS", 10.0) * 1e6);
+  sim_rx = env_double("OHMIMETRO_SIM_RX", sim_rx);
+  sim_rref = env_double("OHMIMETRO_SIM_RREF", sim_rref);
+  sim_noise = (uint32_t)env_double("OHMIMETRO_SIM_NOISE", sim_noise);
+  sim_rail_noise = env_double("OHMIMETRO_SIM_RAIL_NOISE", sim_rail_noise);
+  sim_rail_droop = env_double("OHMIMETRO_SIM_RAIL_DROOP", sim_rail_droop);
+  sim_hum = env_double("OHMIMETRO_SIM_HUM", sim_hum);
+  sim_hum_hz = env_double("OHMIMETRO_SIM_HUM_HZ", sim_hum_hz);
+  sim_crosstalk = env_double("OHMIMETRO_SIM_CROSSTALK", sim_crosstalk);
+  sim_part_us = (uint64_t)(env_double("OHMIMETRO_SIM_PART_MS", sim_part_us / 1e3) * 1e3);
+  sim_hold_gpio = (int)env_double("OHMIMETRO_SIM_HOLD", sim_hold_gpio);
+
+  const char *parts = getenv("OHMIMETRO_SIM_PARTS");
+  while (parts && *parts && sim_part_count < SIM_MAX_PARTS) {
+    char *end;
+    sim_parts[sim_part_count++] = strtod(parts, &end);
+    parts = *end == ',' ? end + 1 : NULL;
+  }
+
+  const char *channels = getenv("OHMIMETRO_SIM_RX_CHANNELS");
+  for (uint8_t input = 0; channels && *channels && input < SIM_ADC_INPUTS; ++input) {
+    char *end;
+    sim_rx_channels[input] = strtod(channels, &end);
+    channels = *end == ',' ? end + 1 : NULL;
+  }
+
+  sim_out_dir = getenv("OHMIMETRO_SIM_OUT");
+  sim_flash_path = getenv("OHMIMETRO_SIM_FLASH");
+  const char *usb_path = getenv("OHMIMETRO_SIM_USB");
+  if (usb_path) sim_usb_file = fopen(usb_path, "wb");
+  sim_usb_cmd = getenv("OHMIMETRO_SIM_USB_CMD");
+  sim_usb_cmd_us = (uint64_t)(env_double("OHMIMETRO_SIM_USB_CMD_MS", sim_usb_cmd_us / 1e3) * 1e3);
+
+  clock_gettime(CLOCK_MONOTONIC, &sim_wall_start);
+  atexit(sim_report);
+}
+
+// -----------------------------------------------------------------------------
+// ADC + DMA
+// -----------------------------------------------------------------------------
+
+static uint8_t adc_input;
+static uint8_t adc_round_robin_mask;
+static uint8_t adc_next_input;
+static uint32_t adc_sample_rate_hz;
+static uint16_t *adc_ring;
+static size_t adc_block_len;
+static size_t adc_block_count;
+static size_t adc_block_index;
+static hal_adc_block_cb_t adc_block_cb;
+static hal_sim_adc_source_t adc_source;
+static bool adc_running;
+static uint64_t adc_stream_start_us;
+static uint64_t adc_samples; // Amostras entregues desde o início do stream
+
+// Resistores de referência ligados ao nó de cada divisor (um por entrada do
+// ADC) e estado de cada pino
+#define SIM_GPIO_COUNT 30
+#define SIM_DIVIDER_INPUT 2 // ADC_PIN 28, o divisor da placa
+
+typedef enum { SIM_PIN_FLOAT, SIM_PIN_LOW, SIM_PIN_HIGH } sim_pin_t;
+
+static double divider_ohms[SIM_ADC_INPUTS][SIM_GPIO_COUNT];
+static bool divider_attached[SIM_ADC_INPUTS];
+static sim_pin_t pin_state[SIM_GPIO_COUNT];
+
+// Entradas com um divisor ligado (ao menos uma, a da placa)
+static uint32_t divider_count(void) {
+  uint32_t count = 0;
+  for (uint8_t input = 0; input < SIM_ADC_INPUTS; ++input)
+    count += divider_attached[input];
+  return count ? count : 1;
+}
+
+// R_x da entrada no instante `t_us`: fixo ou a peça da vez (infinito entre
+// peças)
+static double divider_rx(uint8_t input, uint64_t t_us) {
+  if (!sim_part_count) return sim_rx_channels[input] > 0.0 ? sim_rx_channels[input] : sim_rx;
+
+  uint64_t period = sim_part_us + SIM_PART_GAP_US;
+  if (t_us % period >= sim_part_us) return INFINITY;
+  return sim_parts[(t_us / period * divider_count() + SIM_DIVIDER_INPUT - input) % sim_part_count];
+}
+
+// Quadro OLED concluído em `t_us`: o primeiro com a peça da vez nas ponteiras
+// mede a latência da inserção
+static void sim_part_frame(uint64_t t_us) {
+  if (!sim_part_count) return;
+
+  uint64_t period = sim_part_us + SIM_PART_GAP_US;
+  uint64_t part = t_us / period;
+  if (t_us % period >= sim_part_us) {
+    stat_open_oled_frames++;
+    return;
+  }
+  if (part == sim_last_shown_part) return;
+
+  // No multicanal, as peças de todas as entradas aparecem no mesmo quadro
+  uint64_t latency = t_us - part * period;
+  sim_last_shown_part = part;
+  stat_parts_shown += divider_count();
+  stat_part_latency_us += latency * divider_count();
+  if (latency > stat_part_latency_max_us) stat_part_latency_max_us = latency;
+}
+
+// Tensão do nó (em fração de 3,3 V) pelas condutâncias ligadas a 3,3 V e a
+// GND; R_x vai sempre a GND e pinos em alta impedância não contribuem
+static double divider_ratio(uint8_t input, uint64_t t_us) {
+  double rx = divider_rx(input, t_us);
+  double g_high = 0.0, g_total = 1.0 / rx;
+  bool attached = false;
+
+  for (uint gpio = 0; gpio < SIM_GPIO_COUNT; ++gpio) {
+    if (divider_ohms[input][gpio] <= 0.0) continue;
+    attached = true;
+    if (pin_state[gpio] == SIM_PIN_FLOAT) continue;
+
+    double g = 1.0 / divider_ohms[input][gpio];
+    g_total += g;
+    if (pin_state[gpio] == SIM_PIN_HIGH) g_high += g;
+  }
+
+  if (!attached) return isinf(rx) ? 1.0 : rx / (sim_rref + rx);
+  return g_high / g_total;
+}
+
+// Ruído uniforme determinístico em [-amplitude, amplitude]
+static double sim_uniform(uint32_t *lcg, double amplitude) {
+  *lcg = *lcg * 1664525u + 1013904223u;
+  return (double)(*lcg >> 16) / 65535.0 * (2.0 * amplitude) - amplitude;
+}
+
+static bool sim_rail_loaded(uint64_t t_us);
+
+// Trilho de 3,3 V do divisor em fração do fundo de escala do ADC, cuja
+// referência fica estável
+static double sim_rail(uint64_t t_us) {
+  static uint32_t lcg = 7;
+  double rail = 1.0;
+
+  if (sim_rail_droop > 0.0 && sim_rail_loaded(t_us)) rail -= sim_rail_droop;
+  if (sim_rail_noise > 0.0) rail += sim_uniform(&lcg, sim_rail_noise);
+  return rail;
+}
+
+// Divisor R_ref (em cima) / R_x (embaixo) na entrada do stream e nas que têm
+// divisor ligado; as outras entradas leem o trilho por um divisor 1:2. Ruído
+// do ADC uniforme e zumbido da rede só nos divisores (as ponteiras fazem de
+// antena).
+static uint16_t adc_source_divider(uint8_t input, uint64_t t_us) {
+  static uint32_t lcg = 1;
+  static double held;
+
+  bool divider = input < SIM_ADC_INPUTS && (input == adc_input || divider_attached[input]);
+  double rail = sim_rail(t_us);
+  double code = 4095.0 * rail * (divider ? divider_ratio(input, t_us) : 0.5);
+
+  if (sim_hum > 0.0 && divider) code += sim_hum * sin(2.0 * M_PI * sim_hum_hz * t_us * 1e-6);
+
+  // Carga da conversão anterior no capacitor de amostragem
+  code = (1.0 - sim_crosstalk) * code + sim_crosstalk * held;
+  held = code;
+
+  if (sim_noise) code += sim_uniform(&lcg, sim_noise);
+
+  if (code < 0) return 0;
+  return code > 4095 ? 4095 : (uint16_t)(code + 0.5);
+}
+
+// Instante da amostra `n` do stream; sem arredondar o período, para que a
+// taxa (e as janelas do filtro da rede) seja exata
+static uint64_t adc_sample_us(uint64_t n) {
+  return adc_stream_start_us + n * 1000000u / adc_sample_rate_hz;
+}
+
+static uint64_t adc_block_end_us(void) {
+  return adc_sample_us(adc_samples + adc_block_len);
+}
+
+// Entrega os blocos cujo último instante de amostragem já passou
+static void adc_deliver_until(uint64_t t_us) {
+  while (adc_running && adc_block_end_us() <= t_us) {
+    uint16_t *block = adc_ring + adc_block_index * adc_block_len;
+
+    for (size_t i = 0; i < adc_block_len; ++i) {
+      uint16_t code = adc_source(adc_next_input, adc_sample_us(adc_samples + i));
+      block[i] = code > 4095 ? 4095 : code;
+
+      // Round-robin: a próxima entrada da máscara acima da atual, com volta
+      for (uint8_t step = 1; adc_round_robin_mask && step <= 4; ++step) {
+        uint8_t input = (adc_next_input + step) % 4;
+        if (adc_round_robin_mask & (1u << input)) {
+          adc_next_input = input;
+          break;
+        }
+      }
+    }
+
+    adc_samples += adc_block_len;
+    adc_block_index = (adc_block_index + 1) % adc_block_count;
+    stat_adc_blocks++;
+    if (adc_block_cb) adc_block_cb(block, adc_block_len);
+  }
+}
+
+void hal_adc_stream_init(uint8_t input, uint32_t sample_rate_hz, uint16_t *ring,
+                         size_t block_len, size_t block_count, hal_adc_block_cb_t cb) {
+  adc_input = input;
+  adc_sample_rate_hz = sample_rate_hz;
+  adc_ring = ring;
+  adc_block_len = block_len;
+  adc_block_count = block_count;
+  adc_block_cb = cb;
+  if (!adc_source) adc_source = adc_source_divider;
+}
+
+void hal_adc_stream_start(void) {
+  adc_next_input = adc_input;
+  adc_block_index = 0;
+  adc_stream_start_us = sim_now_us;
+  adc_samples = 0;
+  adc_running = true;
+}
+
+void hal_adc_stream_stop(void) {
+  adc_running = false;
+}
+
+void hal_adc_stream_set_round_robin(uint8_t mask) {
+  adc_round_robin_mask = mask;
+}
+
+void hal_sim_adc_set_source(hal_sim_adc_source_t source) {
+  adc_source = source ? source : adc_source_divider;
+}
+
+// -----------------------------------------------------------------------------
+// Tempo
+// -----------------------------------------------------------------------------
+
+static void led_latch(void);
+static void i2c_complete_until(uint64_t t_us);
+
+// Quadro de LEDs em curso: os LEDs travam as cores ao fim do RESET
+static bool led_busy;
+static uint64_t led_start_us;
+static uint64_t led_done_us;
+
+// Última transação I2C, síncrona ou não: carga no trilho durante ela
+static uint64_t i2c_start_us;
+static uint64_t i2c_end_us;
+
+static void sim_advance(uint64_t us) {
+  uint64_t before_us = sim_now_us;
+  sim_now_us += us;
+
+  // O botão mantido na partida repica ao ser solto
+  if (sim_hold_gpio >= 0 && before_us < SIM_HOLD_US && sim_now_us >= SIM_HOLD_US)
+    hal_sim_gpio_press(sim_hold_gpio);
+
+  i2c_complete_until(sim_now_us);
+
+  if (led_busy && led_done_us <= sim_now_us) {
+    led_busy = false;
+    led_latch();
+  }
+
+  adc_deliver_until(sim_now_us);
+
+  if (sim_now_us >= sim_limit_us) exit(0);
+}
+
+void hal_sim_adc_pump(size_t blocks) {
+  while (adc_running && blocks--)
+    sim_advance(adc_block_end_us() - sim_now_us);
+}
+
+uint64_t hal_time_us(void) {
+  return sim_now_us;
+}
+
+uint32_t hal_time_ms(void) {
+  return (uint32_t)(sim_now_us / 1000);
+}
+
+// O tempo virtual só anda nas esperas e nos periféricos; o processamento
+// entra pelo tempo de CPU do host
+uint32_t hal_cycles(void) {
+  struct timespec cpu;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+  uint64_t cpu_ns = (uint64_t)cpu.tv_sec * 1000000000u + cpu.tv_nsec;
+  return (uint32_t)(sim_now_us * HAL_CYCLES_PER_US + cpu_ns * HAL_CYCLES_PER_US / 1000) & HAL_CYCLES_MASK;
+}
+
+void hal_sleep_us(uint64_t us) {
+  sim_advance(us);
+}
+
+void hal_sleep_ms(uint32_t ms) {
+  sim_advance((uint64_t)ms * 1000);
+}
+
+static bool i2c_async_busy;
+static uint64_t i2c_done_us;
+
+// -----------------------------------------------------------------------------
+// Multicore: o núcleo 1 é uma corrotina que roda sempre que o núcleo 0 fica
+// ocioso e devolve o controle quando ele próprio fica ocioso. O relógio
+// virtual só avança com os dois núcleos parados, o que mantém a simulação
+// determinística.
+// -----------------------------------------------------------------------------
+
+#define SIM_CORE1_STACK_SIZE (256 * 1024)
+
+static ucontext_t core0_context;
+static ucontext_t core1_context;
+static void (*core1_entry)(void);
+static bool core1_launched;
+static bool core1_current;
+
+static void core1_trampoline(void) {
+  core1_entry();
+  core1_launched = false; // Retornar do núcleo 1 o deixa parado
+  core1_current = false;
+}
+
+void hal_core1_launch(void (*entry)(void)) {
+  core1_entry = entry;
+
+  getcontext(&core1_context);
+  core1_context.uc_stack.ss_sp = malloc(SIM_CORE1_STACK_SIZE);
+  core1_context.uc_stack.ss_size = SIM_CORE1_STACK_SIZE;
+  core1_context.uc_link = &core0_context;
+  makecontext(&core1_context, core1_trampoline, 0);
+
+  core1_launched = true;
+}
+
+void hal_wake(void) {
+}
+
+// Alarme de cada núcleo (UINT64_MAX: desarmado)
+static uint64_t alarm_us[2] = {UINT64_MAX, UINT64_MAX};
+
+void hal_alarm_wake_at(uint64_t t_us) {
+  alarm_us[core1_current ? 1 : 0] = t_us;
+}
+
+void hal_idle_wait(void) {
+  // Núcleo 1 ocioso: devolve o controle ao núcleo 0
+  if (core1_current) {
+    core1_current = false;
+    swapcontext(&core1_context, &core0_context);
+    return;
+  }
+
+  // Núcleo 0 ocioso: deixa o núcleo 1 rodar até que ele também fique ocioso
+  if (core1_launched) {
+    core1_current = true;
+    swapcontext(&core0_context, &core1_context);
+  }
+
+  // Avança até a próxima "interrupção": fim do bloco DMA do ADC, da escrita
+  // I2C, do RESET dos LEDs ou um alarme, o que vier primeiro. Um alarme já
+  // vencido dispara sem avançar o tempo.
+  uint64_t next = sim_now_us + 1000;
+  if (adc_running) next = adc_block_end_us();
+  if (i2c_async_busy && i2c_done_us < next) next = i2c_done_us;
+  if (led_busy && led_done_us < next) next = led_done_us;
+  for (int core = 0; core < 2; ++core) {
+    if (alarm_us[core] <= sim_now_us) {
+      alarm_us[core] = UINT64_MAX;
+      next = sim_now_us;
+    } else if (alarm_us[core] < next) {
+      next = alarm_us[core];
+    }
+  }
+  sim_advance(next > sim_now_us ? next - sim_now_us : 0);
+}
+
+// -----------------------------------------------------------------------------
+// GPIO
+// -----------------------------------------------------------------------------
+
+#define SIM_GPIO_IRQ_EDGE_FALL 0x4u
+
+static hal_gpio_irq_cb_t gpio_irq_cb[SIM_GPIO_COUNT];
+
+void hal_gpio_input_pullup(uint gpio) {
+  if (gpio < SIM_GPIO_COUNT) pin_state[gpio] = SIM_PIN_FLOAT;
+}
+
+bool hal_gpio_read(uint gpio) {
+  // Pinos de saída seguem o nível escrito; entradas (botões soltos) leem o pull-up
+  if ((int)gpio == sim_hold_gpio && sim_now_us < SIM_HOLD_US) return false;
+  return gpio >= SIM_GPIO_COUNT || pin_state[gpio] != SIM_PIN_LOW;
+}
+
+void hal_gpio_output(uint gpio, bool high) {
+  if (gpio < SIM_GPIO_COUNT) pin_state[gpio] = high ? SIM_PIN_HIGH : SIM_PIN_LOW;
+}
+
+void hal_gpio_float(uint gpio) {
+  if (gpio < SIM_GPIO_COUNT) pin_state[gpio] = SIM_PIN_FLOAT;
+}
+
+void hal_sim_channel_attach(uint8_t input, uint gpio, double ohms) {
+  if (input >= SIM_ADC_INPUTS || gpio >= SIM_GPIO_COUNT) return;
+  divider_ohms[input][gpio] = ohms;
+  divider_attached[input] = true;
+}
+
+void hal_sim_divider_attach(uint gpio, double ohms) {
+  hal_sim_channel_attach(SIM_DIVIDER_INPUT, gpio, ohms);
+}
+
+void hal_gpio_irq_enable(uint gpio, hal_gpio_irq_cb_t cb) {
+  if (gpio < SIM_GPIO_COUNT) gpio_irq_cb[gpio] = cb;
+}
+
+void hal_sim_gpio_press(uint gpio) {
+  if (gpio < SIM_GPIO_COUNT && gpio_irq_cb[gpio])
+    gpio_irq_cb[gpio](gpio, SIM_GPIO_IRQ_EDGE_FALL);
+}
+
+void hal_reset_to_bootloader(void) {
+  fprintf(stderr, "sim: reset para BOOTSEL solicitado\n");
+  exit(0);
+}
+
+// -----------------------------------------------------------------------------
+// Serial USB
+// -----------------------------------------------------------------------------
+
+size_t hal_usb_write(const uint8_t *src, size_t len) {
+  if (!sim_usb_file) return 0;
+  fwrite(src, 1, len, sim_usb_file);
+  fflush(sim_usb_file);
+  stat_usb_bytes += len;
+  return len;
+}
+
+size_t hal_usb_read(uint8_t *dst, size_t len) {
+  size_t done = 0;
+  if (!sim_usb_file || !sim_usb_cmd || sim_now_us < sim_usb_cmd_us) return 0;
+  while (done < len && *sim_usb_cmd) dst[done++] = (uint8_t)*sim_usb_cmd++;
+  return done;
+}
+
+// -----------------------------------------------------------------------------
+// Flash
+// -----------------------------------------------------------------------------
+
+static uint8_t flash_memory[HAL_FLASH_RESERVED_SIZE];
+static bool flash_loaded;
+
+// Flash apagada, ou o conteúdo de OHMIMETRO_SIM_FLASH se o arquivo existir
+static void flash_load(void) {
+  if (flash_loaded) return;
+  flash_loaded = true;
+  memset(flash_memory, 0xFF, sizeof(flash_memory));
+
+  FILE *file = sim_flash_path ? fopen(sim_flash_path, "rb") : NULL;
+  if (!file) return;
+  if (fread(flash_memory, 1, sizeof(flash_memory), file) != sizeof(flash_memory))
+    fprintf(stderr, "sim: %s menor que a flash reservada\n", sim_flash_path);
+  fclose(file);
+}
+
+static void flash_store(void) {
+  FILE *file = sim_flash_path ? fopen(sim_flash_path, "wb") : NULL;
+  if (!file) return;
+  fwrite(flash_memory, 1, sizeof(flash_memory), file);
+  fclose(file);
+}
+
+// Como no RP2040, as interrupções ficam paradas durante a operação e o tempo
+// passa. O fluxo do ADC tem de estar parado: na placa o DMA passaria do anel
+static void flash_stall(uint64_t us) {
+  if (adc_running) {
+    fprintf(stderr, "sim: flash apagada ou gravada com o ADC rodando\n");
+    abort();
+  }
+  sim_now_us += us;
+}
+
+void hal_flash_read(uint32_t offset, void *dst, size_t len) {
+  flash_load();
+  if (offset > HAL_FLASH_RESERVED_SIZE || len > HAL_FLASH_RESERVED_SIZE - offset) abort();
+  memcpy(dst, flash_memory + offset, len);
+}
+
+void hal_flash_erase_sector(uint32_t offset) {
+  flash_load();
+  if (offset % HAL_FLASH_SECTOR_SIZE || offset >= HAL_FLASH_RESERVED_SIZE) abort();
+  memset(flash_memory + offset, 0xFF, HAL_FLASH_SECTOR_SIZE);
+  flash_store();
+  flash_stall(SIM_FLASH_ERASE_US);
+  stat_flash_erases++;
+}
+
+void hal_flash_program(uint32_t offset, const void *src, size_t len) {
+  flash_load();
+  if (offset > HAL_FLASH_RESERVED_SIZE || len > HAL_FLASH_RESERVED_SIZE - offset) abort();
+
+  // NOR: a gravação só zera bits
+  const uint8_t *bytes = src;
+  for (size_t i = 0; i < len; ++i)
+    flash_memory[offset + i] &= bytes[i];
+  flash_store();
+
+  size_t pages = (offset + len + HAL_FLASH_PAGE_SIZE - 1) / HAL_FLASH_PAGE_SIZE - offset / HAL_FLASH_PAGE_SIZE;
+  flash_stall(pages * SIM_FLASH_PAGE_US);
+  stat_flash_pages += pages;
+}
+
+// -----------------------------------------------------------------------------
+// I2C + controlador SSD1306
+// -----------------------------------------------------------------------------
+
+static uint32_t i2c_baud = 100000;
+
+static struct {
+  uint8_t gddram[SIM_OLED_PAGES][SIM_OLED_WIDTH];
+  uint8_t mem_mode; // 0 horizontal, 1 vertical, 2 página
+  uint8_t col_start, col_end, page_start, page_end;
+  uint8_t col, page;
+  uint8_t opcode;   // comando aguardando argumentos
+  uint8_t args[2];
+  uint8_t args_pending, args_count;
+} oled = {
+  .mem_mode = 2,
+  .col_end = SIM_OLED_WIDTH - 1,
+  .page_end = SIM_OLED_PAGES - 1,
+};
+
+static void oled_dump(void) {
+  if (!sim_out_dir) return;
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/oled_%05llu.pbm", sim_out_dir, (unsigned long long)stat_oled_frames);
+  FILE *f = fopen(path, "wb");
+  if (!f) return;
+
+  fprintf(f, "P4\n%d %d\n", SIM_OLED_WIDTH, SIM_OLED_PAGES * 8);
+  for (int y = 0; y < SIM_OLED_PAGES * 8; ++y) {
+    for (int x = 0; x < SIM_OLED_WIDTH; x += 8) {
+      uint8_t packed = 0;
+      for (int b = 0; b < 8; ++b)
+        if (oled.gddram[y >> 3][x + b] & (1u << (y & 7))) packed |= 0x80u >> b;
+      fputc(packed, f);
+    }
+  }
+  fclose(f);
+}
+
+static uint8_t oled_arg_count(uint8_t opcode) {
+  switch (opcode) {
+    case 0x21: case 0x22:
+      return 2;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static void oled_apply(uint8_t opcode, const uint8_t *args) {
+  if (opcode == 0x20) {
+    oled.mem_mode = args[0] & 0x03;
+  } else if (opcode == 0x21) {
+    oled.col_start = args[0] & 0x7F;
+    oled.col_end = args[1] & 0x7F;
+    oled.col = oled.col_start;
+  } else if (opcode == 0x22) {
+    oled.page_start = args[0] & 0x07;
+    oled.page_end = args[1] & 0x07;
+    oled.page = oled.page_start;
+  } else if (opcode >= 0xB0 && opcode <= 0xB7) {
+    oled.page = opcode & 0x07;
+  } else if (opcode <= 0x0F) {
+    oled.col = (oled.col & 0xF0) | opcode;
+  } else if (opcode >= 0x10 && opcode <= 0x1F) {
+    oled.col = (oled.col & 0x0F) | ((opcode & 0x07) << 4);
+  }
+}
+
+static void oled_command(uint8_t byte) {
+  if (oled.args_pending) {
+    oled.args[oled.args_count++] = byte;
+    if (--oled.args_pending == 0) oled_apply(oled.opcode, oled.args);
+    return;
+  }
+
+  oled.opcode = byte;
+  oled.args_count = 0;
+  oled.args_pending = oled_arg_count(byte);
+  if (oled.args_pending == 0) oled_apply(byte, NULL);
+}
+
+static void oled_data(uint8_t byte) {
+  oled.gddram[oled.page][oled.col] = byte;
+
+  if (oled.mem_mode == 1) {
+    // Endereçamento vertical: percorre as páginas e depois a coluna
+    if (oled.page++ >= oled.page_end) {
+      oled.page = oled.page_start;
+      if (oled.col++ >= oled.col_end) oled.col = oled.col_start;
+    }
+  } else if (oled.mem_mode == 0) {
+    if (oled.col++ >= oled.col_end) {
+      oled.col = oled.col_start;
+      if (oled.page++ >= oled.page_end) oled.page = oled.page_start;
+    }
+  } else if (oled.col++ >= oled.col_end) {
+    oled.col = oled.col_start;
+  }
+}
+
+void hal_i2c_init(uint8_t port, uint32_t baud, uint sda, uint scl) {
+  (void)port;
+  (void)sda;
+  (void)scl;
+  i2c_baud = baud;
+}
+
+// Interpreta uma transação no controlador e devolve o tempo de barramento
+static uint64_t oled_transfer(const uint8_t *src, size_t len) {
+  bool has_data = false;
+
+  // Cada byte de controle define se o(s) byte(s) seguinte(s) são comando ou
+  // dado (D/C#) e se há mais bytes de controle (Co)
+  size_t i = 0;
+  while (i < len) {
+    uint8_t control = src[i++];
+    bool is_data = control & 0x40;
+    size_t end = (control & 0x80) ? (i + 1 < len ? i + 1 : len) : len;
+
+    for (; i < end; ++i) {
+      if (is_data) {
+        oled_data(src[i]);
+        has_data = true;
+      } else {
+        oled_command(src[i]);
+      }
+    }
+  }
+
+  stat_i2c_transfers++;
+  stat_i2c_bytes += len + 1; // inclui o byte de endereço
+
+  // Tempo de barramento: 9 bits por byte (8 + ACK)
+  uint64_t bus_us = (uint64_t)(len + 1) * 9 * 1000000 / i2c_baud;
+
+  if (has_data) {
+    stat_oled_frames++;
+    oled_dump();
+    sim_part_frame(sim_now_us + bus_us);
+  }
+
+  return bus_us;
+}
+
+// Escrita assíncrona em curso: termina em i2c_done_us, quando o callback é
+// chamado como faria a IRQ do DMA
+static hal_i2c_done_cb_t i2c_done_cb;
+static void *i2c_done_ctx;
+
+static void i2c_complete_until(uint64_t t_us) {
+  while (i2c_async_busy && i2c_done_us <= t_us) {
+    i2c_async_busy = false;
+    if (i2c_done_cb) i2c_done_cb(i2c_done_ctx);
+  }
+}
+
+void hal_i2c_write(uint8_t port, uint8_t address, const uint8_t *src, size_t len) {
+  (void)port;
+  (void)address;
+
+  if (i2c_async_busy) sim_advance(i2c_done_us - sim_now_us);
+  uint64_t duration = oled_transfer(src, len);
+  i2c_start_us = sim_now_us;
+  i2c_end_us = sim_now_us + duration;
+  sim_advance(duration);
+}
+
+bool hal_i2c_write_async(uint8_t port, uint8_t address, const uint8_t *src, size_t len,
+                         hal_i2c_done_cb_t cb, void *ctx) {
+  (void)port;
+  (void)address;
+  if (i2c_async_busy || len == 0 || len > HAL_I2C_ASYNC_MAX) return false;
+
+  // Encadeada a partir de um callback, a transação começa quando a anterior
+  // terminou, não no instante em que o relógio virtual foi consultado
+  uint64_t start = i2c_done_us > sim_now_us ? i2c_done_us : sim_now_us;
+
+  i2c_async_busy = true;
+  i2c_done_us = start + oled_transfer(src, len);
+  i2c_start_us = start;
+  i2c_end_us = i2c_done_us;
+  i2c_done_cb = cb;
+  i2c_done_ctx = ctx;
+  return true;
+}
+
+bool hal_i2c_busy(uint8_t port) {
+  (void)port;
+  return i2c_async_busy;
+}
+
+// Display ou matriz recebendo um quadro em `t_us` (as últimas transferências
+// de cada um; os blocos do ADC são entregues antes da seguinte começar)
+static bool sim_rail_loaded(uint64_t t_us) {
+  return (t_us >= i2c_start_us && t_us < i2c_end_us) || (t_us >= led_start_us && t_us < led_done_us);
+}
+
+// -----------------------------------------------------------------------------
+// PIO (ws2818b) + cadeia de LEDs WS2812
+// -----------------------------------------------------------------------------
+
+// O programa ws2818b.pio usa autopull de 24 bits com deslocamento para a
+// esquerda: cada palavra do FIFO produz os bits 31..8, do MSB para o LSB.
+#define SIM_WS2818B_BITS_PER_WORD 24
+#define SIM_WS2818B_SHIFT_RIGHT 0
+
+// Tempo de RESET contado pelo alarme depois do último bit
+#define SIM_WS2818B_RESET_US 100
+
+static uint8_t led_bits[SIM_LED_COUNT * 24];
+static size_t led_bit_count;
+static uint8_t led_rgb[SIM_LED_COUNT][3];
+
+// Mapeia o índice na cadeia para (x, y) na matriz 5x5 da BitDogLab
+// (serpentina a partir do canto inferior direito)
+static void led_position(int index, int *x, int *y) {
+  int k = SIM_LED_COUNT - 1 - index;
+  *y = k / 5;
+  *x = (*y % 2 == 0) ? k % 5 : 4 - k % 5;
+}
+
+static void led_dump(void) {
+  if (!sim_out_dir) return;
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/leds_%05llu.ppm", sim_out_dir, (unsigned long long)stat_led_frames);
+  FILE *f = fopen(path, "wb");
+  if (!f) return;
+
+  uint8_t image[5 * SIM_LED_SCALE][5 * SIM_LED_SCALE][3] = {0};
+  for (int i = 0; i < SIM_LED_COUNT; ++i) {
+    int x, y;
+    led_position(i, &x, &y);
+    for (int dy = 1; dy < SIM_LED_SCALE - 1; ++dy)
+      for (int dx = 1; dx < SIM_LED_SCALE - 1; ++dx)
+        memcpy(image[y * SIM_LED_SCALE + dy][x * SIM_LED_SCALE + dx], led_rgb[i], 3);
+  }
+
+  fprintf(f, "P6\n%d %d\n255\n", 5 * SIM_LED_SCALE, 5 * SIM_LED_SCALE);
+  fwrite(image, 1, sizeof(image), f);
+  fclose(f);
+}
+
+// Sinal de RESET: cada LED captura os primeiros 24 bits recebidos (G, R, B,
+// MSB primeiro) e repassa o restante adiante na cadeia.
+static void led_latch(void) {
+  if (led_bit_count == 0) return;
+
+  for (int i = 0; i < SIM_LED_COUNT; ++i) {
+    uint8_t grb[3] = {0};
+    for (int b = 0; b < 24; ++b) {
+      size_t bit = (size_t)i * 24 + b;
+      if (bit < led_bit_count && led_bits[bit]) grb[b / 8] |= 0x80u >> (b % 8);
+    }
+    led_rgb[i][0] = grb[1];
+    led_rgb[i][1] = grb[0];
+    led_rgb[i][2] = grb[2];
+  }
+
+  led_bit_count = 0;
+  stat_led_frames++;
+  led_dump();
+}
+
+void hal_ws2818b_init(uint pin) {
+  (void)pin;
+  led_bit_count = 0;
+}
+
+// Reproduz o deslocamento da máquina PIO: a ordem dos bits na linha de dados
+// é exatamente a que os LEDs reais recebem
+static void led_shift_out(uint32_t word) {
+  for (int b = 0; b < SIM_WS2818B_BITS_PER_WORD; ++b) {
+    int shift = SIM_WS2818B_SHIFT_RIGHT ? b : 31 - b;
+    if (led_bit_count < sizeof(led_bits)) led_bits[led_bit_count++] = (word >> shift) & 1u;
+  }
+}
+
+bool hal_ws2818b_write(const uint32_t *words, size_t count) {
+  if (led_busy) return false;
+
+  for (size_t i = 0; i < count; ++i)
+    led_shift_out(words[i]);
+
+  // 1,25 us por bit a 800 kHz, seguido do RESET
+  led_busy = true;
+  led_start_us = sim_now_us;
+  led_done_us = sim_now_us + count * SIM_WS2818B_BITS_PER_WORD * 5 / 4 + SIM_WS2818B_RESET_US;
+  return true;
+}
+
+bool hal_ws2818b_busy(void) {
+  return led_busy;
+}
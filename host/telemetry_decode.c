@@ -0,0 +1,75 @@
+#include <math.h>
+#include <stdio.h>
+#include "../lib/telemetry_frame.h"
+
+// Decodifica o fluxo binário da telemetria (lib/telemetry_frame.h) lido da
+// serial USB, de um arquivo ou da entrada padrão, e imprime uma linha CSV
+// por medição. Quadros inválidos (texto do stdio, bytes corrompidos, início
+// no meio de um quadro) são descartados até o próximo delimitador.
+//
+//   stty -F /dev/ttyACM0 raw && ./ohmimetro_telemetry_decode /dev/ttyACM0
+//   OHMIMETRO_SIM_USB=/tmp/usb.bin ./ohmimetro_sim
+//   ./ohmimetro_telemetry_decode /tmp/usb.bin
+//
+// O resumo (quadros válidos, descartados e registros perdidos pela
+// sequência) sai na saída de erro. A coluna `origem` separa as medições ao
+// vivo ("medicao") das exportadas do registro na flash ("flash", pedidas
+// com o byte 'L'), cada uma com a sua sequência:
+//
+//   printf L > /dev/ttyACM0
+
+int main(int argc, char **argv) {
+  FILE *input = stdin;
+  if (argc > 1) {
+    input = fopen(argv[1], "rb");
+    if (!input) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  printf("sequencia,instante_ms,faixa,adc_medio,variancia,amostras,resistencia_ohms,comercial_ohms,origem\n");
+
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  size_t len = 0;
+  bool overflow = false, has_previous[2] = {false, false};
+  uint16_t previous[2] = {0, 0};
+  unsigned long valid = 0, invalid = 0, lost = 0;
+  int byte;
+
+  while ((byte = fgetc(input)) != EOF) {
+    if (byte != 0) {
+      if (len < sizeof(frame)) frame[len++] = (uint8_t)byte;
+      else overflow = true;
+      continue;
+    }
+
+    telemetry_sample_t sample;
+    if (len == 0) {
+      // Delimitadores seguidos: nada a decodificar
+    } else if (overflow || !telemetry_decode_frame(frame, len, &sample)) {
+      invalid++;
+    } else {
+      valid++;
+      int origin = sample.type == TELEMETRY_RECORD_LOG;
+      // Uma nova exportação recomeça pela medição mais antiga do registro
+      bool restarted = origin && (int16_t)(sample.sequence - previous[origin]) <= 0;
+      if (has_previous[origin] && !restarted) lost += (uint16_t)(sample.sequence - previous[origin] - 1);
+      previous[origin] = sample.sequence;
+      has_previous[origin] = true;
+
+      printf("%u,%u,%u,%.4f,%.6f,%u,", sample.sequence, sample.timestamp_ms, sample.range,
+             sample.adc_mean_q16 / 65536.0, sample.adc_variance / 65536.0, sample.sample_count);
+      if (sample.resistance_milliohms == UINT64_MAX) printf("inf,");
+      else printf("%.3f,", sample.resistance_milliohms / 1000.0);
+      if (sample.closest.mantissa) printf("%g", sample.closest.mantissa * pow(10.0, sample.closest.exponent));
+      printf(",%s\n", origin ? "flash" : "medicao");
+    }
+
+    len = 0;
+    overflow = false;
+  }
+
+  fprintf(stderr, "telemetria: %lu quadros válidos, %lu descartados, %lu registros perdidos\n", valid, invalid, lost);
+  return 0;
+}
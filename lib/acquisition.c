@@ -0,0 +1,213 @@
+#include "acquisition.h"
+#include "hal.h"
+#include "calibration.h"
+#include "mains_filter.h"
+#include "measurement.h"
+#include "profile.h"
+
+static uint16_t ring[ACQUISITION_BLOCK_LEN * ACQUISITION_BLOCK_COUNT];
+
+// Resumos publicados: um por bloco (ou janela) e canal. Potência de 2, para
+// que os índices continuem certos ao dar a volta em 2^32.
+#define SUMMARY_COUNT 16
+_Static_assert(SUMMARY_COUNT >= ACQUISITION_BLOCK_COUNT * ACQUISITION_MAX_CHANNELS, "anel de resumos pequeno");
+_Static_assert((SUMMARY_COUNT & (SUMMARY_COUNT - 1)) == 0, "anel de resumos fora de potência de 2");
+
+// Resumos dos blocos completos. A IRQ escreve o resumo e só então avança
+// `summary_head`; o leitor, no mesmo núcleo, avança `summary_tail`.
+static acquisition_result_t summaries[SUMMARY_COUNT];
+static volatile uint32_t summary_head;
+static uint32_t summary_tail;
+
+static const uint16_t *volatile correction;
+static void (*block_notify)(void);
+
+static mains_filter_t mains_filters[ACQUISITION_MAX_CHANNELS];
+
+static bool ratiometric;
+static uint32_t reference_gain_q16;
+static uint8_t channel_count;
+
+// Entradas na sequência do round-robin (nó e topo no ratiométrico, os canais
+// no multicanal) e a posição nela da próxima amostra. O anel percorre a
+// sequência desde o início do stream; a posição segue de um bloco ao outro.
+static uint8_t sequence_length;
+static uint8_t sequence_slot;
+
+// Soma as amostras de cada posição da sequência (com a tabela, em 1/16 de
+// código), sem guardar amostras além do bloco.
+static void sum_sequence(const uint16_t *samples, size_t count, const uint16_t *lut,
+                         uint32_t *sums, uint32_t *counts) {
+  // Uma passada por posição, de `sequence_length` em `sequence_length`
+  // amostras: cada soma fica num registrador
+  for (uint8_t i = 0; i < sequence_length; ++i) {
+    uint8_t slot = (sequence_slot + i) % sequence_length;
+    uint32_t sum = 0, n = 0;
+
+    if (lut) {
+      for (size_t k = i; k < count; k += sequence_length, ++n)
+        sum += lut[samples[k] & (CALIBRATION_LUT_SIZE - 1)];
+    } else {
+      for (size_t k = i; k < count; k += sequence_length, ++n)
+        sum += samples[k];
+    }
+    sums[slot] = sum;
+    counts[slot] = n;
+  }
+  sequence_slot = (sequence_slot + count) % sequence_length;
+}
+
+// Nó (posição 0) e topo (posição 1) do divisor: publica a razão das médias
+static void sum_ratiometric(const uint16_t *samples, size_t count, const uint16_t *lut,
+                            acquisition_result_t *summary) {
+  uint32_t sums[2], counts[2];
+  sum_sequence(samples, count, lut, sums, counts);
+
+  // (node / node_count) / (top * gain / top_count) * ADC_RESOLUTION * node_count,
+  // arredondado; as unidades (1/16 ou códigos) se cancelam. No máximo
+  // 2^22 * 2^7 * 2^12 * 2^16 no numerador, dentro dos 64 bits.
+  uint32_t node = sums[0], top = sums[1];
+  uint32_t node_count = counts[0], top_count = counts[1];
+  uint32_t full_scale = node_count * ADC_RESOLUTION;
+  uint64_t den = (uint64_t)top * reference_gain_q16;
+  uint32_t sum = full_scale;
+  if (den && top_count) {
+    uint64_t q = (((uint64_t)node * top_count * ADC_RESOLUTION << 16) + den / 2) / den;
+    if (q < full_scale) sum = (uint32_t)q;
+  }
+
+  summary->sum = sum;
+  summary->count = node_count;
+  summary->channel = 0;
+}
+
+// Códigos corrigidos em 1/16 de volta a códigos inteiros, arredondados: erro
+// de meio código na soma inteira, ou 1/200 de código na média de um bloco
+static uint32_t round_corrected(uint32_t sum) {
+  return (sum + (1u << (CALIBRATION_FRACTION_BITS - 1))) >> CALIBRATION_FRACTION_BITS;
+}
+
+// Soma do bloco inteiro, em códigos
+static void sum_single(const uint16_t *samples, size_t count, const uint16_t *lut,
+                       acquisition_result_t *summary) {
+  uint32_t sum = 0;
+
+  if (lut) {
+    for (size_t i = 0; i < count; ++i)
+      sum += lut[samples[i] & (CALIBRATION_LUT_SIZE - 1)];
+    sum = round_corrected(sum);
+  } else {
+    for (size_t i = 0; i < count; ++i)
+      sum += samples[i];
+  }
+
+  summary->sum = sum;
+  summary->count = count;
+  summary->channel = 0;
+}
+
+// Callback de conclusão de bloco: soma o bloco e publica os resumos completos.
+static void on_block(const uint16_t *samples, size_t count) {
+  const uint16_t *lut = correction;
+  acquisition_result_t blocks[ACQUISITION_MAX_CHANNELS];
+  bool complete = false;
+
+  PROFILE_START(PROFILE_ADC_BLOCK);
+  if (channel_count > 1) {
+    uint32_t sums[ACQUISITION_MAX_CHANNELS], counts[ACQUISITION_MAX_CHANNELS];
+    sum_sequence(samples, count, lut, sums, counts);
+    for (uint8_t c = 0; c < channel_count; ++c) {
+      blocks[c].sum = lut ? round_corrected(sums[c]) : sums[c];
+      blocks[c].count = counts[c];
+      blocks[c].channel = c;
+    }
+  } else if (ratiometric) {
+    sum_ratiometric(samples, count, lut, &blocks[0]);
+  } else {
+    sum_single(samples, count, lut, &blocks[0]);
+  }
+
+  // Os filtros dos canais completam a janela no mesmo bloco
+  for (uint8_t c = 0; c < channel_count; ++c) {
+    acquisition_result_t *summary = &summaries[summary_head % SUMMARY_COUNT];
+    if (mains_filter_add(&mains_filters[c], &blocks[c], summary)) {
+      summary->channel = c;
+      summary_head++;
+      complete = true;
+    }
+  }
+  PROFILE_STOP(PROFILE_ADC_BLOCK);
+
+  if (complete && block_notify) block_notify();
+}
+
+bool acquisition_init(const acquisition_config_t *config) {
+  uint8_t window_blocks = mains_filter_window_blocks(config->mains_hz, config->sample_rate_hz, ACQUISITION_BLOCK_LEN);
+
+  channel_count = config->channels > 1 ? config->channels : 1;
+  if (channel_count > ACQUISITION_MAX_CHANNELS) channel_count = ACQUISITION_MAX_CHANNELS;
+  for (uint8_t c = 0; c < channel_count; ++c)
+    mains_filter_init(&mains_filters[c], window_blocks);
+
+  correction = config->correction;
+  block_notify = config->on_block;
+  ratiometric = config->ratiometric && channel_count == 1;
+  reference_gain_q16 = config->reference_gain_q16;
+  hal_adc_stream_init(config->input, config->sample_rate_hz, ring,
+                      ACQUISITION_BLOCK_LEN, ACQUISITION_BLOCK_COUNT, on_block);
+
+  uint8_t mask = 0;
+  if (channel_count > 1) {
+    mask = ((1u << channel_count) - 1) << config->input;
+    sequence_length = channel_count;
+  } else if (ratiometric) {
+    mask = (1u << config->input) | (1u << config->reference_input);
+    sequence_length = 2;
+  }
+  hal_adc_stream_set_round_robin(mask);
+  return window_blocks != 0;
+}
+
+void acquisition_start(void) {
+  summary_tail = summary_head;
+  sequence_slot = 0;
+  for (uint8_t c = 0; c < channel_count; ++c)
+    mains_filter_reset(&mains_filters[c]);
+  hal_adc_stream_start();
+}
+
+void acquisition_stop(void) {
+  hal_adc_stream_stop();
+}
+
+bool acquisition_poll(acquisition_result_t *result) {
+  // Depois de acquisition_flush o leitor fica uma janela à frente da IRQ
+  while ((int32_t)(summary_head - summary_tail) > 0) {
+    // Atraso maior que o anel: pula para o resumo mais antigo ainda guardado
+    if (summary_head - summary_tail > SUMMARY_COUNT)
+      summary_tail = summary_head - SUMMARY_COUNT;
+
+    *result = summaries[summary_tail % SUMMARY_COUNT];
+
+    // A IRQ pode ter sobrescrito a posição durante a cópia; nesse caso repete
+    if (summary_head - summary_tail > SUMMARY_COUNT) continue;
+
+    summary_tail++;
+    return true;
+  }
+
+  return false;
+}
+
+void acquisition_wait(acquisition_result_t *result) {
+  while (!acquisition_poll(result))
+    hal_idle_wait();
+}
+
+void acquisition_set_correction(const uint16_t *lut) {
+  correction = lut;
+}
+
+void acquisition_flush(void) {
+  summary_tail = summary_head + channel_count;
+}
@@ -0,0 +1,75 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Blocos do anel de DMA (em amostras) e quantidade de blocos no anel
+#define ACQUISITION_BLOCK_LEN 100
+#define ACQUISITION_BLOCK_COUNT 4
+
+// Entradas externas do ADC (GPIO 26 a 28) lidas no modo multicanal
+#define ACQUISITION_MAX_CHANNELS 3
+
+// Modo ratiométrico: o round-robin do ADC intercala o nó do divisor com uma
+// segunda entrada ligada ao topo do divisor (o trilho que alimenta os GPIOs
+// das faixas), e cada bloco é publicado como se o topo estivesse no fundo de
+// escala. Uma queda do trilho afeta as duas entradas na mesma proporção e sai
+// da razão, em vez de aparecer como erro de resistência.
+//
+// Modo multicanal: o round-robin percorre `channels` entradas a partir de
+// `input` (input, input + 1, ...), cada uma com o seu divisor, e cada bloco
+// gera um resumo por canal. O par (ou o canal) de cada amostra segue de um
+// bloco ao outro, então o bloco não precisa ser múltiplo do número de canais.
+// Os dois modos não se combinam.
+typedef struct {
+  uint8_t input;               // Entrada do ADC (ADC_PIN 28 => entrada 2)
+  uint32_t sample_rate_hz;     // Taxa de amostragem do ADC em modo free-running
+  const uint16_t *correction;  // Tabela de calibração (calibration.h) ou NULL
+  void (*on_block)(void);      // Chamado na IRQ a cada bloco publicado, ou NULL
+  bool ratiometric;            // Intercala `reference_input` com `input`
+  uint8_t reference_input;     // Entrada ligada ao topo do divisor
+  uint32_t reference_gain_q16; // Topo do divisor / tensão na entrada de referência (Q16)
+  uint16_t mains_hz;           // Zumbido rejeitado (mains_filter.h): 50, 60 ou 0 (desligado)
+  uint8_t channels;            // Canais do modo multicanal (0 ou 1: um só)
+} acquisition_config_t;
+
+// Resumo de um bloco do anel, calculado na IRQ do DMA. Com o filtro da rede,
+// resumo de uma janela de ciclos inteiros da rede (os blocos dela somados), e
+// o que segue vale para janelas no lugar de blocos. Quantos blocos formam uma
+// medição fica a cargo do estágio de estatística (sample_stats.h).
+//
+// No modo ratiométrico, `count` conta só as amostras do nó, metade do bloco
+// (a taxa de cada entrada é metade de `sample_rate_hz`), e `sum` é a média do
+// nó dividida pela do topo, em códigos do fundo de escala, vezes `count`.
+// No multicanal, os resumos dos canais de um bloco (ou janela) saem juntos, em
+// ordem de canal, cada um com as amostras só do seu canal.
+typedef struct {
+  uint32_t sum;    // Soma dos códigos do ADC (corrigidos, com calibração)
+  uint32_t count;  // Número de amostras somadas
+  uint8_t channel; // Canal (0 fora do modo multicanal)
+} acquisition_result_t;
+
+// Retorna false se a taxa não permite janelas de ciclos inteiros da rede com
+// até MAINS_FILTER_MAX_BLOCKS blocos; a aquisição segue sem o filtro. No
+// multicanal, a taxa é a soma das taxas dos canais.
+bool acquisition_init(const acquisition_config_t *config);
+void acquisition_start(void);
+void acquisition_stop(void);
+
+// Retorna true (e preenche `result`) quando há um bloco completo ainda não
+// lido. Se o leitor atrasar mais que o anel, os blocos mais antigos se perdem.
+bool acquisition_poll(acquisition_result_t *result);
+
+// Aguarda, dormindo entre interrupções, até o próximo bloco completo.
+void acquisition_wait(acquisition_result_t *result);
+
+// Troca a tabela de calibração (NULL usa os códigos brutos). O bloco em
+// andamento pode misturar as duas; use acquisition_flush em seguida.
+void acquisition_set_correction(const uint16_t *correction);
+
+// Descarta os blocos não lidos e o bloco (ou a janela) em andamento, que podem conter
+// amostras de antes de uma mudança no circuito (troca de faixa, por exemplo).
+void acquisition_flush(void);
+
+#endif
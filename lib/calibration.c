@@ -0,0 +1,159 @@
+#include <stddef.h>
+#include <string.h>
+#include "calibration.h"
+#include "crc.h"
+#include "hal.h"
+#include "measurement.h"
+
+// Registro gravado na flash. O CRC cobre todos os bytes anteriores a ele,
+// inclusive o preenchimento, que é zerado antes do cálculo.
+#define CALIBRATION_MAGIC 0x4C41434Fu // "OCAL"
+#define CALIBRATION_VERSION 1
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length; // sizeof(calibration_record_t)
+  calibration_t data;
+  uint32_t crc;
+} calibration_record_t;
+
+// Ganho aceito no ajuste: o ADC do RP2040 erra alguns por cento, nunca 2x
+#define CALIBRATION_GAIN_MIN (65536 / 2)
+#define CALIBRATION_GAIN_MAX (65536 * 2)
+
+#define Q16_TO_LUT_SHIFT (16 - CALIBRATION_FRACTION_BITS)
+
+// O ajuste trabalha em Q16 nas duas versões do pipeline
+#ifdef OHMIMETRO_FIXED_POINT
+static int64_t to_q16(adc_mean_t value) {
+  return value;
+}
+#else
+static int64_t to_q16(adc_mean_t value) {
+  return (int64_t)(value * 65536.0f + 0.5f);
+}
+#endif
+
+// Divisão com arredondamento para o mais próximo, para qualquer sinal
+static int64_t div_round(int64_t numerator, int64_t denominator) {
+  if ((numerator < 0) != (denominator < 0))
+    return (numerator - denominator / 2) / denominator;
+  return (numerator + denominator / 2) / denominator;
+}
+
+void calibration_identity(calibration_t *calibration) {
+  memset(calibration, 0, sizeof(*calibration));
+  calibration->gain = 65536;
+}
+
+adc_mean_t calibration_divider_code(resistance_t reference, resistance_t unknown) {
+  if (unknown == RESISTANCE_INVALID) return ADC_MEAN(ADC_RESOLUTION);
+#ifdef OHMIMETRO_FIXED_POINT
+  uint64_t total = reference + unknown;
+  return (adc_mean_t)((ADC_MEAN(ADC_RESOLUTION) * unknown + total / 2) / total);
+#else
+  return ADC_RESOLUTION * unknown / (reference + unknown);
+#endif
+}
+
+bool calibration_fit(const calibration_point_t *points, size_t count, calibration_t *calibration) {
+  if (count < 2) return false;
+
+  // Extremos pelo código esperado
+  size_t lo = 0, hi = 0;
+  for (size_t i = 1; i < count; ++i) {
+    if (points[i].expected < points[lo].expected) lo = i;
+    if (points[i].expected > points[hi].expected) hi = i;
+  }
+
+  int64_t lo_measured = to_q16(points[lo].measured), lo_expected = to_q16(points[lo].expected);
+  int64_t hi_measured = to_q16(points[hi].measured), hi_expected = to_q16(points[hi].expected);
+  if (hi_measured <= lo_measured || hi_expected <= lo_expected) return false;
+
+  int64_t gain = div_round((hi_expected - lo_expected) << 16, hi_measured - lo_measured);
+  if (gain < CALIBRATION_GAIN_MIN || gain > CALIBRATION_GAIN_MAX) return false;
+
+  calibration_t fitted;
+  fitted.gain = (uint32_t)gain;
+  fitted.offset = (int32_t)(lo_measured - div_round(lo_expected << 16, gain));
+
+  // Resíduo de cada ponto no domínio do código bruto (Q16): quanto somar à
+  // leitura para que a reta dos extremos dê o código esperado. Cada ponto da
+  // tabela interpola os resíduos dos vizinhos medidos abaixo e acima dele.
+  for (size_t k = 0; k < CALIBRATION_INL_POINTS; ++k) {
+    int64_t x = (int64_t)(k * CALIBRATION_INL_STEP) << 16;
+    const calibration_point_t *below = NULL, *above = NULL;
+
+    for (size_t i = 0; i < count; ++i) {
+      int64_t measured = to_q16(points[i].measured);
+      if (measured <= x && (!below || measured > to_q16(below->measured))) below = &points[i];
+      if (measured >= x && (!above || measured < to_q16(above->measured))) above = &points[i];
+    }
+
+    int64_t residual[2], measured[2];
+    const calibration_point_t *neighbors[2] = {below ? below : above, above ? above : below};
+    for (int n = 0; n < 2; ++n) {
+      measured[n] = to_q16(neighbors[n]->measured);
+      residual[n] = div_round(to_q16(neighbors[n]->expected) << 16, gain) + fitted.offset - measured[n];
+    }
+
+    int64_t inl = residual[0];
+    if (measured[1] > measured[0])
+      inl += div_round((residual[1] - residual[0]) * (x - measured[0]), measured[1] - measured[0]);
+
+    inl = div_round(inl, 1 << Q16_TO_LUT_SHIFT);
+    if (inl > INT16_MAX) inl = INT16_MAX;
+    if (inl < INT16_MIN) inl = INT16_MIN;
+    fitted.inl[k] = (int16_t)inl;
+  }
+
+  *calibration = fitted;
+  return true;
+}
+
+void calibration_build_lut(const calibration_t *calibration, uint16_t *lut) {
+  const int64_t max = (int64_t)ADC_RESOLUTION << CALIBRATION_FRACTION_BITS;
+
+  for (uint32_t code = 0; code < CALIBRATION_LUT_SIZE; ++code) {
+    // INL interpolada em Q16: 1/16 de código vale 2^12, dividido pelo passo
+    uint32_t k = code / CALIBRATION_INL_STEP, f = code % CALIBRATION_INL_STEP;
+    int64_t inl = ((int64_t)calibration->inl[k] * CALIBRATION_INL_STEP +
+                   (int64_t)(calibration->inl[k + 1] - calibration->inl[k]) * f) *
+                  ((1 << Q16_TO_LUT_SHIFT) / CALIBRATION_INL_STEP);
+
+    int64_t raw = ((int64_t)code << 16) + inl - calibration->offset;
+    int64_t corrected = div_round(raw * calibration->gain, (int64_t)1 << (16 + Q16_TO_LUT_SHIFT));
+
+    if (corrected < 0) corrected = 0;
+    if (corrected > max) corrected = max;
+    lut[code] = (uint16_t)corrected;
+  }
+}
+
+bool calibration_load(calibration_t *calibration) {
+  calibration_record_t record;
+  hal_flash_read(CALIBRATION_FLASH_OFFSET, &record, sizeof(record));
+
+  if (record.magic != CALIBRATION_MAGIC || record.version != CALIBRATION_VERSION ||
+      record.length != sizeof(record))
+    return false;
+  if (record.crc != crc32_update(0, &record, offsetof(calibration_record_t, crc)))
+    return false;
+
+  *calibration = record.data;
+  return true;
+}
+
+void calibration_save(const calibration_t *calibration) {
+  calibration_record_t record;
+  memset(&record, 0, sizeof(record));
+  record.magic = CALIBRATION_MAGIC;
+  record.version = CALIBRATION_VERSION;
+  record.length = sizeof(record);
+  record.data = *calibration;
+  record.crc = crc32_update(0, &record, offsetof(calibration_record_t, crc));
+
+  hal_flash_erase_sector(CALIBRATION_FLASH_OFFSET);
+  hal_flash_program(CALIBRATION_FLASH_OFFSET, &record, sizeof(record));
+}
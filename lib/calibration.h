@@ -0,0 +1,66 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Calibração do ADC do RP2040: offset, ganho e uma correção de INL linear por
+// partes, medidos com referências conhecidas (ponteiras em curto, abertas e
+// resistores fixos) e guardados no primeiro setor reservado da flash.
+//
+// A correção é aplicada amostra a amostra pela aquisição com uma tabela de
+// 4096 posições (código bruto => código corrigido em 1/16 de código), ao
+// custo de uma leitura de memória por amostra:
+//
+//   corrigido = ganho * (bruto + inl(bruto) - offset)
+//
+// O ajuste é feito pelos extremos: o ponto de menor e o de maior código
+// esperado definem offset e ganho, e o resíduo dos pontos intermediários,
+// interpolado entre eles, vira a tabela de INL.
+
+#define CALIBRATION_LUT_SIZE 4096
+
+// Códigos corrigidos da tabela em 1/16 de código
+#define CALIBRATION_FRACTION_BITS 4
+
+// Pontos da tabela de INL: um a cada 128 códigos, de 0 a 4096
+#define CALIBRATION_INL_STEP 128
+#define CALIBRATION_INL_POINTS (CALIBRATION_LUT_SIZE / CALIBRATION_INL_STEP + 1)
+
+// Posição do registro na área reservada da flash (hal.h)
+#define CALIBRATION_FLASH_OFFSET 0
+
+typedef struct {
+  int32_t offset; // Código bruto (Q16) que corresponde a 0 V
+  uint32_t gain;  // Ganho aplicado depois do offset (Q16, 1.0 => 65536)
+  int16_t inl[CALIBRATION_INL_POINTS]; // Somado ao código bruto, em 1/16 de código
+} calibration_t;
+
+// Uma referência medida no modo de calibração
+typedef struct {
+  adc_mean_t measured; // Código médio lido, sem correção
+  adc_mean_t expected; // Código ideal para a referência
+} calibration_point_t;
+
+// Calibração neutra (ganho 1, sem offset nem INL).
+void calibration_identity(calibration_t *calibration);
+
+// Código ideal do divisor com `unknown` embaixo e `reference` em cima.
+// `unknown` RESISTANCE_INVALID (ponteiras abertas) dá o fundo de escala. Em
+// ponto fixo, `unknown` vai até 60 MΩ sem estourar o produto de 64 bits.
+adc_mean_t calibration_divider_code(resistance_t reference, resistance_t unknown);
+
+// Ajusta a calibração aos pontos medidos (ao menos 2, com códigos distintos).
+// Retorna false, sem alterar `calibration`, se os pontos não servirem.
+bool calibration_fit(const calibration_point_t *points, size_t count, calibration_t *calibration);
+
+// Tabela código bruto => código corrigido (em 1/16), limitada a 0..4095.
+void calibration_build_lut(const calibration_t *calibration, uint16_t *lut);
+
+// Registro da flash: false se ausente, de outra versão ou com CRC inválido.
+bool calibration_load(calibration_t *calibration);
+void calibration_save(const calibration_t *calibration);
+
+#endif
@@ -0,0 +1,15 @@
+#include "crc.h"
+
+// Bit a bit, sem tabela: os registros protegidos são pequenos e raros
+// (gravação e leitura da flash), então 1 KB de tabela não se paga
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len) {
+  const uint8_t *bytes = data;
+
+  crc = ~crc;
+  while (len--) {
+    crc ^= *bytes++;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+  }
+  return ~crc;
+}
@@ -0,0 +1,12 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, polinômio refletido 0xEDB88320), o mesmo do zlib:
+// crc32("123456789") == 0xCBF43926. Para continuar um cálculo em partes,
+// passe o resultado anterior em `crc`; comece com 0.
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len);
+
+#endif
@@ -0,0 +1,179 @@
+#include "eseries.h"
+
+// Tabelas da IEC 60063 com três dígitos significativos (1.0 => 100). A E6 e
+// a E12 são subconjuntos da E24 (um valor a cada 4 e a cada 2), e a E48 e a
+// E96 da E192. A última posição (1000) é o início da década seguinte: um
+// valor acima do último ponto médio, como 9.7 na E24, arredonda para 10.
+static const uint16_t e24_values[24 + 1] = {
+  100, 110, 120, 130, 150, 160, 180, 200, 220, 240, 270, 300,
+  330, 360, 390, 430, 470, 510, 560, 620, 680, 750, 820, 910,
+  1000
+};
+
+static const uint16_t e192_values[192 + 1] = {
+  100, 101, 102, 104, 105, 106, 107, 109, 110, 111, 113, 114,
+  115, 117, 118, 120, 121, 123, 124, 126, 127, 129, 130, 132,
+  133, 135, 137, 138, 140, 142, 143, 145, 147, 149, 150, 152,
+  154, 156, 158, 160, 162, 164, 165, 167, 169, 172, 174, 176,
+  178, 180, 182, 184, 187, 189, 191, 193, 196, 198, 200, 203,
+  205, 208, 210, 213, 215, 218, 221, 223, 226, 229, 232, 234,
+  237, 240, 243, 246, 249, 252, 255, 258, 261, 264, 267, 271,
+  274, 277, 280, 284, 287, 291, 294, 298, 301, 305, 309, 312,
+  316, 320, 324, 328, 332, 336, 340, 344, 348, 352, 357, 361,
+  365, 370, 374, 379, 383, 388, 392, 397, 402, 407, 412, 417,
+  422, 427, 432, 437, 442, 448, 453, 459, 464, 470, 475, 481,
+  487, 493, 499, 505, 511, 517, 523, 530, 536, 542, 549, 556,
+  562, 569, 576, 583, 590, 597, 604, 612, 619, 626, 634, 642,
+  649, 657, 665, 673, 681, 690, 698, 706, 715, 723, 732, 741,
+  750, 759, 768, 777, 787, 796, 806, 816, 825, 835, 845, 856,
+  866, 876, 887, 898, 909, 920, 931, 942, 953, 965, 976, 988,
+  1000
+};
+
+typedef struct {
+  const uint16_t *values;
+  uint8_t stride;
+  uint8_t size;
+} eseries_table_t;
+
+static const eseries_table_t series_tables[] = {
+  [ESERIES_E6]   = {e24_values, 4, 6},
+  [ESERIES_E12]  = {e24_values, 2, 12},
+  [ESERIES_E24]  = {e24_values, 1, 24},
+  [ESERIES_E48]  = {e192_values, 4, 48},
+  [ESERIES_E96]  = {e192_values, 2, 96},
+  [ESERIES_E192] = {e192_values, 1, 192},
+};
+
+// Ponto médio entre os valores `i` e `i + 1` da série, na escala da mantissa
+// de eseries_nearest (1.0 => 1000000). Sai das próprias tabelas com uma soma de
+// inteiros, sem uma segunda tabela de limites por série.
+#define ESERIES_BOUNDARY(table, i) \
+  ((uint32_t)((table)->values[(i) * (table)->stride] + (table)->values[((i) + 1) * (table)->stride]) * 5000)
+
+// Potências de 10 de 1e-7 a 1e9, cobrindo as décadas aceitas e as escalas
+// usadas para extrair a mantissa
+#define POW10_MIN (-7)
+static const float pow10_table[] = {
+  1e-7f, 1e-6f, 1e-5f, 1e-4f, 1e-3f, 1e-2f, 1e-1f, 1e0f,
+  1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f
+};
+
+static inline float pow10_of(int exponent) {
+  return pow10_table[exponent - POW10_MIN];
+}
+
+// Década de `value` (10^decade <= value < 10^(decade + 1)) por busca binária
+// nas potências de 10. Retorna false fora da faixa aceita; o limite inferior
+// tem uma folga para que o próprio 1 mΩ, vindo de eseries_to_float com erro
+// de arredondamento, continue aceito.
+static bool eseries_decade(float value, int *decade) {
+  if (!(value >= pow10_of(ESERIES_DECADE_MIN) * 0.9999f) || value >= 1e10f) return false;
+
+  int lo = ESERIES_DECADE_MIN, hi = ESERIES_DECADE_MAX;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (value >= pow10_of(mid))
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  *decade = lo;
+  return true;
+}
+
+uint8_t eseries_size(eseries_t series) {
+  return series_tables[series].size;
+}
+
+fraction_t eseries_relative_step(eseries_t series) {
+  static const fraction_t steps[] = {
+    [ESERIES_E6]   = FRACTION(0.4678),
+    [ESERIES_E12]  = FRACTION(0.2115),
+    [ESERIES_E24]  = FRACTION(0.1007),
+    [ESERIES_E48]  = FRACTION(0.0491),
+    [ESERIES_E96]  = FRACTION(0.0243),
+    [ESERIES_E192] = FRACTION(0.0121),
+  };
+  return steps[series];
+}
+
+uint8_t eseries_significant_digits(eseries_t series) {
+  return series >= ESERIES_E48 ? 3 : 2;
+}
+
+// Busca comum às duas entradas: `mantissa` em [1000000, 10000000] na década
+// `decade` (em ohms)
+static void eseries_nearest_mantissa(eseries_t series, uint32_t mantissa, int decade, eseries_value_t *out) {
+  // Primeiro valor cujo ponto médio com o seguinte não fica abaixo da
+  // mantissa. Empates ficam com o menor valor.
+  const eseries_table_t *table = &series_tables[series];
+  uint8_t lo = 0, hi = table->size;
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    if (mantissa <= ESERIES_BOUNDARY(table, mid))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  if (lo == table->size) {
+    // Passou do último ponto médio: início da década seguinte
+    out->mantissa = 100;
+    out->exponent = decade - 1;
+  } else {
+    out->mantissa = table->values[lo * table->stride];
+    out->exponent = decade - 2;
+  }
+}
+
+bool eseries_nearest(eseries_t series, float value, eseries_value_t *out) {
+  int decade;
+  if (!eseries_decade(value, &decade)) return false;
+
+  // Mantissa em [1000000, 10000000], arredondada. Ainda cabe nos 24 bits de
+  // um float sem perder a unidade.
+  uint32_t mantissa = (uint32_t)(value * pow10_of(6 - decade) + 0.5f);
+
+  eseries_nearest_mantissa(series, mantissa, decade, out);
+  return true;
+}
+
+// Potências de 10 inteiras até 10^13 mΩ (10 GΩ)
+static const uint64_t pow10_u64[] = {
+  1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+  100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+  1000000000000ull, 10000000000000ull
+};
+
+bool eseries_nearest_milliohms(eseries_t series, uint64_t milliohms, eseries_value_t *out) {
+  // Década em miliohms (0 => 1 mΩ, 12 => 1 GΩ), por busca binária
+  if (milliohms == 0 || milliohms >= pow10_u64[13]) return false;
+
+  int lo = 0, hi = 12;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (milliohms >= pow10_u64[mid])
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  // Mantissa com 7 dígitos: multiplica nas décadas baixas e divide, com
+  // arredondamento, nas altas
+  uint32_t mantissa;
+  if (lo <= 6) {
+    mantissa = (uint32_t)(milliohms * pow10_u64[6 - lo]);
+  } else {
+    uint64_t divisor = pow10_u64[lo - 6];
+    mantissa = (uint32_t)((milliohms + divisor / 2) / divisor);
+  }
+
+  eseries_nearest_mantissa(series, mantissa, lo - 3, out);
+  return true;
+}
+
+float eseries_to_float(eseries_value_t value) {
+  return value.mantissa * pow10_of(value.exponent);
+}
@@ -0,0 +1,50 @@
+#ifndef ESERIES_H
+#define ESERIES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Séries E da IEC 60063 (E6 a E192). Cada valor é representado em inteiros
+// como três dígitos significativos e um expoente de base 10, o que permite
+// achar o valor comercial mais próximo sem divisão em ponto flutuante nem
+// powf (o RP2040 não tem FPU).
+
+typedef enum {
+  ESERIES_E6,
+  ESERIES_E12,
+  ESERIES_E24,
+  ESERIES_E48,
+  ESERIES_E96,
+  ESERIES_E192,
+} eseries_t;
+
+// Faixa de décadas aceitas: de 1 mΩ até abaixo de 10 GΩ
+#define ESERIES_DECADE_MIN (-3)
+#define ESERIES_DECADE_MAX 9
+
+// Valor = mantissa * 10^exponent, com a mantissa entre 100 e 999
+typedef struct {
+  uint16_t mantissa;
+  int8_t exponent;
+} eseries_value_t;
+
+// Número de valores por década da série
+uint8_t eseries_size(eseries_t series);
+
+// Distância relativa entre valores vizinhos da série, 10^(1/n) - 1
+fraction_t eseries_relative_step(eseries_t series);
+
+// Dígitos significativos do código de cores: 2 (4 faixas) até a E24 e
+// 3 (5 faixas) nas séries de precisão
+uint8_t eseries_significant_digits(eseries_t series);
+
+// Valor da série mais próximo de `value`. Retorna false fora da faixa.
+bool eseries_nearest(eseries_t series, float value, eseries_value_t *out);
+
+// Mesma busca a partir de miliohms, só com aritmética inteira.
+bool eseries_nearest_milliohms(eseries_t series, uint64_t milliohms, eseries_value_t *out);
+
+float eseries_to_float(eseries_value_t value);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <math.h>
+#include <stdint.h>
+
+// Formato numérico do pipeline de medição. Com OHMIMETRO_FIXED_POINT (padrão
+// do firmware) todo o caminho da soma das amostras até o texto do display é
+// inteiro, sem as rotinas de ponto flutuante em software do Cortex-M0+:
+//
+//   adc_mean_t    código médio do ADC em Q16.16
+//   resistance_t  resistência em miliohms (uint64)
+//   fraction_t    fração em Q16 (0.01 => 655)
+//
+// Sem a opção, os mesmos tipos são float e o pipeline serve de referência.
+// As macros ADC_MEAN, RESISTANCE_OHMS e FRACTION convertem constantes em
+// tempo de compilação.
+
+#ifdef OHMIMETRO_FIXED_POINT
+
+typedef uint32_t adc_mean_t;
+typedef uint64_t resistance_t;
+typedef uint32_t fraction_t;
+
+#define ADC_MEAN(code) ((adc_mean_t)((code) * 65536.0 + 0.5))
+#define RESISTANCE_OHMS(ohms) ((resistance_t)((ohms) * 1000.0 + 0.5))
+#define FRACTION(x) ((fraction_t)((x) * 65536.0 + 0.5))
+
+// Resultado do divisor com o ADC saturado no fundo de escala
+#define RESISTANCE_INVALID UINT64_MAX
+#define FRACTION_INFINITE UINT32_MAX
+
+// Raiz quadrada inteira (arredondada para baixo), bit a bit
+static inline uint32_t isqrt64(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = 1ull << 62;
+
+  while (bit > value) bit >>= 2;
+  while (bit) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+static inline resistance_t resistance_geometric_mean(resistance_t a, resistance_t b) {
+  return isqrt64(a * b);
+}
+
+// Conversões para diagnóstico e ferramentas de host
+static inline float adc_mean_to_float(adc_mean_t value) { return value / 65536.0f; }
+static inline float resistance_to_ohms(resistance_t value) { return value / 1000.0f; }
+static inline float fraction_to_float(fraction_t value) { return value / 65536.0f; }
+
+#else
+
+typedef float adc_mean_t;
+typedef float resistance_t;
+typedef float fraction_t;
+
+#define ADC_MEAN(code) ((adc_mean_t)(code))
+#define RESISTANCE_OHMS(ohms) ((resistance_t)(ohms))
+#define FRACTION(x) ((fraction_t)(x))
+
+#define RESISTANCE_INVALID INFINITY
+#define FRACTION_INFINITE INFINITY
+
+static inline resistance_t resistance_geometric_mean(resistance_t a, resistance_t b) {
+  return sqrtf(a * b);
+}
+
+static inline float adc_mean_to_float(adc_mean_t value) { return value; }
+static inline float resistance_to_ohms(resistance_t value) { return value; }
+static inline float fraction_to_float(fraction_t value) { return value; }
+
+#endif
+
+#endif
@@ -0,0 +1,185 @@
+#include <stddef.h>
+#include <string.h>
+#include "flash_log.h"
+#include "crc.h"
+
+typedef struct {
+  uint32_t sequence;
+  uint16_t magic;
+  uint8_t version;
+  uint8_t count;
+  flash_log_entry_t entries[FLASH_LOG_PAGE_ENTRIES];
+  uint32_t crc;
+  uint32_t reserved;
+} flash_log_page_t;
+
+_Static_assert(sizeof(flash_log_page_t) == HAL_FLASH_PAGE_SIZE, "página do registro != página da flash");
+
+static uint32_t page_offset(uint32_t page) {
+  return FLASH_LOG_OFFSET + page * HAL_FLASH_PAGE_SIZE;
+}
+
+static uint32_t page_sector(uint32_t page) {
+  return page / FLASH_LOG_PAGES_PER_SECTOR;
+}
+
+static uint32_t page_crc(const flash_log_page_t *page) {
+  return crc32_update(0, page, offsetof(flash_log_page_t, crc));
+}
+
+// Lê a página e confere o cabeçalho e o CRC
+static bool read_page(uint32_t page, flash_log_page_t *data) {
+  hal_flash_read(page_offset(page), data, sizeof(*data));
+  return data->magic == FLASH_LOG_MAGIC && data->version == FLASH_LOG_VERSION &&
+         data->count > 0 && data->count <= FLASH_LOG_PAGE_ENTRIES && data->crc == page_crc(data);
+}
+
+static bool is_blank(uint32_t offset, size_t len) {
+  uint32_t words[HAL_FLASH_PAGE_SIZE / 4];
+
+  for (size_t done = 0; done < len; done += sizeof(words)) {
+    hal_flash_read(offset + done, words, sizeof(words));
+    for (size_t i = 0; i < sizeof(words) / 4; ++i)
+      if (words[i] != 0xFFFFFFFFu) return false;
+  }
+  return true;
+}
+
+void flash_log_mount(flash_log_t *log) {
+  flash_log_page_t data;
+
+  memset(log, 0, sizeof(*log));
+  log->empty = true;
+
+  for (uint32_t page = 0; page < FLASH_LOG_PAGES; ++page) {
+    if (!read_page(page, &data)) continue;
+    if (log->empty || data.sequence >= log->next_sequence) {
+      log->next_sequence = data.sequence + 1;
+      log->next_page = (page + 1) % FLASH_LOG_PAGES;
+    }
+    log->empty = false;
+  }
+}
+
+bool flash_log_append(flash_log_t *log, const telemetry_sample_t *sample) {
+  if (log->pending_count == FLASH_LOG_PAGE_ENTRIES) log->pending_count--;
+
+  flash_log_entry_t *entry = &log->pending[log->pending_count++];
+  memset(entry, 0, sizeof(*entry));
+  entry->timestamp_ms = sample->timestamp_ms;
+  entry->adc_mean_q16 = sample->adc_mean_q16;
+  entry->resistance_milliohms = sample->resistance_milliohms;
+  entry->closest = sample->closest;
+  entry->sample_count = sample->sample_count > UINT16_MAX ? UINT16_MAX : sample->sample_count;
+  entry->range = sample->range;
+  entry->series = sample->series;
+
+  return log->pending_count == FLASH_LOG_PAGE_ENTRIES;
+}
+
+void flash_log_commit(flash_log_t *log) {
+  if (log->pending_count < FLASH_LOG_PAGE_ENTRIES) return;
+
+  // Início de setor: apaga-o se tiver qualquer coisa gravada (as medições
+  // mais antigas, ou os restos de um apagamento interrompido). No meio do
+  // setor, pula páginas com restos de uma gravação interrompida.
+  uint32_t page = log->next_page;
+  for (;;) {
+    if (page % FLASH_LOG_PAGES_PER_SECTOR == 0) {
+      uint32_t sector_offset = page_offset(page);
+      if (!is_blank(sector_offset, HAL_FLASH_SECTOR_SIZE)) {
+        hal_flash_erase_sector(sector_offset);
+        log->sectors_erased++;
+      }
+    }
+    if (is_blank(page_offset(page), HAL_FLASH_PAGE_SIZE)) break;
+    log->pages_skipped++;
+    page = (page + 1) % FLASH_LOG_PAGES;
+  }
+
+  static flash_log_page_t data;
+  memset(&data, 0, sizeof(data));
+  data.sequence = log->next_sequence;
+  data.magic = FLASH_LOG_MAGIC;
+  data.version = FLASH_LOG_VERSION;
+  data.count = FLASH_LOG_PAGE_ENTRIES;
+  memcpy(data.entries, log->pending, sizeof(data.entries));
+  data.crc = page_crc(&data);
+  data.reserved = 0xFFFFFFFFu;
+
+  hal_flash_program(page_offset(page), &data, sizeof(data));
+
+  log->next_page = (page + 1) % FLASH_LOG_PAGES;
+  log->next_sequence++;
+  log->empty = false;
+  log->pending_count = 0;
+  log->pages_written++;
+}
+
+void flash_log_cursor_init(const flash_log_t *log, flash_log_cursor_t *cursor) {
+  memset(cursor, 0, sizeof(*cursor));
+  cursor->end_sequence = log->next_sequence;
+
+  // As medições mais antigas começam no setor seguinte ao da página mais
+  // recente; o setor dela é lido por último
+  if (!log->empty) {
+    uint32_t newest = (log->next_page + FLASH_LOG_PAGES - 1) % FLASH_LOG_PAGES;
+    cursor->page = (page_sector(newest) + 1) % FLASH_LOG_SECTORS * FLASH_LOG_PAGES_PER_SECTOR;
+    cursor->pages_left = FLASH_LOG_PAGES;
+  }
+}
+
+// Carrega a próxima página válida em ordem de sequência
+static bool next_page(flash_log_cursor_t *cursor) {
+  static flash_log_page_t data;
+
+  while (cursor->pages_left) {
+    uint32_t page = cursor->page;
+    cursor->page = (page + 1) % FLASH_LOG_PAGES;
+    cursor->pages_left--;
+
+    if (!read_page(page, &data) || data.sequence >= cursor->end_sequence) continue;
+    if (cursor->has_last && data.sequence <= cursor->last_sequence) continue;
+
+    cursor->last_sequence = data.sequence;
+    cursor->has_last = true;
+    cursor->count = data.count;
+    cursor->entry = 0;
+    memcpy(cursor->entries, data.entries, sizeof(cursor->entries));
+    return true;
+  }
+  return false;
+}
+
+bool flash_log_next(const flash_log_t *log, flash_log_cursor_t *cursor, telemetry_sample_t *sample) {
+  const flash_log_entry_t *entry;
+  uint32_t sequence;
+
+  if (!cursor->in_ram && cursor->entry == cursor->count && !next_page(cursor)) {
+    // Flash lida: seguem as medições da RAM, com a sequência da próxima página
+    cursor->in_ram = true;
+    cursor->entry = 0;
+  }
+
+  if (cursor->in_ram) {
+    if (cursor->entry >= log->pending_count) return false;
+    entry = &log->pending[cursor->entry];
+    sequence = log->next_sequence * FLASH_LOG_PAGE_ENTRIES + cursor->entry;
+  } else {
+    entry = &cursor->entries[cursor->entry];
+    sequence = cursor->last_sequence * FLASH_LOG_PAGE_ENTRIES + cursor->entry;
+  }
+  cursor->entry++;
+
+  memset(sample, 0, sizeof(*sample));
+  sample->type = TELEMETRY_RECORD_LOG;
+  sample->range = entry->range;
+  sample->sequence = (uint16_t)sequence;
+  sample->timestamp_ms = entry->timestamp_ms;
+  sample->adc_mean_q16 = entry->adc_mean_q16;
+  sample->sample_count = entry->sample_count;
+  sample->resistance_milliohms = entry->resistance_milliohms;
+  sample->closest = entry->closest;
+  sample->series = entry->series;
+  return true;
+}
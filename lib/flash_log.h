@@ -0,0 +1,96 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hal.h"
+#include "telemetry_frame.h"
+
+// Registro circular das medições nos setores reservados da flash, depois do
+// setor da calibração. As medições se acumulam na RAM e são gravadas uma
+// página inteira por vez; cada página leva a sua sequência e um CRC-32:
+//
+//   off  tipo  campo
+//    0   u32   sequência da página (cresce a cada página gravada)
+//    4   u16   FLASH_LOG_MAGIC
+//    6   u8    FLASH_LOG_VERSION
+//    7   u8    medições na página (FLASH_LOG_PAGE_ENTRIES)
+//    8   24 B  medições (flash_log_entry_t)
+//  248   u32   CRC-32 dos bytes 0 a 247
+//
+// As páginas são gravadas em sequência pelos setores do registro, e o setor
+// seguinte só é apagado quando chega a vez dele, o que distribui o desgaste
+// por todos os setores e descarta sempre as medições mais antigas.
+//
+// Recuperação após falta de energia: na partida vale a página válida de maior
+// sequência. Uma página gravada pela metade falha no CRC e é pulada, e um
+// setor apagado pela metade volta a ser apagado antes do uso. A leitura segue
+// a ordem das sequências, ignorando restos de voltas anteriores.
+//
+// O módulo só usa hal_flash_*, que no RP2040 já param o outro núcleo e as
+// interrupções durante a gravação, e roda também no host.
+
+#define FLASH_LOG_OFFSET HAL_FLASH_SECTOR_SIZE // Depois da calibração
+#define FLASH_LOG_SECTORS (HAL_FLASH_RESERVED_SECTORS - 1)
+#define FLASH_LOG_PAGES_PER_SECTOR (HAL_FLASH_SECTOR_SIZE / HAL_FLASH_PAGE_SIZE)
+#define FLASH_LOG_PAGES (FLASH_LOG_SECTORS * FLASH_LOG_PAGES_PER_SECTOR)
+
+#define FLASH_LOG_MAGIC 0x4C4F // "OL"
+#define FLASH_LOG_VERSION 1
+#define FLASH_LOG_PAGE_ENTRIES 10
+
+// Medição guardada: os campos da telemetria, exceto a variância
+typedef struct {
+  uint32_t timestamp_ms;
+  uint32_t adc_mean_q16;
+  uint64_t resistance_milliohms;
+  eseries_value_t closest;
+  uint16_t sample_count; // Saturado em UINT16_MAX
+  uint8_t range;
+  uint8_t series;
+} flash_log_entry_t;
+
+typedef struct {
+  uint32_t next_page;      // Próxima página a gravar (0 a FLASH_LOG_PAGES - 1)
+  uint32_t next_sequence;  // Sequência da próxima página
+  bool empty;              // Nenhuma página válida na flash
+  flash_log_entry_t pending[FLASH_LOG_PAGE_ENTRIES]; // Página em montagem na RAM
+  uint8_t pending_count;
+  uint32_t pages_written;  // Desde flash_log_mount
+  uint32_t sectors_erased;
+  uint32_t pages_skipped;  // Páginas com restos de gravação interrompida
+} flash_log_t;
+
+// Leitura das medições da mais antiga à mais recente, incluindo as da RAM
+typedef struct {
+  uint32_t page;           // Próxima página a examinar
+  uint32_t pages_left;
+  uint32_t last_sequence;  // Sequência da última página lida
+  uint32_t end_sequence;   // Páginas gravadas depois do início são ignoradas
+  bool has_last;
+  uint8_t entry;           // Próxima medição da página atual
+  uint8_t count;           // Medições da página atual
+  flash_log_entry_t entries[FLASH_LOG_PAGE_ENTRIES];
+  bool in_ram;             // Já nas medições ainda não gravadas
+} flash_log_cursor_t;
+
+// Procura na flash a página mais recente; a próxima gravação vem depois dela.
+// As medições da RAM são descartadas.
+void flash_log_mount(flash_log_t *log);
+
+// Acrescenta a medição à página na RAM. Retorna true quando a página fica
+// completa: flash_log_commit deve ser chamada antes da próxima medição, que
+// do contrário substitui a última da página.
+bool flash_log_append(flash_log_t *log, const telemetry_sample_t *sample);
+
+// Grava a página completa da RAM, apagando antes o setor se for a vez dele.
+// Com a página incompleta, não faz nada.
+void flash_log_commit(flash_log_t *log);
+
+void flash_log_cursor_init(const flash_log_t *log, flash_log_cursor_t *cursor);
+
+// Próxima medição, como registro TELEMETRY_RECORD_LOG. A sequência é a da
+// medição no registro (truncada em 16 bits); lacunas indicam páginas perdidas.
+bool flash_log_next(const flash_log_t *log, flash_log_cursor_t *cursor, telemetry_sample_t *sample);
+
+#endif
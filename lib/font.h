@@ -1,4 +1,4 @@
-static uint8_t font[] = {
+static const uint8_t font[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
     0x00, 0x00, 0x00, 0x5F, 0x5F, 0x00, 0x00, 0x00, // !
     0x00, 0x07, 0x07, 0x00, 0x07, 0x07, 0x00, 0x00, // "
@@ -99,5 +99,5 @@ static uint8_t font[] = {
     0x00, 0x00, 0x00, 0x77, 0x77, 0x00, 0x00, 0x00, // |
     0x00, 0x41, 0x41, 0x77, 0x3E, 0x08, 0x08, 0x00, // }
     0x02, 0x03, 0x01, 0x03, 0x02, 0x03, 0x01, 0x00, // ~
-    0x3E, 0x41, 0x41, 0x41, 0x22, 0x1C, 0x00, 0x00  // Ω
+    0x4C, 0x52, 0x61, 0x01, 0x61, 0x52, 0x4C, 0x00  // Ω (0x7F)
   };
@@ -0,0 +1,195 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Camada de abstração de hardware. O firmware usa a implementação em
+// hal_pico.c; a placa virtual (OHMIMETRO_HOST) usa os backends simulados de
+// host/hal_sim.c, permitindo rodar o pipeline completo no Linux.
+
+#ifdef OHMIMETRO_HOST
+typedef unsigned int uint;
+#endif
+
+// -----------------------------------------------------------------------------
+// Tempo
+// -----------------------------------------------------------------------------
+
+uint64_t hal_time_us(void);
+uint32_t hal_time_ms(void);
+void hal_sleep_us(uint64_t us);
+void hal_sleep_ms(uint32_t ms);
+
+// Contador de ciclos do núcleo que chama, crescente, com os bits de
+// HAL_CYCLES_MASK (as diferenças devem ser mascaradas). No RP2040 é o
+// SysTick a 125 MHz, que dá a volta a cada 134 ms; na placa virtual, o tempo
+// virtual somado ao tempo de CPU do host, nos mesmos 125 ciclos por us.
+#define HAL_CYCLES_PER_US 125
+#define HAL_CYCLES_MASK 0xFFFFFFu
+
+uint32_t hal_cycles(void);
+
+// Aguarda a próxima interrupção ou um sinal do outro núcleo (WFE no RP2040).
+// Pode retornar antes do esperado; quem chama deve reavaliar a condição.
+void hal_idle_wait(void);
+
+// Acorda o outro núcleo se ele estiver em hal_idle_wait (SEV no RP2040).
+void hal_wake(void);
+
+// Arma um alarme de hardware que acorda hal_idle_wait do núcleo que chamou
+// no instante `t_us` de hal_time_us. Substitui o alarme anterior do núcleo;
+// um instante já passado acorda a próxima espera imediatamente.
+void hal_alarm_wake_at(uint64_t t_us);
+
+// -----------------------------------------------------------------------------
+// Multicore
+// -----------------------------------------------------------------------------
+
+// Inicia `entry` no núcleo 1. Na placa virtual os dois núcleos alternam de
+// forma cooperativa a cada hal_idle_wait.
+void hal_core1_launch(void (*entry)(void));
+
+// -----------------------------------------------------------------------------
+// GPIO
+// -----------------------------------------------------------------------------
+
+// Chamado na borda de descida de um pino configurado com hal_gpio_irq_enable.
+typedef void (*hal_gpio_irq_cb_t)(uint gpio, uint32_t events);
+
+void hal_gpio_input_pullup(uint gpio);
+
+// Nível atual do pino (true em nível alto).
+bool hal_gpio_read(uint gpio);
+
+// Saída em nível `high` (3,3 V) ou baixo.
+void hal_gpio_output(uint gpio, bool high);
+
+// Entrada sem pull-up/pull-down: o pino fica em alta impedância.
+void hal_gpio_float(uint gpio);
+void hal_gpio_irq_enable(uint gpio, hal_gpio_irq_cb_t cb);
+
+// Reinicia no modo BOOTSEL (USB mass storage).
+void hal_reset_to_bootloader(void);
+
+// -----------------------------------------------------------------------------
+// I2C
+// -----------------------------------------------------------------------------
+
+void hal_i2c_init(uint8_t port, uint32_t baud, uint sda, uint scl);
+
+// Escrita bloqueante. Aguarda antes o término de uma escrita assíncrona.
+void hal_i2c_write(uint8_t port, uint8_t address, const uint8_t *src, size_t len);
+
+// Chamado ao fim de uma escrita assíncrona (contexto de IRQ no RP2040).
+typedef void (*hal_i2c_done_cb_t)(void *ctx);
+
+// Maior transação aceita por hal_i2c_write_async
+#define HAL_I2C_ASYNC_MAX 1200
+
+// Inicia uma escrita por DMA e retorna imediatamente. `src` é copiado antes
+// do retorno e pode ser reutilizado. Retorna false se houver outra em curso.
+bool hal_i2c_write_async(uint8_t port, uint8_t address, const uint8_t *src, size_t len,
+                         hal_i2c_done_cb_t cb, void *ctx);
+bool hal_i2c_busy(uint8_t port);
+
+// -----------------------------------------------------------------------------
+// PIO (programa ws2818b da matriz de LEDs)
+// -----------------------------------------------------------------------------
+
+void hal_ws2818b_init(uint pin);
+
+// Envia `count` palavras (GRB nos bits 31..8) por DMA e retorna imediatamente.
+// O buffer deve permanecer válido até hal_ws2818b_busy() retornar false, o
+// que acontece depois do intervalo de RESET que trava as cores nos LEDs.
+bool hal_ws2818b_write(const uint32_t *words, size_t count);
+bool hal_ws2818b_busy(void);
+
+// -----------------------------------------------------------------------------
+// ADC em modo free-running alimentando um anel de blocos via DMA
+// -----------------------------------------------------------------------------
+
+// Chamada a cada bloco completo do anel. No RP2040 roda em contexto de IRQ.
+typedef void (*hal_adc_block_cb_t)(const uint16_t *samples, size_t count);
+
+// Configura a entrada (0-3), a taxa de amostragem e o anel de `block_count`
+// blocos de `block_len` amostras. O anel precisa de pelo menos 2 blocos.
+void hal_adc_stream_init(uint8_t input, uint32_t sample_rate_hz, uint16_t *ring,
+                         size_t block_len, size_t block_count, hal_adc_block_cb_t cb);
+void hal_adc_stream_start(void);
+void hal_adc_stream_stop(void);
+
+// Round-robin: a partir do próximo hal_adc_stream_start, o ADC converte em
+// sequência as entradas de `mask` (bit n = entrada n, incluindo a de
+// hal_adc_stream_init), em ordem crescente e com volta, começando sempre pela
+// entrada de hal_adc_stream_init. O anel recebe as amostras intercaladas, sem
+// indicação da entrada. Máscara 0 (o padrão) converte só a entrada inicial.
+void hal_adc_stream_set_round_robin(uint8_t mask);
+
+// -----------------------------------------------------------------------------
+// Serial USB (CDC)
+// -----------------------------------------------------------------------------
+
+// Escreve até `len` bytes sem bloquear e retorna quantos foram aceitos (0 sem
+// host conectado ou com o buffer da USB cheio). Divide a porta com o stdio.
+size_t hal_usb_write(const uint8_t *src, size_t len);
+
+// Lê até `len` bytes recebidos sem bloquear e retorna quantos foram lidos.
+size_t hal_usb_read(uint8_t *dst, size_t len);
+
+// -----------------------------------------------------------------------------
+// Flash: setores reservados no fim da memória para dados persistentes
+// -----------------------------------------------------------------------------
+
+#define HAL_FLASH_SECTOR_SIZE 4096
+#define HAL_FLASH_PAGE_SIZE 256
+
+// Setores reservados (calibração e registro das medições); os offsets abaixo
+// contam a partir do primeiro deles
+#define HAL_FLASH_RESERVED_SECTORS 16
+#define HAL_FLASH_RESERVED_SIZE (HAL_FLASH_RESERVED_SECTORS * HAL_FLASH_SECTOR_SIZE)
+
+void hal_flash_read(uint32_t offset, void *dst, size_t len);
+
+// Apaga (preenche com 0xFF) o setor que começa em `offset`.
+void hal_flash_erase_sector(uint32_t offset);
+
+// Grava `len` bytes em área apagada. Como na NOR, a gravação só leva bits de
+// 1 a 0; os demais bytes das páginas tocadas não mudam. No RP2040 o outro
+// núcleo e as interrupções ficam parados durante a operação (alguns ms).
+//
+// Apagar e gravar exigem o fluxo do ADC parado (hal_adc_stream_stop): sem a
+// interrupção do DMA os canais não são rearmados e o anel seria sobrescrito.
+void hal_flash_program(uint32_t offset, const void *src, size_t len);
+
+#ifdef OHMIMETRO_HOST
+// -----------------------------------------------------------------------------
+// Controles exclusivos da placa virtual
+// -----------------------------------------------------------------------------
+
+// Fonte de amostras do ADC simulado: retorna o código (0-4095) lido na
+// entrada `input` no instante `t_us`.
+typedef uint16_t (*hal_sim_adc_source_t)(uint8_t input, uint64_t t_us);
+
+void hal_sim_adc_set_source(hal_sim_adc_source_t source);
+
+// Simula a conclusão de `blocks` transferências DMA, entregando cada bloco ao
+// callback registrado como faria a IRQ do DMA.
+void hal_sim_adc_pump(size_t blocks);
+
+// Simula o pressionamento de um botão (borda de descida).
+void hal_sim_gpio_press(uint gpio);
+
+// Liga `gpio` ao nó do divisor (entrada do ADC) por um resistor de `ohms`.
+// Sem nenhum pino ligado, o divisor usa OHMIMETRO_SIM_RREF fixo em 3,3 V.
+// As demais entradas do ADC leem o trilho de 3,3 V que alimenta o divisor por
+// um divisor 1:2 (a referência do modo ratiométrico).
+void hal_sim_divider_attach(uint gpio, double ohms);
+
+// O mesmo para o divisor de outra entrada do ADC (0 a 2), a do gabarito
+// multicanal; hal_sim_divider_attach liga à entrada 2 (ADC_PIN).
+void hal_sim_channel_attach(uint8_t input, uint gpio, double ohms);
+#endif
+
+#endif
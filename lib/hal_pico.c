@@ -0,0 +1,506 @@
+#include <string.h>
+#include "hal.h"
+#include "pico/stdlib.h"
+#include "pico/bootrom.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "pico/stdio_usb.h"
+#include "pico/stdio/driver.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/structs/systick.h"
+#include "tusb.h"
+
+// Biblioteca gerada pelo arquivo .pio durante compilação.
+#include "ws2818b.pio.h"
+
+// -----------------------------------------------------------------------------
+// Tempo
+// -----------------------------------------------------------------------------
+
+uint64_t hal_time_us(void) {
+  return time_us_64();
+}
+
+uint32_t hal_time_ms(void) {
+  return to_ms_since_boot(get_absolute_time());
+}
+
+uint32_t hal_cycles(void) {
+  // O SysTick é de cada núcleo e começa desligado: o primeiro uso em cada
+  // núcleo o liga em contagem livre pelo clock do processador
+  if (!(systick_hw->csr & M0PLUS_SYST_CSR_ENABLE_BITS)) {
+    systick_hw->rvr = HAL_CYCLES_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+  }
+
+  // O SysTick conta para baixo
+  return HAL_CYCLES_MASK - systick_hw->cvr;
+}
+
+void hal_sleep_us(uint64_t us) {
+  sleep_us(us);
+}
+
+void hal_sleep_ms(uint32_t ms) {
+  sleep_ms(ms);
+}
+
+void hal_idle_wait(void) {
+  // WFE acorda tanto com interrupções tomadas quanto com o SEV do outro núcleo
+  __wfe();
+}
+
+void hal_wake(void) {
+  __sev();
+}
+
+// Um alarme de hardware por núcleo: a IRQ do alarme vai para o núcleo que o
+// configurou, e a própria interrupção tira o núcleo do WFE
+static int wake_alarm[2] = {-1, -1};
+
+static void wake_alarm_fired(uint alarm_num) {
+  (void)alarm_num;
+}
+
+void hal_alarm_wake_at(uint64_t t_us) {
+  uint core = get_core_num();
+
+  if (wake_alarm[core] < 0) {
+    wake_alarm[core] = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(wake_alarm[core], wake_alarm_fired);
+  }
+
+  // Instante já passado: o alarme não dispara, então marca o evento do WFE
+  if (hardware_alarm_set_target(wake_alarm[core], from_us_since_boot(t_us)))
+    __sev();
+}
+
+// -----------------------------------------------------------------------------
+// Multicore
+// -----------------------------------------------------------------------------
+
+static void (*core1_entry)(void);
+
+// O núcleo 1 aceita ser pausado por flash_safe_execute antes de rodar a
+// aplicação: ele executa da flash, que fica inacessível durante a gravação
+static void core1_trampoline(void) {
+  flash_safe_execute_core_init();
+  core1_entry();
+}
+
+void hal_core1_launch(void (*entry)(void)) {
+  core1_entry = entry;
+  multicore_launch_core1(core1_trampoline);
+}
+
+// -----------------------------------------------------------------------------
+// GPIO
+// -----------------------------------------------------------------------------
+
+static hal_gpio_irq_cb_t gpio_irq_cb;
+
+static void gpio_irq_dispatch(uint gpio, uint32_t events) {
+  if (gpio_irq_cb) gpio_irq_cb(gpio, events);
+}
+
+void hal_gpio_input_pullup(uint gpio) {
+  gpio_init(gpio);
+  gpio_set_dir(gpio, GPIO_IN);
+  gpio_pull_up(gpio);
+}
+
+bool hal_gpio_read(uint gpio) {
+  return gpio_get(gpio);
+}
+
+void hal_gpio_output(uint gpio, bool high) {
+  gpio_init(gpio);
+  gpio_put(gpio, high);
+  gpio_set_dir(gpio, GPIO_OUT);
+}
+
+void hal_gpio_float(uint gpio) {
+  gpio_init(gpio);
+  gpio_set_dir(gpio, GPIO_IN);
+  gpio_disable_pulls(gpio);
+}
+
+void hal_gpio_irq_enable(uint gpio, hal_gpio_irq_cb_t cb) {
+  // O RP2040 tem um único callback de GPIO por núcleo
+  gpio_irq_cb = cb;
+  gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_dispatch);
+}
+
+void hal_reset_to_bootloader(void) {
+  reset_usb_boot(0, 0);
+}
+
+// -----------------------------------------------------------------------------
+// I2C
+// -----------------------------------------------------------------------------
+
+static i2c_inst_t *i2c_from_port(uint8_t port) {
+  return port ? i2c1 : i2c0;
+}
+
+void hal_i2c_init(uint8_t port, uint32_t baud, uint sda, uint scl) {
+  i2c_init(i2c_from_port(port), baud);
+
+  gpio_set_function(sda, GPIO_FUNC_I2C);
+  gpio_set_function(scl, GPIO_FUNC_I2C);
+  gpio_pull_up(sda);
+  gpio_pull_up(scl);
+}
+
+// Escrita assíncrona: cada byte vira uma palavra do registrador IC_DATA_CMD
+// (o último com STOP) e o DMA alimenta o FIFO TX no ritmo do DREQ do I2C.
+static uint16_t i2c_dma_cmds[HAL_I2C_ASYNC_MAX];
+static int i2c_dma_chan = -1;
+static volatile bool i2c_dma_busy;
+static hal_i2c_done_cb_t i2c_done_cb;
+static void *i2c_done_ctx;
+
+static void i2c_dma_irq_handler(void) {
+  if (i2c_dma_chan < 0 || !dma_channel_get_irq0_status(i2c_dma_chan)) return;
+  dma_channel_acknowledge_irq0(i2c_dma_chan);
+
+  i2c_dma_busy = false;
+  if (i2c_done_cb) i2c_done_cb(i2c_done_ctx);
+  __sev();
+}
+
+// O DMA termina ao pôr o último byte no FIFO TX, antes de ele sair no
+// barramento: desabilitar o controlador antes disso corta a transação
+static void i2c_wait_idle(i2c_hw_t *hw) {
+  while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS))
+    tight_loop_contents();
+}
+
+void hal_i2c_write(uint8_t port, uint8_t address, const uint8_t *src, size_t len) {
+  while (i2c_dma_busy)
+    tight_loop_contents();
+
+  // i2c_write_blocking desabilita o controlador para trocar o endereço
+  i2c_wait_idle(i2c_get_hw(i2c_from_port(port)));
+  i2c_write_blocking(i2c_from_port(port), address, src, len, false);
+}
+
+bool hal_i2c_write_async(uint8_t port, uint8_t address, const uint8_t *src, size_t len,
+                         hal_i2c_done_cb_t cb, void *ctx) {
+  if (i2c_dma_busy || len == 0 || len > HAL_I2C_ASYNC_MAX) return false;
+
+  i2c_inst_t *i2c = i2c_from_port(port);
+  i2c_hw_t *hw = i2c_get_hw(i2c);
+
+  if (i2c_dma_chan < 0) {
+    i2c_dma_chan = dma_claim_unused_channel(true);
+    dma_channel_set_irq0_enabled(i2c_dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_0, i2c_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+  }
+
+  // Trocar o endereço do escravo exige o controlador desabilitado e ocioso;
+  // com o mesmo endereço a nova transação apenas entra na fila do FIFO
+  if (hw->tar != address) {
+    i2c_wait_idle(hw);
+    hw->enable = 0;
+    hw->tar = address;
+    hw->enable = 1;
+  }
+
+  for (size_t i = 0; i < len; ++i)
+    i2c_dma_cmds[i] = src[i];
+  i2c_dma_cmds[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  i2c_done_cb = cb;
+  i2c_done_ctx = ctx;
+  i2c_dma_busy = true;
+
+  dma_channel_config c = dma_channel_get_default_config(i2c_dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+  dma_channel_configure(i2c_dma_chan, &c, &hw->data_cmd, i2c_dma_cmds, len, true);
+
+  return true;
+}
+
+bool hal_i2c_busy(uint8_t port) {
+  (void)port;
+  return i2c_dma_busy;
+}
+
+// -----------------------------------------------------------------------------
+// PIO (ws2818b)
+// -----------------------------------------------------------------------------
+
+// Após o DMA entregar a última palavra ainda restam até 8 palavras no FIFO
+// (TX unido) a 30 us cada, seguidas do RESET de 100 us do datasheet
+#define WS2818B_RESET_US (8 * 24 * 5 / 4 + 100)
+
+static PIO np_pio;
+static uint np_sm;
+static int np_dma_chan = -1;
+static volatile bool np_busy;
+
+static int64_t np_reset_done(alarm_id_t id, void *user_data) {
+  (void)id;
+  (void)user_data;
+  np_busy = false;
+  __sev(); // npWrite pode estar aguardando no outro núcleo
+  return 0;
+}
+
+static void np_dma_irq_handler(void) {
+  if (!dma_channel_get_irq0_status(np_dma_chan)) return;
+  dma_channel_acknowledge_irq0(np_dma_chan);
+
+  // O intervalo de RESET é contado por alarme em vez de sleep_us
+  add_alarm_in_us(WS2818B_RESET_US, np_reset_done, NULL, true);
+}
+
+void hal_ws2818b_init(uint pin) {
+  // Cria programa PIO.
+  uint offset = pio_add_program(pio0, &ws2818b_program);
+  np_pio = pio0;
+
+  // Toma posse de uma máquina PIO.
+  int sm = pio_claim_unused_sm(np_pio, false);
+  if (sm < 0) {
+    np_pio = pio1;
+    offset = pio_add_program(np_pio, &ws2818b_program);
+    sm = pio_claim_unused_sm(np_pio, true); // Se nenhuma máquina estiver livre, panic!
+  }
+  np_sm = (uint)sm;
+
+  // Inicia programa na máquina PIO obtida.
+  ws2818b_program_init(np_pio, np_sm, offset, pin, 800000.f);
+
+  np_dma_chan = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(np_dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, pio_get_dreq(np_pio, np_sm, true));
+  dma_channel_configure(np_dma_chan, &c, &np_pio->txf[np_sm], NULL, 0, false);
+
+  dma_channel_set_irq0_enabled(np_dma_chan, true);
+  irq_add_shared_handler(DMA_IRQ_0, np_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_0, true);
+}
+
+bool hal_ws2818b_write(const uint32_t *words, size_t count) {
+  if (np_busy) return false;
+
+  np_busy = true;
+  dma_channel_transfer_from_buffer_now(np_dma_chan, words, count);
+  return true;
+}
+
+bool hal_ws2818b_busy(void) {
+  return np_busy;
+}
+
+// -----------------------------------------------------------------------------
+// ADC + DMA
+// -----------------------------------------------------------------------------
+
+// Dois canais DMA encadeados em ping-pong: enquanto um preenche o bloco
+// atual, o outro já está armado para o próximo, então não há lacunas entre
+// blocos mesmo com a IRQ atrasada.
+static int adc_dma_chan[2] = {-1, -1};
+static uint8_t adc_input;
+static uint8_t adc_round_robin_mask;
+static uint16_t *adc_ring;
+static size_t adc_block_len;
+static size_t adc_block_count;
+static size_t adc_next_block;
+static hal_adc_block_cb_t adc_block_cb;
+
+static void adc_dma_irq_handler(void) {
+  for (int k = 0; k < 2; ++k) {
+    uint chan = adc_dma_chan[k];
+
+    if (!dma_channel_get_irq1_status(chan)) continue;
+    dma_channel_acknowledge_irq1(chan);
+
+    // Ao final da transferência o endereço de escrita aponta para o fim do bloco
+    const uint16_t *done = (const uint16_t *)dma_channel_hw_addr(chan)->write_addr - adc_block_len;
+
+    // Rearma o canal para o próximo bloco livre do anel (sem disparar: o
+    // encadeamento com o outro canal faz isso)
+    dma_channel_set_write_addr(chan, adc_ring + adc_next_block * adc_block_len, false);
+    dma_channel_set_trans_count(chan, adc_block_len, false);
+    adc_next_block = (adc_next_block + 1) % adc_block_count;
+
+    if (adc_block_cb) adc_block_cb(done, adc_block_len);
+  }
+}
+
+void hal_adc_stream_init(uint8_t input, uint32_t sample_rate_hz, uint16_t *ring,
+                         size_t block_len, size_t block_count, hal_adc_block_cb_t cb) {
+  adc_input = input;
+  adc_ring = ring;
+  adc_block_len = block_len;
+  adc_block_count = block_count;
+  adc_block_cb = cb;
+
+  adc_init();
+  adc_gpio_init(26 + input);
+  adc_select_input(input);
+
+  // FIFO habilitado, DREQ a cada amostra, sem bit de erro e sem deslocar para 8 bits
+  adc_fifo_setup(true, true, 1, false, false);
+
+  // Uma conversão a cada (1 + div) ciclos do clock de 48 MHz do ADC
+  adc_set_clkdiv(48000000.f / sample_rate_hz - 1.f);
+
+  for (int k = 0; k < 2; ++k)
+    adc_dma_chan[k] = dma_claim_unused_channel(true);
+
+  for (int k = 0; k < 2; ++k) {
+    uint chan = adc_dma_chan[k];
+    dma_channel_config c = dma_channel_get_default_config(chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, adc_dma_chan[k ^ 1]);
+
+    dma_channel_configure(chan, &c, ring + k * block_len, &adc_hw->fifo, block_len, false);
+  }
+
+  irq_set_exclusive_handler(DMA_IRQ_1, adc_dma_irq_handler);
+  irq_set_enabled(DMA_IRQ_1, true);
+}
+
+void hal_adc_stream_start(void) {
+  for (int k = 0; k < 2; ++k) {
+    dma_channel_set_write_addr(adc_dma_chan[k], adc_ring + k * adc_block_len, false);
+    dma_channel_set_trans_count(adc_dma_chan[k], adc_block_len, false);
+    dma_channel_set_irq1_enabled(adc_dma_chan[k], true);
+  }
+  adc_next_block = 2 % adc_block_count;
+
+  // O round-robin avança a entrada a cada conversão; a sequência recomeça
+  // pela entrada inicial, em qualquer ponto em que a anterior tenha parado
+  adc_select_input(adc_input);
+  adc_set_round_robin(adc_round_robin_mask);
+  adc_fifo_drain();
+  dma_channel_start(adc_dma_chan[0]);
+  adc_run(true);
+}
+
+void hal_adc_stream_stop(void) {
+  adc_run(false);
+
+  // RP2040-E13: o abort pode levantar a IRQ de fim de um canal pela metade, e
+  // o handler entregaria um bloco incompleto (ou de antes do anel). As IRQs
+  // ficam desligadas durante o abort e as pendentes são descartadas
+  for (int k = 0; k < 2; ++k)
+    dma_channel_set_irq1_enabled(adc_dma_chan[k], false);
+  for (int k = 0; k < 2; ++k)
+    dma_channel_abort(adc_dma_chan[k]);
+  for (int k = 0; k < 2; ++k)
+    dma_channel_acknowledge_irq1(adc_dma_chan[k]);
+  adc_fifo_drain();
+}
+
+void hal_adc_stream_set_round_robin(uint8_t mask) {
+  for (uint input = 0; input < 4; ++input)
+    if (mask & (1u << input)) adc_gpio_init(26 + input);
+  adc_round_robin_mask = mask;
+}
+
+// -----------------------------------------------------------------------------
+// Serial USB (CDC)
+// -----------------------------------------------------------------------------
+
+// A mesma interface CDC do pico_stdio_usb. O TinyUSB é atendido pela IRQ do
+// stdio e o printf usa os mesmos FIFOs, ambos sob o mutex do driver
+// stdio_usb: a escrita e a leitura passam pelo driver para tomá-lo também.
+// Só se escreve o que cabe no FIFO de transmissão; lido fora do mutex, o
+// espaço livre só pode ter crescido, porque a IRQ apenas esvazia o FIFO e o
+// printf roda no mesmo núcleo, entre as tarefas
+size_t hal_usb_write(const uint8_t *src, size_t len) {
+  if (!stdio_usb_connected()) return 0;
+
+  uint32_t available = tud_cdc_write_available();
+  if (len > available) len = available;
+  if (len == 0) return 0;
+
+  stdio_usb.out_chars((const char *)src, (int)len);
+  return len;
+}
+
+size_t hal_usb_read(uint8_t *dst, size_t len) {
+  if (!stdio_usb_connected()) return 0;
+
+  int count = stdio_usb.in_chars((char *)dst, (int)len);
+  return count > 0 ? (size_t)count : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Flash
+// -----------------------------------------------------------------------------
+
+// Início da área reservada, relativo ao início da flash
+#define FLASH_RESERVED_BASE (PICO_FLASH_SIZE_BYTES - HAL_FLASH_RESERVED_SIZE)
+
+#define FLASH_SAFE_TIMEOUT_MS 100
+
+typedef struct {
+  uint32_t offset;
+  const uint8_t *src;
+  size_t len;
+} flash_op_t;
+
+static void flash_erase_op(void *param) {
+  const flash_op_t *op = param;
+  flash_range_erase(FLASH_RESERVED_BASE + op->offset, HAL_FLASH_SECTOR_SIZE);
+}
+
+// Grava página a página: o SDK exige páginas inteiras vindas da RAM, então
+// cada uma é completada com 0xFF, que não altera o conteúdo já gravado
+static void flash_program_op(void *param) {
+  const flash_op_t *op = param;
+  static uint8_t page[HAL_FLASH_PAGE_SIZE];
+  uint32_t offset = op->offset;
+  size_t done = 0;
+
+  while (done < op->len) {
+    uint32_t page_start = offset & ~(uint32_t)(HAL_FLASH_PAGE_SIZE - 1);
+    size_t skip = offset - page_start;
+    size_t chunk = HAL_FLASH_PAGE_SIZE - skip;
+    if (chunk > op->len - done) chunk = op->len - done;
+
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page + skip, op->src + done, chunk);
+    flash_range_program(FLASH_RESERVED_BASE + page_start, page, HAL_FLASH_PAGE_SIZE);
+
+    offset += chunk;
+    done += chunk;
+  }
+}
+
+void hal_flash_read(uint32_t offset, void *dst, size_t len) {
+  memcpy(dst, (const void *)(XIP_BASE + FLASH_RESERVED_BASE + offset), len);
+}
+
+void hal_flash_erase_sector(uint32_t offset) {
+  flash_op_t op = {offset, NULL, 0};
+  flash_safe_execute(flash_erase_op, &op, FLASH_SAFE_TIMEOUT_MS);
+}
+
+void hal_flash_program(uint32_t offset, const void *src, size_t len) {
+  flash_op_t op = {offset, src, len};
+  flash_safe_execute(flash_program_op, &op, FLASH_SAFE_TIMEOUT_MS);
+}
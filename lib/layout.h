@@ -0,0 +1,16 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "ssd1306.h"
+
+// Elementos estáticos da tela. Não são desenhados em tempo de execução pelo
+// firmware: host/gen_layout.c os renderiza uma vez e grava o resultado em
+// layout_bitmap.h, que fica em flash e é copiado para o quadro a cada ciclo.
+
+// Contorno da tela, ícone do resistor e setas para as legendas das bandas
+void draw_display_layout(ssd1306_t *ssd_ptr);
+
+// Rótulos fixos (tolerância)
+void draw_static_labels(ssd1306_t *ssd_ptr);
+
+#endif
@@ -0,0 +1,134 @@
+// Gerado por host/gen_layout.c a partir de lib/layout.c. Não editar.
+//
+// Quadro estático 128x64 no formato do ram_buffer do SSD1306 (endereçamento
+// vertical: 8 bytes de página por coluna), sem o byte de controle.
+static const uint8_t layout_background[1024] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // x = 0
+  0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, // x = 1
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 2
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 3
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 4
+  0xE2, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 5
+  0x12, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 6
+  0x12, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 7
+  0xF2, 0x9F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x43, // x = 8
+  0xF2, 0x9F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x43, // x = 9
+  0x32, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, // x = 10
+  0x22, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, // x = 11
+  0x22, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, // x = 12
+  0xE2, 0x8F, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x43, // x = 13
+  0xE2, 0x8F, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x43, // x = 14
+  0x22, 0x08, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x43, // x = 15
+  0x22, 0x08, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x43, // x = 16
+  0xE2, 0x8F, 0xFF, 0xFF, 0x0F, 0xC0, 0x00, 0x43, // x = 17
+  0xE2, 0x8F, 0xFF, 0xFF, 0x0F, 0xC0, 0x00, 0x43, // x = 18
+  0x22, 0x08, 0x00, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 19
+  0x32, 0x18, 0x00, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 20
+  0xF2, 0x9F, 0xFF, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 21
+  0xF2, 0x9F, 0xFF, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 22
+  0x12, 0x10, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 23
+  0x12, 0x10, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 24
+  0xE2, 0x0F, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 25
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 26
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 27
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 28
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 29
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 30
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 31
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 32
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 33
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 34
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 35
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 36
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 37
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 38
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 39
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 40
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 41
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 42
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 43
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 44
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 45
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 46
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 47
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 48
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 49
+  0x02, 0x00, 0xF0, 0x03, 0x3F, 0xF0, 0xC3, 0x4F, // x = 50
+  0x02, 0x00, 0xE0, 0x01, 0x1E, 0xE0, 0x81, 0x47, // x = 51
+  0x02, 0x00, 0xC0, 0x00, 0x0C, 0xC0, 0x00, 0x43, // x = 52
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 53
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 54
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 55
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 56
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 57
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 58
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 59
+  0x02, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 60
+  0x02, 0x00, 0xE0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 61
+  0x02, 0x00, 0x30, 0x01, 0x00, 0x00, 0x00, 0x40, // x = 62
+  0x02, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x40, // x = 63
+  0x02, 0x00, 0x30, 0x01, 0x00, 0x00, 0x00, 0x40, // x = 64
+  0x02, 0x00, 0xE0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 65
+  0x02, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 66
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 67
+  0x02, 0x00, 0xC0, 0x03, 0x00, 0x00, 0x00, 0x40, // x = 68
+  0x02, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 69
+  0x02, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 70
+  0x02, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 71
+  0x02, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 72
+  0x02, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 73
+  0x02, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 74
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 75
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 76
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 77
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 78
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 79
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 80
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 81
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 82
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 83
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 84
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 85
+  0x02, 0x00, 0xC0, 0x01, 0x00, 0x00, 0x00, 0x40, // x = 86
+  0x02, 0x00, 0xE0, 0x03, 0x00, 0x00, 0x00, 0x40, // x = 87
+  0x02, 0x00, 0x30, 0x06, 0x00, 0x00, 0x00, 0x40, // x = 88
+  0x02, 0x00, 0x10, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 89
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 90
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 91
+  0x02, 0x00, 0x70, 0x02, 0x00, 0x00, 0x00, 0x40, // x = 92
+  0x02, 0x00, 0x70, 0x06, 0x00, 0x00, 0x00, 0x40, // x = 93
+  0x02, 0x00, 0x50, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 94
+  0x02, 0x00, 0x50, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 95
+  0x02, 0x00, 0x50, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 96
+  0x02, 0x00, 0xD0, 0x07, 0x00, 0x00, 0x00, 0x40, // x = 97
+  0x02, 0x00, 0x90, 0x03, 0x00, 0x00, 0x00, 0x40, // x = 98
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 99
+  0x02, 0x00, 0x60, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 100
+  0x02, 0x00, 0x60, 0x06, 0x00, 0x00, 0x00, 0x40, // x = 101
+  0x02, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x40, // x = 102
+  0x02, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x40, // x = 103
+  0x02, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 104
+  0x02, 0x00, 0x60, 0x06, 0x00, 0x00, 0x00, 0x40, // x = 105
+  0x02, 0x00, 0x20, 0x06, 0x00, 0x00, 0x00, 0x40, // x = 106
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 107
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 108
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 109
+  0x02, 0x00, 0x10, 0x04, 0x00, 0x00, 0x00, 0x40, // x = 110
+  0x02, 0x00, 0x30, 0x06, 0x00, 0x00, 0x00, 0x40, // x = 111
+  0x02, 0x00, 0xE0, 0x03, 0x00, 0x00, 0x00, 0x40, // x = 112
+  0x02, 0x00, 0xC0, 0x01, 0x00, 0x00, 0x00, 0x40, // x = 113
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 114
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 115
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 116
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 117
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 118
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 119
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 120
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 121
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 122
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 123
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 124
+  0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, // x = 125
+  0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, // x = 126
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // x = 127
+};
@@ -0,0 +1,33 @@
+#include "mains_filter.h"
+
+uint8_t mains_filter_window_blocks(uint32_t mains_hz, uint32_t sample_rate_hz, uint32_t block_len) {
+  if (mains_hz == 0) return 1;
+
+  // k blocos duram k * block_len / sample_rate_hz segundos, um número inteiro
+  // de ciclos quando k * block_len * mains_hz é múltiplo de sample_rate_hz
+  for (uint32_t blocks = 1; blocks <= MAINS_FILTER_MAX_BLOCKS; ++blocks)
+    if ((uint64_t)blocks * block_len * mains_hz % sample_rate_hz == 0) return (uint8_t)blocks;
+  return 0;
+}
+
+void mains_filter_init(mains_filter_t *filter, uint8_t window_blocks) {
+  filter->window_blocks = window_blocks ? window_blocks : 1;
+  mains_filter_reset(filter);
+}
+
+void mains_filter_reset(mains_filter_t *filter) {
+  filter->blocks = 0;
+  filter->sum = 0;
+  filter->count = 0;
+}
+
+bool mains_filter_add(mains_filter_t *filter, const acquisition_result_t *block, acquisition_result_t *window) {
+  filter->sum += block->sum;
+  filter->count += block->count;
+  if (++filter->blocks < filter->window_blocks) return false;
+
+  window->sum = filter->sum;
+  window->count = filter->count;
+  mains_filter_reset(filter);
+  return true;
+}
@@ -0,0 +1,44 @@
+#ifndef MAINS_FILTER_H
+#define MAINS_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "acquisition.h"
+
+// Rejeição do zumbido da rede (50 ou 60 Hz) no caminho da aquisição: um
+// boxcar com decimação (CIC de primeira ordem) que soma os blocos do ADC em
+// janelas de um número inteiro de ciclos da rede. A média de uma janela não
+// tem resposta na frequência da rede nem nas harmônicas, qualquer que seja a
+// fase. O filtro roda a cada bloco, na IRQ, só com somas: cada janela é
+// publicada assim que o último bloco dela chega, sem amostras guardadas.
+//
+// A janela precisa ter um número inteiro de blocos; com blocos de 100
+// amostras, uma taxa de 200 amostras por ciclo da rede dá janelas de 2 blocos
+// (um ciclo). Uma queda de 1% na frequência da rede deixa passar cerca de 1%
+// da amplitude do zumbido.
+
+// Maior janela aceita, em blocos
+#define MAINS_FILTER_MAX_BLOCKS 8
+
+typedef struct {
+  uint8_t window_blocks; // Blocos por janela (1 = filtro desligado)
+  uint8_t blocks;        // Blocos já somados na janela em andamento
+  uint32_t sum;
+  uint32_t count;
+} mains_filter_t;
+
+// Menor número de blocos de `block_len` amostras a `sample_rate_hz` que cobre
+// um número inteiro de ciclos de `mains_hz`. 0 se passar de
+// MAINS_FILTER_MAX_BLOCKS; 1 com `mains_hz` 0 (sem filtro).
+uint8_t mains_filter_window_blocks(uint32_t mains_hz, uint32_t sample_rate_hz, uint32_t block_len);
+
+void mains_filter_init(mains_filter_t *filter, uint8_t window_blocks);
+
+// Descarta a janela em andamento
+void mains_filter_reset(mains_filter_t *filter);
+
+// Acrescenta o resumo de um bloco. Retorna true (e preenche `window`, que
+// pode ser o próprio `block`) quando a janela fica completa.
+bool mains_filter_add(mains_filter_t *filter, const acquisition_result_t *block, acquisition_result_t *window);
+
+#endif
@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <string.h>
+#include "measurement.h"
+
+const char *available_digit_colors[12] = {"preto", "marrom", "vermelho", "laranja", "amarelo", "verde", "azul", "violeta", "cinza", "branco", "dourado", "prata"};
+const char *resistor_band_colors[MAX_BAND_COLORS] = {0};
+int resistor_band_color_indexes[MAX_BAND_COLORS] = {
+  0, // primeira banda
+  0, // segunda banda
+  0, // multiplicador (4 faixas) ou terceira banda (5 faixas)
+  0  // multiplicador (5 faixas)
+};
+uint8_t resistor_band_count = 3;
+
+#ifdef OHMIMETRO_FIXED_POINT
+
+adc_mean_t measurement_average(uint32_t sum, uint32_t count) {
+  if (count == 0) return 0;
+  return (adc_mean_t)((((uint64_t)sum << 16) + count / 2) / count);
+}
+
+resistance_t measurement_resistance(resistance_t reference_resistor, adc_mean_t average_adc) {
+  if (average_adc >= ADC_MEAN(ADC_RESOLUTION)) return RESISTANCE_INVALID;
+
+  // R = R_ref * a / (4095 - a) com `a` em Q16: o fator 2^16 se cancela
+  uint64_t denominator = ADC_MEAN(ADC_RESOLUTION) - average_adc;
+  return (reference_resistor * average_adc + denominator / 2) / denominator;
+}
+
+bool get_closest_resistor(eseries_t series, resistance_t resistor_value, eseries_value_t *closest) {
+  if (!eseries_nearest_milliohms(series, resistor_value, closest)) {
+    closest->mantissa = 0;
+    closest->exponent = 0;
+    return false;
+  }
+  return true;
+}
+
+resistance_t measurement_nominal_resistance(eseries_value_t value) {
+  uint64_t milliohms = value.mantissa;
+  int exponent = value.exponent + 3;
+
+  for (; exponent > 0; --exponent) milliohms *= 10;
+  for (; exponent < 0; ++exponent) milliohms = (milliohms + 5) / 10;
+  return milliohms;
+}
+
+// Com |R - R_ref| limitado a R_ref, o produto cabe em 64 bits até R_ref de
+// 9 GΩ
+int32_t measurement_deviation_ppm(resistance_t resistance, resistance_t reference) {
+  if (reference == 0) return MEASUREMENT_DEVIATION_MAX_PPM;
+  if (resistance >= 2 * reference) return MEASUREMENT_DEVIATION_MAX_PPM;
+
+  if (resistance >= reference)
+    return (int32_t)(((resistance - reference) * 1000000 + reference / 2) / reference);
+  return -(int32_t)(((reference - resistance) * 1000000 + reference / 2) / reference);
+}
+
+#else
+
+adc_mean_t measurement_average(uint32_t sum, uint32_t count) {
+  if (count == 0) return 0.0f;
+  return (float)sum / (float)count;
+}
+
+resistance_t measurement_resistance(resistance_t reference_resistor, adc_mean_t average_adc) {
+  return (reference_resistor * average_adc) / (ADC_RESOLUTION - average_adc);
+}
+
+bool get_closest_resistor(eseries_t series, resistance_t resistor_value, eseries_value_t *closest) {
+  if (!eseries_nearest(series, resistor_value, closest)) {
+    closest->mantissa = 0;
+    closest->exponent = 0;
+    return false;
+  }
+  return true;
+}
+
+resistance_t measurement_nominal_resistance(eseries_value_t value) {
+  return eseries_to_float(value);
+}
+
+int32_t measurement_deviation_ppm(resistance_t resistance, resistance_t reference) {
+  if (reference <= 0.0f) return MEASUREMENT_DEVIATION_MAX_PPM;
+
+  float deviation = (resistance / reference - 1.0f) * 1e6f;
+  if (!(deviation < MEASUREMENT_DEVIATION_MAX_PPM)) return MEASUREMENT_DEVIATION_MAX_PPM;
+  return (int32_t)lroundf(deviation);
+}
+
+#endif
+
+bool get_closest_e24_resistor(resistance_t resistor_value, eseries_value_t *closest) {
+  return get_closest_resistor(ESERIES_E24, resistor_value, closest);
+}
+
+static void set_band(uint8_t band, int color_index) {
+  resistor_band_colors[band] = available_digit_colors[color_index];
+  resistor_band_color_indexes[band] = color_index;
+}
+
+void get_band_color_series(eseries_t series, const eseries_value_t *closest) {
+  uint8_t digits = eseries_significant_digits(series);
+
+  resistor_band_count = digits + 1;
+
+  if (closest->mantissa == 0) {
+    for (uint8_t band = 0; band < resistor_band_count; ++band) {
+      resistor_band_colors[band] = "erro";
+      resistor_band_color_indexes[band] = 0;
+    }
+    return;
+  }
+
+  // Definição das bandas de dígitos
+  // EX.: 470 => 4, 7 (4 faixas) ou 4, 7, 0 (5 faixas)
+  set_band(0, closest->mantissa / 100);
+  set_band(1, closest->mantissa / 10 % 10);
+  if (digits == 3) set_band(2, closest->mantissa % 10);
+
+  // Multiplicador: com dois dígitos o terceiro passa para o expoente
+  int exponent = closest->exponent + (3 - digits);
+
+  if (exponent >= 0 && exponent <= 9) {
+    set_band(digits, exponent);
+  } else if (exponent == -1) {
+    set_band(digits, BAND_COLOR_GOLD);
+  } else if (exponent == -2) {
+    set_band(digits, BAND_COLOR_SILVER);
+  } else {
+    resistor_band_colors[digits] = "erro";
+    resistor_band_color_indexes[digits] = 0;
+  }
+}
+
+void get_band_color(const eseries_value_t *closest) {
+  // Cálculo das cores de cada banda do resistor (4 bandas)
+  get_band_color_series(ESERIES_E24, closest);
+}
+
+#ifdef OHMIMETRO_FIXED_POINT
+
+size_t measurement_format_ohms(char *text, const eseries_value_t *value) {
+  uint32_t integer = value->mantissa;
+  int zeros = 0;
+
+  if (value->exponent < -3) {
+    integer = 0;
+  } else if (value->exponent < 0) {
+    // Arredonda a parte fracionária como o "%.0f" da versão em float: empates
+    // vão para o par (4.7 => 5, 0.47 => 0, 10.5 => 10, 1.5 => 2)
+    uint32_t divisor = 1;
+    for (int8_t e = value->exponent; e < 0; ++e)
+      divisor *= 10;
+    uint32_t remainder = integer % divisor;
+    integer /= divisor;
+    if (remainder * 2 > divisor || (remainder * 2 == divisor && (integer & 1)))
+      integer++;
+  } else {
+    zeros = value->exponent;
+  }
+
+  // Dígitos da mantissa de trás para frente, depois os zeros do expoente
+  char digits[4];
+  size_t count = 0, length = 0;
+  do {
+    digits[count++] = '0' + integer % 10;
+    integer /= 10;
+  } while (integer);
+
+  while (count) text[length++] = digits[--count];
+  if (text[0] != '0')
+    while (zeros--) text[length++] = '0';
+
+  text[length] = '\0';
+  return length;
+}
+
+#else
+
+size_t measurement_format_ohms(char *text, const eseries_value_t *value) {
+  return sprintf(text, "%.0f", eseries_to_float(*value));
+}
+
+#endif
+
+size_t measurement_format_engineering(char *text, size_t size, const eseries_value_t *value) {
+  static const char prefixes[] = {'m', 0, 'k', 'M', 'G'};
+  char buffer[8]; // "9.99kΩ" no pior caso, mais o terminador
+  size_t length = 0;
+
+  if (size == 0) return 0;
+  text[0] = '\0';
+
+  if (value->mantissa == 0) {
+    buffer[length++] = '-';
+  } else {
+    // Década do primeiro dígito e o grupo de 3 décadas do prefixo
+    int decade = value->exponent + 2;
+    int group = decade >= 0 ? decade / 3 : -((2 - decade) / 3);
+    if (group < -1 || group > 3) return 0;
+
+    // 1 a 3 dígitos antes do ponto; os demais só se não forem zeros
+    char digits[3] = {'0' + value->mantissa / 100, '0' + value->mantissa / 10 % 10, '0' + value->mantissa % 10};
+    int integer_digits = decade - 3 * group + 1;
+    int last = 2;
+    while (last >= integer_digits && digits[last] == '0') last--;
+
+    for (int i = 0; i < integer_digits; ++i) buffer[length++] = digits[i];
+    if (last >= integer_digits) {
+      buffer[length++] = '.';
+      for (int i = integer_digits; i <= last; ++i) buffer[length++] = digits[i];
+    }
+    if (prefixes[group + 1]) buffer[length++] = prefixes[group + 1];
+    buffer[length++] = OHM_SIGN;
+  }
+
+  if (length + 1 > size) return 0;
+  memcpy(text, buffer, length);
+  text[length] = '\0';
+  return length;
+}
@@ -0,0 +1,82 @@
+#ifndef MEASUREMENT_H
+#define MEASUREMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "eseries.h"
+#include "fixed_point.h"
+#include "sorting.h"
+
+// Fundo de escala do ADC de 12 bits
+#define ADC_RESOLUTION 4095
+
+// Resultado de uma medição, passado do núcleo de aquisição ao de apresentação
+typedef struct {
+  uint32_t timestamp_ms;
+  adc_mean_t average_adc;
+  uint32_t adc_variance;   // Variância das médias dos blocos (sample_stats_variance)
+  uint32_t sample_count;   // Amostras usadas na medição
+  uint8_t range;           // Faixa de referência usada (ranging.h)
+  uint8_t channel;         // Canal do modo multicanal (multichannel.h; 0 fora dele)
+  resistance_t resistance; // Valor calculado pelo divisor
+  eseries_value_t closest_e24; // Valor comercial mais próximo (mantissa 0 fora da faixa)
+  int32_t deviation_ppm;   // Desvio em relação a closest_e24 (0 fora da faixa)
+  const char *band_names[3];
+  uint8_t band_indexes[3]; // Primeira banda, segunda banda, multiplicador
+  sorting_status_t sorting; // Modo de triagem (active false fora dele)
+} measurement_record_t;
+
+// Desvio máximo representado: +-100%
+#define MEASUREMENT_DEVIATION_MAX_PPM 1000000
+
+// Ω na fonte do display (font.h)
+#define OHM_SIGN '\x7f'
+
+// Índices das cores que só aparecem no multiplicador (x0.1 e x0.01)
+#define BAND_COLOR_GOLD 10
+#define BAND_COLOR_SILVER 11
+
+// Dígitos significativos (2 ou 3) seguidos do multiplicador
+#define MAX_BAND_COLORS 4
+
+extern const char *available_digit_colors[12];
+extern const char *resistor_band_colors[MAX_BAND_COLORS];
+extern int resistor_band_color_indexes[MAX_BAND_COLORS];
+extern uint8_t resistor_band_count;
+
+// Média dos códigos do ADC a partir da soma acumulada, arredondada
+adc_mean_t measurement_average(uint32_t sum, uint32_t count);
+
+// Resistência desconhecida do divisor (R_x na parte inferior, R_ref na
+// superior), arredondada. RESISTANCE_INVALID com o ADC no fundo de escala.
+// Em ponto fixo, R_ref vai até 4 MΩ sem estourar o produto de 64 bits.
+resistance_t measurement_resistance(resistance_t reference_resistor, adc_mean_t average_adc);
+
+// Valor comercial da série mais próximo. Retorna false (e mantissa 0) fora
+// da faixa da série.
+bool get_closest_resistor(eseries_t series, resistance_t resistor_value, eseries_value_t *closest);
+bool get_closest_e24_resistor(resistance_t resistor_value, eseries_value_t *closest);
+
+// Resistência nominal de um valor comercial
+resistance_t measurement_nominal_resistance(eseries_value_t value);
+
+// (R - R_ref) / R_ref em ppm, arredondado e saturado em
+// +-MEASUREMENT_DEVIATION_MAX_PPM (também com R_ref nula)
+int32_t measurement_deviation_ppm(resistance_t resistance, resistance_t reference);
+
+// Cores das faixas de um valor comercial: 4 faixas até a E24 e 5 faixas nas
+// séries de precisão (sem contar a tolerância)
+void get_band_color_series(eseries_t series, const eseries_value_t *closest);
+void get_band_color(const eseries_value_t *closest);
+
+// Escreve o valor em ohms, arredondado para inteiro, sem printf
+// (4.7k => "4700"). Retorna o número de caracteres escritos.
+size_t measurement_format_ohms(char *text, const eseries_value_t *value);
+
+// Escreve o valor em notação de engenharia, com prefixo SI e o Ω da fonte do
+// display (4.7k => "4.7kΩ", 1.2M => "1.2MΩ", 0.47 => "470mΩ"), só com
+// inteiros. Retorna o número de caracteres escritos, ou 0 (texto vazio) se
+// não couberem em `size` bytes. Mantissa 0 (fora da série) vira "-".
+size_t measurement_format_engineering(char *text, size_t size, const eseries_value_t *value);
+
+#endif
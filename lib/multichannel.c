@@ -0,0 +1,59 @@
+#include "multichannel.h"
+#include "measurement.h"
+
+void multichannel_init(multichannel_channel_t *channel, uint8_t input, const reference_range_t *reference,
+                       const probe_config_t *probe_config) {
+  channel->reference = reference;
+  probe_init(&channel->probe, probe_config);
+  sample_stats_reset(&channel->stats);
+
+#ifdef OHMIMETRO_HOST
+  hal_sim_channel_attach(input, reference->gpio, resistance_to_ohms(reference->reference));
+#else
+  (void)input;
+#endif
+  hal_gpio_output(reference->gpio, true);
+}
+
+// Leitura sem estatística: só a janela atual
+static void window_reading(const acquisition_result_t *result, adc_mean_t mean, resistance_t resistance,
+                           multichannel_reading_t *reading) {
+  reading->average_adc = mean;
+  reading->adc_variance = 0;
+  reading->sample_count = result->count;
+  reading->resistance = resistance;
+}
+
+multichannel_event_t multichannel_update(multichannel_channel_t *channel, const acquisition_result_t *result,
+                                         const sample_stats_config_t *stats_config, multichannel_reading_t *reading) {
+  adc_mean_t mean = measurement_average(result->sum, result->count);
+
+  switch (probe_update(&channel->probe, mean)) {
+    case PROBE_EVENT_REMOVED:
+      window_reading(result, mean, RESISTANCE_INVALID, reading);
+      return MULTICHANNEL_REMOVED;
+
+    case PROBE_EVENT_SHORTED:
+      window_reading(result, mean, RESISTANCE_OHMS(0), reading);
+      return MULTICHANNEL_SHORTED;
+
+    case PROBE_EVENT_SETTLED:
+      sample_stats_reset(&channel->stats);
+      break;
+
+    default:
+      break;
+  }
+
+  if (channel->probe.state != PROBE_SETTLED) return MULTICHANNEL_NONE;
+
+  sample_stats_add_block(&channel->stats, result->sum, result->count);
+  if (!sample_stats_done(&channel->stats, stats_config)) return MULTICHANNEL_NONE;
+
+  reading->average_adc = sample_stats_estimate(&channel->stats, stats_config);
+  reading->adc_variance = sample_stats_variance(&channel->stats);
+  reading->sample_count = channel->stats.samples;
+  reading->resistance = ranging_range_resistance(channel->reference, reading->average_adc);
+  sample_stats_reset(&channel->stats);
+  return MULTICHANNEL_MEASURED;
+}
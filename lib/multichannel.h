@@ -0,0 +1,48 @@
+#ifndef MULTICHANNEL_H
+#define MULTICHANNEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "acquisition.h"
+#include "probe.h"
+#include "ranging.h"
+#include "sample_stats.h"
+
+// Modo multicanal: até três divisores, um por entrada externa do ADC, lidos
+// em round-robin (acquisition.h) e medidos ao mesmo tempo. Cada canal tem o
+// seu resistor de referência fixo (sem troca de faixa), com a calibração
+// dele (resistência de saída do GPIO e offset), o seu detector das ponteiras
+// e a sua estatística; a tabela de correção do ADC é a mesma para todos.
+
+typedef enum {
+  MULTICHANNEL_NONE,
+  MULTICHANNEL_MEASURED, // Medição completa
+  MULTICHANNEL_SHORTED,  // Ponteiras do canal em curto (resistência 0)
+  MULTICHANNEL_REMOVED,  // Peça retirada (RESISTANCE_INVALID)
+} multichannel_event_t;
+
+typedef struct {
+  adc_mean_t average_adc;
+  uint32_t adc_variance;  // sample_stats_variance (0 no curto e na retirada)
+  uint32_t sample_count;
+  resistance_t resistance;
+} multichannel_reading_t;
+
+typedef struct {
+  const reference_range_t *reference;
+  probe_t probe;
+  sample_stats_t stats;
+} multichannel_channel_t;
+
+// Alimenta a referência do canal (o GPIO fica em nível alto) e começa a
+// acomodar. `reference` e `probe_config` devem permanecer válidos.
+void multichannel_init(multichannel_channel_t *channel, uint8_t input, const reference_range_t *reference,
+                       const probe_config_t *probe_config);
+
+// Acrescenta um resumo do canal (result->channel) e retorna o que ele
+// completou, preenchendo `reading` nos eventos diferentes de MULTICHANNEL_NONE.
+// Com a peça acomodada, as medições se repetem enquanto ela ficar no canal.
+multichannel_event_t multichannel_update(multichannel_channel_t *channel, const acquisition_result_t *result,
+                                         const sample_stats_config_t *stats_config, multichannel_reading_t *reading);
+
+#endif
@@ -0,0 +1,57 @@
+#include "probe.h"
+
+static adc_mean_t distance(adc_mean_t a, adc_mean_t b) {
+  return a > b ? a - b : b - a;
+}
+
+void probe_init(probe_t *probe, const probe_config_t *config) {
+  probe->config = config;
+  probe_restart(probe);
+}
+
+void probe_restart(probe_t *probe) {
+  probe->state = PROBE_SETTLING;
+  probe->stable_blocks = 0;
+}
+
+probe_event_t probe_update(probe_t *probe, adc_mean_t block_mean) {
+  const probe_config_t *config = probe->config;
+  probe_state_t previous = probe->state;
+
+  if (block_mean > config->open_code) {
+    probe->state = PROBE_OPEN;
+    return previous == PROBE_OPEN ? PROBE_EVENT_NONE : PROBE_EVENT_REMOVED;
+  }
+
+  if (block_mean < config->short_code) {
+    probe->state = PROBE_SHORT;
+    return previous == PROBE_SHORT ? PROBE_EVENT_NONE : PROBE_EVENT_SHORTED;
+  }
+
+  switch (previous) {
+    case PROBE_OPEN:
+    case PROBE_SHORT:
+      probe->state = PROBE_SETTLING;
+      probe->stable_blocks = 1;
+      probe->last_mean = block_mean;
+      return PROBE_EVENT_INSERTED;
+
+    case PROBE_SETTLING:
+      // Depois de probe_restart o primeiro bloco só serve de referência
+      if (probe->stable_blocks && distance(block_mean, probe->last_mean) <= config->settle_codes)
+        probe->stable_blocks++;
+      else
+        probe->stable_blocks = 1;
+      probe->last_mean = block_mean;
+
+      if (probe->stable_blocks < config->settle_blocks) return PROBE_EVENT_NONE;
+      probe->state = PROBE_SETTLED;
+      return PROBE_EVENT_SETTLED;
+
+    case PROBE_SETTLED:
+      // Variações com a peça presente ficam para a estatística da medição
+      return PROBE_EVENT_NONE;
+  }
+
+  return PROBE_EVENT_NONE;
+}
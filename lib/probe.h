@@ -0,0 +1,60 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Detector de inserção e retirada da peça nas ponteiras, alimentado com a
+// média de cada bloco do ADC (custo de algumas comparações por bloco). A
+// medição completa só roda com a entrada acomodada; com as ponteiras abertas
+// ou em curto não há resistência a calcular nem quadro novo a enviar.
+//
+//   aberto      média acima de `open_code` (ADC no fundo de escala)
+//   curto       média abaixo de `short_code`
+//   acomodando  peça inserida; espera `settle_blocks` blocos seguidos com
+//               médias a menos de `settle_codes` umas das outras (o contato
+//               das ponteiras oscila na inserção)
+//   acomodado   a medição completa pode rodar, até a peça sair
+
+typedef enum {
+  PROBE_OPEN,
+  PROBE_SHORT,
+  PROBE_SETTLING,
+  PROBE_SETTLED,
+} probe_state_t;
+
+typedef enum {
+  PROBE_EVENT_NONE,
+  PROBE_EVENT_INSERTED, // Saiu de aberto ou curto; começa a acomodar
+  PROBE_EVENT_SETTLED,  // Entrada estável: o bloco atual já pode ser medido
+  PROBE_EVENT_SHORTED,  // Entrou em curto
+  PROBE_EVENT_REMOVED,  // Ponteiras abertas depois de uma peça ou de um curto
+} probe_event_t;
+
+typedef struct {
+  adc_mean_t open_code;
+  adc_mean_t short_code;
+  adc_mean_t settle_codes;
+  uint8_t settle_blocks; // Ao menos 2
+} probe_config_t;
+
+typedef struct {
+  const probe_config_t *config;
+  probe_state_t state;
+  adc_mean_t last_mean;
+  uint8_t stable_blocks; // Blocos seguidos dentro de settle_codes
+} probe_t;
+
+// Começa acomodando: a primeira leitura decide entre aberto, curto e peça.
+// `config` deve permanecer válido enquanto o detector estiver em uso.
+void probe_init(probe_t *probe, const probe_config_t *config);
+
+// Classifica o bloco de média `block_mean` e retorna a transição, se houver.
+probe_event_t probe_update(probe_t *probe, adc_mean_t block_mean);
+
+// O circuito mudou (troca de faixa): volta a acomodar a partir do próximo
+// bloco, sem gerar eventos de retirada ou inserção.
+void probe_restart(probe_t *probe);
+
+#endif
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+#include "profile.h"
+
+profile_probe_t profile_probes[PROFILE_PROBE_COUNT] = {
+  [PROFILE_ADC_BLOCK]   = {.name = "adc"},
+  [PROFILE_ACQUISITION] = {.name = "aquisicao"},
+  [PROFILE_ESERIES]     = {.name = "e24"},
+  [PROFILE_LAYOUT]      = {.name = "layout"},
+  [PROFILE_TEXT]        = {.name = "texto"},
+  [PROFILE_I2C]         = {.name = "i2c", .timer_us = true},   // Tarefa no núcleo 1, IRQ no 0
+  [PROFILE_LEDS]        = {.name = "leds"},
+  [PROFILE_FLASH]       = {.name = "flash", .timer_us = true}, // Apagamento de dezenas de ms
+};
+
+uint32_t profile_bin(uint32_t value) {
+  if (value < PROFILE_LINEAR_BINS) return value;
+
+  // Oitava pelo bit mais alto; os 2 bits seguintes escolhem a faixa nela
+  uint32_t octave = 31 - __builtin_clz(value);
+  uint32_t sub = (value >> (octave - 2)) & (PROFILE_OCTAVE_BINS - 1);
+  return PROFILE_LINEAR_BINS + (octave - 3) * PROFILE_OCTAVE_BINS + sub;
+}
+
+uint32_t profile_bin_upper(uint32_t bin) {
+  if (bin < PROFILE_LINEAR_BINS) return bin;
+
+  uint32_t octave = (bin - PROFILE_LINEAR_BINS) / PROFILE_OCTAVE_BINS + 3;
+  uint32_t sub = (bin - PROFILE_LINEAR_BINS) % PROFILE_OCTAVE_BINS;
+  uint32_t lower = (PROFILE_OCTAVE_BINS + sub) << (octave - 2);
+  return lower + ((1u << (octave - 2)) - 1);
+}
+
+void profile_histogram_reset(profile_histogram_t *histogram) {
+  memset(histogram, 0, sizeof(*histogram));
+}
+
+void profile_histogram_add(profile_histogram_t *histogram, uint32_t value) {
+  if (histogram->count == 0 || value < histogram->min) histogram->min = value;
+  if (value > histogram->max) histogram->max = value;
+  histogram->sum += value;
+  histogram->bins[profile_bin(value)]++;
+  histogram->count++;
+}
+
+void profile_histogram_summary(const profile_histogram_t *histogram, profile_summary_t *summary) {
+  memset(summary, 0, sizeof(*summary));
+  if (histogram->count == 0) return;
+
+  summary->count = histogram->count;
+  summary->min = histogram->min;
+  summary->max = histogram->max;
+  summary->mean = (uint32_t)((histogram->sum + histogram->count / 2) / histogram->count);
+
+  // Faixa da amostra de posição ceil(0.99 * count). profile_histogram_add
+  // soma a faixa antes da contagem, e aqui a contagem é lida antes das
+  // faixas: uma amostra acrescentada no meio da leitura não impede de chegar
+  // a essa posição.
+  uint32_t rank = histogram->count - histogram->count / 100;
+  uint32_t seen = 0;
+  for (uint32_t bin = 0; bin < PROFILE_BINS; ++bin) {
+    seen += histogram->bins[bin];
+    if (seen >= rank) {
+      uint32_t upper = profile_bin_upper(bin);
+      summary->p99 = upper < histogram->max ? upper : histogram->max;
+      break;
+    }
+  }
+}
+
+void profile_start(profile_probe_id_t id) {
+  profile_probe_t *probe = &profile_probes[id];
+  probe->start = probe->timer_us ? (uint32_t)hal_time_us() : hal_cycles();
+  probe->running = true;
+}
+
+void profile_stop(profile_probe_id_t id) {
+  profile_probe_t *probe = &profile_probes[id];
+  if (!probe->running) return;
+
+  uint32_t elapsed;
+  if (probe->timer_us) {
+    uint32_t us = (uint32_t)hal_time_us() - probe->start;
+    elapsed = us < UINT32_MAX / HAL_CYCLES_PER_US ? us * HAL_CYCLES_PER_US : UINT32_MAX;
+  } else {
+    elapsed = (hal_cycles() - probe->start) & HAL_CYCLES_MASK;
+  }
+
+  probe->running = false;
+  profile_histogram_add(&probe->histogram, elapsed);
+}
+
+void profile_reset(void) {
+  for (int i = 0; i < PROFILE_PROBE_COUNT; ++i) {
+    profile_probes[i].running = false;
+    profile_histogram_reset(&profile_probes[i].histogram);
+  }
+}
+
+void profile_summary(profile_probe_id_t id, profile_summary_t *summary) {
+  profile_histogram_summary(&profile_probes[id].histogram, summary);
+}
+
+// Ciclos em us com uma casa decimal
+static void print_us(const char *label, uint32_t cycles) {
+  uint32_t tenths = (uint32_t)(((uint64_t)cycles * 10 + HAL_CYCLES_PER_US / 2) / HAL_CYCLES_PER_US);
+  printf(", %s %lu.%lu us", label, (unsigned long)(tenths / 10), (unsigned long)(tenths % 10));
+}
+
+void profile_report(void) {
+  profile_summary_t summary;
+
+  for (int i = 0; i < PROFILE_PROBE_COUNT; ++i) {
+    profile_summary(i, &summary);
+    printf("perfil %s: %lu amostras", profile_probes[i].name, (unsigned long)summary.count);
+    print_us("min", summary.min);
+    print_us("media", summary.mean);
+    print_us("p99", summary.p99);
+    print_us("max", summary.max);
+    printf("\n");
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hal.h"
+
+// Perfil dos estágios do pipeline. Cada sonda conta os ciclos entre
+// PROFILE_START e PROFILE_STOP (hal_cycles) em um histograma logarítmico de
+// tamanho fixo, de onde saem mínimo, máximo, média e p99, sem heap e sem
+// float. O início e o fim podem estar em funções diferentes (o envio do
+// quadro começa na tarefa e termina na IRQ do DMA). O hal_cycles é de cada
+// núcleo e dá a volta em 134 ms no RP2040: as sondas que começam e terminam
+// em núcleos diferentes, ou que passam de alguns ms, contam por hal_time_us
+// (convertido em ciclos).
+//
+// Cada sonda é usada por um único contexto (uma tarefa ou uma IRQ). A leitura
+// feita de outro núcleo pode pegar uma amostra no meio da atualização, o que
+// só afeta aquele relatório.
+//
+// Sem OHMIMETRO_PROFILE as macros não geram código e profile.c fica fora do
+// build; o histograma roda também no host.
+
+typedef enum {
+  PROFILE_ADC_BLOCK,   // IRQ do DMA do ADC: correção e soma do bloco
+  PROFILE_ACQUISITION, // Tarefa de aquisição: detector e estatística
+  PROFILE_ESERIES,     // Valor comercial e cores das faixas
+  PROFILE_LAYOUT,      // Quadro base do display
+  PROFILE_TEXT,        // Textos do display
+  PROFILE_I2C,         // Envio do quadro, do início ao fim do DMA do I2C
+  PROFILE_LEDS,        // npWrite
+  PROFILE_FLASH,       // Página do registro (e o apagamento do setor)
+  PROFILE_PROBE_COUNT,
+} profile_probe_id_t;
+
+// Faixas do histograma: uma por valor até 7 ciclos e, daí em diante, 4 por
+// oitava até 2^32. O p99 é o limite superior da faixa dele (no máximo 25%
+// acima do valor exato).
+#define PROFILE_LINEAR_BINS 8
+#define PROFILE_OCTAVE_BINS 4
+#define PROFILE_BINS (PROFILE_LINEAR_BINS + (32 - 3) * PROFILE_OCTAVE_BINS)
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t bins[PROFILE_BINS];
+} profile_histogram_t;
+
+// Resumo em ciclos; tudo 0 sem amostras
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint32_t mean;
+  uint32_t p99;
+} profile_summary_t;
+
+typedef struct {
+  const char *name;
+  bool timer_us;        // Conta por hal_time_us em vez de hal_cycles
+  volatile bool running;
+  uint32_t start;       // hal_cycles (ou hal_time_us) no PROFILE_START
+  profile_histogram_t histogram;
+} profile_probe_t;
+
+void profile_histogram_reset(profile_histogram_t *histogram);
+void profile_histogram_add(profile_histogram_t *histogram, uint32_t value);
+void profile_histogram_summary(const profile_histogram_t *histogram, profile_summary_t *summary);
+
+// Faixa do histograma de `value` e o maior valor que cai nela
+uint32_t profile_bin(uint32_t value);
+uint32_t profile_bin_upper(uint32_t bin);
+
+extern profile_probe_t profile_probes[PROFILE_PROBE_COUNT];
+
+// Um PROFILE_STOP sem o PROFILE_START correspondente é ignorado.
+void profile_start(profile_probe_id_t id);
+void profile_stop(profile_probe_id_t id);
+
+// Zera os histogramas de todas as sondas
+void profile_reset(void);
+
+void profile_summary(profile_probe_id_t id, profile_summary_t *summary);
+
+// Resumo de cada sonda no stdio, em us, uma linha prefixada por "perfil".
+void profile_report(void);
+
+#ifdef OHMIMETRO_PROFILE
+#define PROFILE_START(id) profile_start(id)
+#define PROFILE_STOP(id) profile_stop(id)
+#else
+#define PROFILE_START(id) ((void)0)
+#define PROFILE_STOP(id) ((void)0)
+#endif
+
+#endif
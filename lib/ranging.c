@@ -0,0 +1,91 @@
+#include "ranging.h"
+#include "measurement.h"
+
+// Histerese: faixa atual mantida com R_x / R_ref entre 1 / RANGING_KEEP_RATIO
+// e RANGING_KEEP_RATIO
+#define RANGING_KEEP_RATIO 5
+
+static const reference_range_t *range_table;
+static uint8_t range_count;
+static uint8_t active_range;
+
+// Limites entre faixas vizinhas: média geométrica das referências, onde R_x
+// fica igualmente longe (em escala logarítmica) de uma e de outra
+static resistance_t range_boundaries[RANGING_MAX_RANGES - 1];
+
+static resistance_t effective_reference(const reference_range_t *range) {
+  return range->reference + range->series;
+}
+
+void ranging_init(const reference_range_t *ranges, uint8_t count, uint8_t initial) {
+  range_table = ranges;
+  range_count = count > RANGING_MAX_RANGES ? RANGING_MAX_RANGES : count;
+
+  for (uint8_t i = 0; i < range_count; ++i) {
+    hal_gpio_float(range_table[i].gpio);
+#ifdef OHMIMETRO_HOST
+    // Descreve a ligação dos resistores ao divisor da placa virtual
+    hal_sim_divider_attach(range_table[i].gpio, resistance_to_ohms(range_table[i].reference));
+#endif
+  }
+
+  for (uint8_t i = 0; i + 1 < range_count; ++i)
+    range_boundaries[i] = resistance_geometric_mean(effective_reference(&range_table[i]),
+                                                    effective_reference(&range_table[i + 1]));
+
+  active_range = initial < range_count ? initial : 0;
+  hal_gpio_output(range_table[active_range].gpio, true);
+}
+
+void ranging_select(uint8_t index) {
+  if (index >= range_count || index == active_range) return;
+
+  // Solta a faixa anterior antes de alimentar a nova: as duas juntas
+  // formariam um divisor com as referências em paralelo
+  hal_gpio_float(range_table[active_range].gpio);
+  active_range = index;
+  hal_gpio_output(range_table[active_range].gpio, true);
+}
+
+uint8_t ranging_current(void) {
+  return active_range;
+}
+
+uint8_t ranging_count(void) {
+  return range_count;
+}
+
+uint8_t ranging_choose(adc_mean_t average_adc) {
+  adc_mean_t offset = range_table[active_range].adc_offset;
+  adc_mean_t code = average_adc > offset ? average_adc - offset : 0;
+
+  // Saturado: sem estimativa, vai ao extremo e deixa a próxima leitura refinar
+  if (code < ADC_MEAN(0.5)) return 0;
+  if (code > ADC_MEAN(ADC_RESOLUTION - 0.5)) return range_count - 1;
+
+  // Comparações por multiplicação, sem dividir
+  resistance_t resistance = ranging_resistance(average_adc);
+  resistance_t reference = effective_reference(&range_table[active_range]);
+  if (resistance * RANGING_KEEP_RATIO > reference && resistance < reference * RANGING_KEEP_RATIO)
+    return active_range;
+
+  return ranging_best(resistance);
+}
+
+uint8_t ranging_best(resistance_t resistance) {
+  uint8_t best = 0;
+  while (best + 1 < range_count && resistance > range_boundaries[best])
+    best++;
+
+  return best;
+}
+
+resistance_t ranging_resistance(adc_mean_t average_adc) {
+  return ranging_range_resistance(&range_table[active_range], average_adc);
+}
+
+resistance_t ranging_range_resistance(const reference_range_t *range, adc_mean_t average_adc) {
+  adc_mean_t code = average_adc > range->adc_offset ? average_adc - range->adc_offset : 0;
+
+  return measurement_resistance(effective_reference(range), code);
+}
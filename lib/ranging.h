@@ -0,0 +1,50 @@
+#ifndef RANGING_H
+#define RANGING_H
+
+#include <stdint.h>
+#include "hal.h"
+#include "fixed_point.h"
+
+// Seleção automática do resistor de referência do divisor. Cada faixa tem seu
+// resistor ligado entre um GPIO e o nó do ADC: o GPIO da faixa ativa fica em
+// nível alto (3,3 V) e os demais em alta impedância.
+//
+// A resolução do divisor é melhor com R_x perto de R_ref (código perto da
+// metade da escala), então uma leitura rápida na faixa atual decide em qual
+// faixa a medição completa deve rodar.
+
+#define RANGING_MAX_RANGES 8
+
+typedef struct {
+  uint gpio;               // Pino que alimenta o resistor da faixa
+  resistance_t reference;  // Valor nominal do resistor de referência
+  // Calibração da faixa
+  resistance_t series;     // Resistência de saída do GPIO, em série com R_ref
+  adc_mean_t adc_offset;   // Código lido com as ponteiras em curto
+} reference_range_t;
+
+// Registra a tabela de faixas (em ordem crescente de R_ref) e ativa `initial`.
+// A tabela deve permanecer válida enquanto o módulo estiver em uso.
+void ranging_init(const reference_range_t *ranges, uint8_t count, uint8_t initial);
+
+void ranging_select(uint8_t index);
+uint8_t ranging_current(void);
+uint8_t ranging_count(void);
+
+// Faixa mais adequada para a leitura `average_adc` feita na faixa atual.
+// Mantém a faixa atual enquanto R_x estiver entre 1/5 e 5 vezes R_ref, para
+// não alternar entre faixas vizinhas perto do limite.
+uint8_t ranging_choose(adc_mean_t average_adc);
+
+// Faixa com R_ref mais próximo de `resistance` em escala logarítmica, sem
+// histerese (usada para fixar a faixa de um valor já conhecido).
+uint8_t ranging_best(resistance_t resistance);
+
+// Resistência na faixa atual, aplicando a calibração da faixa.
+resistance_t ranging_resistance(adc_mean_t average_adc);
+
+// Resistência com o divisor de `range`, ativo ou não (os canais do modo
+// multicanal têm cada um a sua referência fixa).
+resistance_t ranging_range_resistance(const reference_range_t *range, adc_mean_t average_adc);
+
+#endif
@@ -0,0 +1,171 @@
+#include <math.h>
+#include <string.h>
+#include "sample_stats.h"
+#include "measurement.h"
+
+// Valores críticos da distribuição t de Student para 95% (bilateral), por
+// graus de liberdade: com poucos blocos a variância estimada ainda é incerta.
+// Em ponto fixo ficam em Q8.
+#ifdef OHMIMETRO_FIXED_POINT
+typedef uint16_t t_value_t;
+#define T_VALUE(x) ((t_value_t)((x) * 256.0 + 0.5))
+#else
+typedef float t_value_t;
+#define T_VALUE(x) ((t_value_t)(x))
+#endif
+
+static const t_value_t t_critical_95[] = {
+  T_VALUE(12.71), T_VALUE(4.30), T_VALUE(3.18), T_VALUE(2.78), T_VALUE(2.57),
+  T_VALUE(2.45), T_VALUE(2.36), T_VALUE(2.31), T_VALUE(2.26), T_VALUE(2.23),
+  T_VALUE(2.20), T_VALUE(2.18), T_VALUE(2.16), T_VALUE(2.14), T_VALUE(2.13)
+};
+
+static t_value_t t_critical(uint8_t degrees) {
+  if (degrees <= sizeof(t_critical_95) / sizeof(t_critical_95[0]))
+    return t_critical_95[degrees - 1];
+  return T_VALUE(1.96);
+}
+
+void sample_stats_reset(sample_stats_t *stats) {
+  memset(stats, 0, sizeof(*stats));
+}
+
+void sample_stats_add_block(sample_stats_t *stats, uint32_t sum, uint32_t count) {
+  if (count == 0) return;
+
+  adc_mean_t block_mean = measurement_average(sum, count);
+
+  if (stats->blocks < SAMPLE_STATS_MAX_BLOCKS)
+    stats->block_means[stats->blocks] = block_mean;
+
+  // Welford sobre as médias dos blocos
+  stats->blocks++;
+#ifdef OHMIMETRO_FIXED_POINT
+  int32_t delta = (int32_t)block_mean - stats->mean;
+  stats->mean += delta / stats->blocks;
+  stats->m2 += (int64_t)delta * ((int32_t)block_mean - stats->mean);
+#else
+  float delta = block_mean - stats->mean;
+  stats->mean += delta / stats->blocks;
+  stats->m2 += delta * (block_mean - stats->mean);
+#endif
+
+  stats->samples += count;
+  stats->sum += sum;
+}
+
+#ifdef OHMIMETRO_FIXED_POINT
+
+fraction_t sample_stats_relative_ci(const sample_stats_t *stats) {
+  if (stats->blocks < 2) return FRACTION_INFINITE;
+
+  // Com o ADC saturado (ponteiras abertas ou em curto) não há resistência
+  // a estimar e esperar mais amostras não muda o resultado
+  int32_t mean = stats->mean;
+  if (mean < (int32_t)ADC_MEAN(0.5) || mean > (int32_t)ADC_MEAN(ADC_RESOLUTION - 0.5)) return 0;
+
+  // Desvio padrão da média: raiz de Q32 => Q16
+  uint64_t m2 = stats->m2 > 0 ? (uint64_t)stats->m2 : 0;
+  uint64_t mean_variance = m2 / (stats->blocks - 1) / stats->blocks;
+  uint64_t mean_ci = ((uint64_t)t_critical(stats->blocks - 1) * isqrt64(mean_variance)) >> 8;
+
+  // R = R_ref * a / (4095 - a) => dR / R = 4095 / (a * (4095 - a)) * da,
+  // com a * (4095 - a) em Q16 (a em Q8) e o resultado em Q16
+  uint64_t a = (uint32_t)mean >> 8;
+  uint64_t span = a * (((uint64_t)ADC_RESOLUTION << 8) - a);
+  uint64_t relative = (mean_ci * ADC_RESOLUTION << 16) / span;
+
+  return relative > FRACTION_INFINITE ? FRACTION_INFINITE : (fraction_t)relative;
+}
+
+uint32_t sample_stats_variance(const sample_stats_t *stats) {
+  if (stats->blocks < 2 || stats->m2 <= 0) return 0;
+
+  // Q32 => Q16
+  uint64_t variance = ((uint64_t)stats->m2 / (stats->blocks - 1)) >> 16;
+  return variance > UINT32_MAX ? UINT32_MAX : (uint32_t)variance;
+}
+
+bool sample_stats_done(const sample_stats_t *stats, const sample_stats_config_t *config) {
+  if (stats->samples >= config->max_samples) return true;
+  if (stats->samples < config->min_samples || stats->blocks < 2) return false;
+
+  fraction_t tolerance = ((uint64_t)config->step_fraction * config->relative_step) >> 16;
+  return sample_stats_relative_ci(stats) <= tolerance;
+}
+
+#else
+
+fraction_t sample_stats_relative_ci(const sample_stats_t *stats) {
+  if (stats->blocks < 2) return FRACTION_INFINITE;
+
+  // Com o ADC saturado (ponteiras abertas ou em curto) não há resistência
+  // a estimar e esperar mais amostras não muda o resultado
+  float mean = stats->mean;
+  if (mean < 0.5f || mean > ADC_RESOLUTION - 0.5f) return 0.0f;
+
+  float variance = stats->m2 / (stats->blocks - 1);
+  float mean_ci = t_critical(stats->blocks - 1) * sqrtf(variance / stats->blocks);
+
+  // R = R_ref * a / (4095 - a) => dR / R = 4095 / (a * (4095 - a)) * da
+  return mean_ci * ADC_RESOLUTION / (mean * (ADC_RESOLUTION - mean));
+}
+
+uint32_t sample_stats_variance(const sample_stats_t *stats) {
+  if (stats->blocks < 2) return 0;
+
+  float variance = stats->m2 / (stats->blocks - 1) * 65536.0f;
+  return variance >= (float)UINT32_MAX ? UINT32_MAX : (uint32_t)variance;
+}
+
+bool sample_stats_done(const sample_stats_t *stats, const sample_stats_config_t *config) {
+  if (stats->samples >= config->max_samples) return true;
+  if (stats->samples < config->min_samples || stats->blocks < 2) return false;
+
+  return sample_stats_relative_ci(stats) <= config->step_fraction * config->relative_step;
+}
+
+#endif
+
+adc_mean_t sample_stats_estimate(const sample_stats_t *stats, const sample_stats_config_t *config) {
+  if (stats->samples == 0) return 0;
+
+  uint8_t blocks = stats->blocks < SAMPLE_STATS_MAX_BLOCKS ? stats->blocks : SAMPLE_STATS_MAX_BLOCKS;
+
+  if (config->estimator == SAMPLE_STATS_MEAN || blocks < 3)
+    return measurement_average(stats->sum, stats->samples);
+
+  // Ordena as médias dos blocos (no máximo 16, inserção basta)
+  adc_mean_t sorted[SAMPLE_STATS_MAX_BLOCKS];
+  for (uint8_t i = 0; i < blocks; ++i) {
+    adc_mean_t value = stats->block_means[i];
+    uint8_t j = i;
+    for (; j > 0 && sorted[j - 1] > value; --j)
+      sorted[j] = sorted[j - 1];
+    sorted[j] = value;
+  }
+
+  uint8_t first = 0, kept = blocks;
+  if (config->estimator == SAMPLE_STATS_MEDIAN) {
+    // Elemento central, ou média dos dois centrais
+    first = (blocks - 1) / 2;
+    kept = 2 - (blocks & 1);
+  } else {
+    // Média aparada: descarta um quarto dos blocos de cada lado (ao menos um)
+    uint8_t trim = blocks / 4 ? blocks / 4 : 1;
+    first = trim;
+    kept = blocks - 2 * trim;
+  }
+
+#ifdef OHMIMETRO_FIXED_POINT
+  uint64_t sum = 0;
+  for (uint8_t i = first; i < first + kept; ++i)
+    sum += sorted[i];
+  return (adc_mean_t)((sum + kept / 2) / kept);
+#else
+  float sum = 0.0f;
+  for (uint8_t i = first; i < first + kept; ++i)
+    sum += sorted[i];
+  return sum / kept;
+#endif
+}
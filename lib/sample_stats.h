@@ -0,0 +1,68 @@
+#ifndef SAMPLE_STATS_H
+#define SAMPLE_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Estatística incremental de uma medição, alimentada bloco a bloco pelo
+// estágio de aquisição. A média e a variância (Welford) são calculadas sobre
+// as médias dos blocos: o custo por amostra fica na soma feita pela IRQ, e
+// ruído correlacionado entre amostras (zumbido da rede, contato oscilando)
+// aparece como variação entre blocos em vez de ser subestimado.
+//
+// A medição termina quando o intervalo de confiança (95%) da resistência
+// calculada fica dentro de uma fração do passo da série E, ou quando o limite
+// de amostras é atingido.
+
+// Maior número de blocos guardados para mediana e média aparada
+#define SAMPLE_STATS_MAX_BLOCKS 16
+
+typedef enum {
+  SAMPLE_STATS_MEAN,         // Média de todas as amostras
+  SAMPLE_STATS_TRIMMED_MEAN, // Média dos blocos sem o quarto mais alto e o mais baixo
+  SAMPLE_STATS_MEDIAN,       // Mediana das médias dos blocos
+} sample_stats_estimator_t;
+
+typedef struct {
+  sample_stats_estimator_t estimator;
+  uint32_t min_samples;  // Nunca termina antes (ao menos 2 blocos)
+  uint32_t max_samples;  // Termina mesmo sem atingir a precisão
+  fraction_t relative_step; // Passo relativo da série (eseries_relative_step)
+  fraction_t step_fraction; // Meia largura aceita do intervalo, em passos
+} sample_stats_config_t;
+
+typedef struct {
+  uint32_t samples;
+  uint32_t sum;
+  uint8_t blocks;
+#ifdef OHMIMETRO_FIXED_POINT
+  int32_t mean; // Média das médias dos blocos em Q16 (Welford)
+  int64_t m2;   // Soma dos quadrados dos desvios em Q32 (Welford)
+#else
+  float mean;   // Média das médias dos blocos (Welford)
+  float m2;     // Soma dos quadrados dos desvios (Welford)
+#endif
+  adc_mean_t block_means[SAMPLE_STATS_MAX_BLOCKS];
+} sample_stats_t;
+
+void sample_stats_reset(sample_stats_t *stats);
+
+// Acrescenta um bloco de `count` amostras cuja soma é `sum`.
+void sample_stats_add_block(sample_stats_t *stats, uint32_t sum, uint32_t count);
+
+// Meia largura do intervalo de confiança da resistência, relativa ao valor
+// (0.01 => +-1%). FRACTION_INFINITE com menos de 2 blocos.
+fraction_t sample_stats_relative_ci(const sample_stats_t *stats);
+
+// Variância das médias dos blocos em 1/65536 de código², saturada em
+// UINT32_MAX (desvio padrão acima de 255 códigos). 0 com menos de 2 blocos.
+uint32_t sample_stats_variance(const sample_stats_t *stats);
+
+// true quando a medição pode ser encerrada.
+bool sample_stats_done(const sample_stats_t *stats, const sample_stats_config_t *config);
+
+// Código médio do ADC segundo o estimador configurado.
+adc_mean_t sample_stats_estimate(const sample_stats_t *stats, const sample_stats_config_t *config);
+
+#endif
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include "scheduler.h"
+#include "hal.h"
+
+void scheduler_init(scheduler_t *scheduler) {
+  scheduler->count = 0;
+}
+
+bool scheduler_add(scheduler_t *scheduler, scheduler_task_t *task) {
+  if (scheduler->count >= SCHEDULER_MAX_TASKS) return false;
+
+  task->next_release_us = task->period_us ? hal_time_us() + task->period_us : UINT64_MAX;
+  scheduler->tasks[scheduler->count++] = task;
+  return true;
+}
+
+void scheduler_post(scheduler_task_t *task) {
+  // Só o primeiro evento marca o instante; o escalonador lê `posted_us`
+  // antes de limpar `signaled`, então não há escrita concorrente
+  if (!atomic_load(&task->signaled)) {
+    task->posted_us = hal_time_us();
+    atomic_store(&task->signaled, true);
+  }
+
+  // Evento vindo do outro núcleo: tira-o do WFE
+  hal_wake();
+}
+
+void scheduler_defer(scheduler_task_t *task, uint32_t delay_us) {
+  uint64_t release = hal_time_us() + delay_us;
+  if (release < task->next_release_us) task->next_release_us = release;
+}
+
+static void scheduler_execute(scheduler_task_t *task, uint64_t release_us) {
+  uint64_t start = hal_time_us();
+  task->run();
+  uint64_t end = hal_time_us();
+
+  uint32_t latency = (uint32_t)(start - release_us);
+  uint32_t duration = (uint32_t)(end - start);
+  uint32_t deadline = task->deadline_us ? task->deadline_us : task->period_us;
+
+  task->runs++;
+  if (latency > task->max_latency_us) task->max_latency_us = latency;
+  if (duration > task->max_duration_us) task->max_duration_us = duration;
+  if (deadline && end - release_us > deadline) task->missed++;
+}
+
+bool scheduler_run_ready(scheduler_t *scheduler) {
+  uint64_t now = hal_time_us();
+
+  for (uint8_t i = 0; i < scheduler->count; ++i) {
+    scheduler_task_t *task = scheduler->tasks[i];
+
+    if (atomic_load(&task->signaled)) {
+      uint64_t release = task->posted_us;
+      atomic_store(&task->signaled, false);
+      scheduler_execute(task, release);
+      return true;
+    }
+
+    if (task->next_release_us <= now) {
+      uint64_t release = task->next_release_us;
+
+      if (task->period_us) {
+        // Atraso maior que um período: os períodos pulados contam como perdidos
+        task->next_release_us += task->period_us;
+        if (task->next_release_us <= now) {
+          uint64_t skipped = (now - task->next_release_us) / task->period_us + 1;
+          task->missed += (uint32_t)skipped;
+          task->next_release_us += skipped * task->period_us;
+        }
+      } else {
+        task->next_release_us = UINT64_MAX;
+      }
+
+      scheduler_execute(task, release);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void scheduler_run(scheduler_t *scheduler) {
+  while (true) {
+    if (scheduler_run_ready(scheduler)) continue;
+
+    uint64_t next = UINT64_MAX;
+    for (uint8_t i = 0; i < scheduler->count; ++i)
+      if (scheduler->tasks[i]->next_release_us < next)
+        next = scheduler->tasks[i]->next_release_us;
+
+    if (next != UINT64_MAX) hal_alarm_wake_at(next);
+    hal_idle_wait();
+  }
+}
+
+void scheduler_report(const scheduler_t *scheduler, const char *label) {
+  for (uint8_t i = 0; i < scheduler->count; ++i) {
+    const scheduler_task_t *task = scheduler->tasks[i];
+    printf("sched %s %-12s execucoes %lu, prazos perdidos %lu, atraso max %lu us, duracao max %lu us\n",
+           label, task->name, (unsigned long)task->runs, (unsigned long)task->missed,
+           (unsigned long)task->max_latency_us, (unsigned long)task->max_duration_us);
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Escalonador cooperativo, um por núcleo. Cada tarefa roda até o fim e é
+// liberada por período, por evento (scheduler_post, inclusive de IRQs e do
+// outro núcleo) ou por um adiamento (scheduler_defer). As tarefas prontas
+// rodam na ordem em que foram adicionadas, que é a prioridade; sem nenhuma
+// pronta, um alarme de hardware é armado para a próxima liberação por tempo
+// e o núcleo dorme em hal_idle_wait.
+//
+// Eventos repetidos antes de a tarefa rodar se acumulam em uma execução. O
+// atraso de cada execução conta da liberação (instante do primeiro evento ou
+// do período) até o início; o prazo, da liberação ao fim.
+
+#define SCHEDULER_MAX_TASKS 8
+
+typedef struct {
+  const char *name;
+  void (*run)(void);
+  uint32_t period_us;   // 0: só por evento ou adiamento
+  uint32_t deadline_us; // 0: o período (sem período, sem prazo)
+
+  // Estado e estatísticas, mantidos pelo escalonador
+  uint64_t next_release_us;   // Próxima liberação por tempo (UINT64_MAX: nenhuma)
+  volatile uint64_t posted_us; // Instante do evento pendente
+  _Atomic bool signaled;
+  uint32_t runs;
+  uint32_t missed;            // Prazos perdidos, inclusive períodos pulados
+  uint32_t max_latency_us;
+  uint32_t max_duration_us;
+} scheduler_task_t;
+
+typedef struct {
+  scheduler_task_t *tasks[SCHEDULER_MAX_TASKS];
+  uint8_t count;
+} scheduler_t;
+
+void scheduler_init(scheduler_t *scheduler);
+
+// Acrescenta a tarefa com a menor prioridade até aqui. Uma tarefa periódica é
+// liberada pela primeira vez um período depois. Retorna false se não couber.
+bool scheduler_add(scheduler_t *scheduler, scheduler_task_t *task);
+
+// Libera a tarefa. Pode ser chamada de IRQs e do outro núcleo.
+void scheduler_post(scheduler_task_t *task);
+
+// Libera a tarefa daqui a `delay_us`. Só do núcleo dono e para tarefas sem
+// período (uma espera de hardware que terminou, por exemplo).
+void scheduler_defer(scheduler_task_t *task, uint32_t delay_us);
+
+// Roda a tarefa pronta de maior prioridade. Retorna false se nenhuma estava.
+bool scheduler_run_ready(scheduler_t *scheduler);
+
+// Laço do núcleo: roda as tarefas prontas e dorme entre elas. Não retorna.
+void scheduler_run(scheduler_t *scheduler);
+
+// Imprime as estatísticas de cada tarefa, uma linha por tarefa.
+void scheduler_report(const scheduler_t *scheduler, const char *label);
+
+#endif
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <string.h>
+#include "sorting.h"
+#include "measurement.h"
+
+static uint32_t abs_ppm(int32_t ppm) {
+  return ppm < 0 ? (uint32_t)-ppm : (uint32_t)ppm;
+}
+
+static void clear_counts(sorting_t *sorting) {
+  sorting->part_present = false;
+  sorting->parts = 0;
+  memset(&sorting->last, 0, sizeof(sorting->last));
+  memset(sorting->bins, 0, sizeof(sorting->bins));
+  memset(sorting->histogram, 0, sizeof(sorting->histogram));
+}
+
+void sorting_init(sorting_t *sorting, uint32_t tolerance_ppm) {
+  sorting->tolerance_ppm = tolerance_ppm;
+  sorting->has_target = false;
+  sorting->target = (eseries_value_t){0, 0};
+  sorting->target_resistance = 0;
+  clear_counts(sorting);
+}
+
+void sorting_set_target(sorting_t *sorting, eseries_value_t target) {
+  sorting->has_target = true;
+  sorting->target = target;
+  sorting->target_resistance = measurement_nominal_resistance(target);
+  clear_counts(sorting);
+}
+
+void sorting_classify(const sorting_t *sorting, resistance_t resistance, sorting_result_t *result) {
+  get_closest_e24_resistor(resistance, &result->closest);
+
+  if (!sorting->has_target) {
+    result->bin = SORTING_IN_TOLERANCE;
+    result->deviation_ppm = 0;
+    return;
+  }
+
+  result->deviation_ppm = measurement_deviation_ppm(resistance, sorting->target_resistance);
+  if (abs_ppm(result->deviation_ppm) <= sorting->tolerance_ppm) {
+    result->bin = SORTING_IN_TOLERANCE;
+    return;
+  }
+
+  // Fora do alvo: se cabe na tolerância do valor da E24 mais próximo, é uma
+  // peça boa de outro valor
+  const eseries_value_t *closest = &result->closest;
+  if (closest->mantissa != 0 &&
+      abs_ppm(measurement_deviation_ppm(resistance, measurement_nominal_resistance(*closest))) <= sorting->tolerance_ppm) {
+    result->bin = SORTING_WRONG_VALUE;
+    return;
+  }
+
+  result->bin = SORTING_OUT_OF_TOLERANCE;
+}
+
+bool sorting_feed(sorting_t *sorting, resistance_t resistance, uint32_t timestamp_ms) {
+  if (resistance == RESISTANCE_INVALID) {
+    sorting->part_present = false;
+    return false;
+  }
+  if (sorting->part_present) return false;
+
+  // Sem alvo, a peça define o alvo e é contada contra ele
+  if (!sorting->has_target) {
+    eseries_value_t target;
+    if (!get_closest_e24_resistor(resistance, &target)) return false;
+    sorting_set_target(sorting, target);
+  }
+
+  sorting_classify(sorting, resistance, &sorting->last);
+  sorting->part_present = true;
+
+  sorting->bins[sorting->last.bin]++;
+
+  // Arredonda o desvio para o passo mais próximo e limita aos extremos
+  int32_t half = SORTING_HISTOGRAM_BINS / 2;
+  int32_t step = sorting->last.deviation_ppm / SORTING_HISTOGRAM_STEP_PPM;
+  int32_t rest = sorting->last.deviation_ppm % SORTING_HISTOGRAM_STEP_PPM;
+  if (rest * 2 >= SORTING_HISTOGRAM_STEP_PPM) step++;
+  if (rest * 2 <= -SORTING_HISTOGRAM_STEP_PPM) step--;
+  if (step < -half) step = -half;
+  if (step > half) step = half;
+  sorting->histogram[step + half]++;
+
+  sorting->part_times_ms[sorting->parts % SORTING_RATE_WINDOW] = timestamp_ms;
+  sorting->parts++;
+  return true;
+}
+
+uint32_t sorting_parts_per_minute(const sorting_t *sorting) {
+  uint32_t count = sorting->parts < SORTING_RATE_WINDOW ? sorting->parts : SORTING_RATE_WINDOW;
+  if (count < 2) return 0;
+
+  uint32_t newest = sorting->part_times_ms[(sorting->parts - 1) % SORTING_RATE_WINDOW];
+  uint32_t oldest = sorting->part_times_ms[(sorting->parts - count) % SORTING_RATE_WINDOW];
+  uint32_t elapsed = newest - oldest;
+  if (elapsed == 0) return 0;
+
+  return ((count - 1) * 60000u + elapsed / 2) / elapsed;
+}
+
+void sorting_status(const sorting_t *sorting, sorting_status_t *status) {
+  status->active = true;
+  status->has_target = sorting->has_target;
+  status->part_present = sorting->part_present;
+  status->target = sorting->target;
+  status->tolerance_ppm = sorting->tolerance_ppm;
+  status->last = sorting->last;
+  memcpy(status->bins, sorting->bins, sizeof(status->bins));
+  status->parts_per_minute = sorting_parts_per_minute(sorting);
+}
+
+void sorting_report(const sorting_t *sorting) {
+  char target[16] = "-";
+  if (sorting->has_target) measurement_format_ohms(target, &sorting->target);
+
+  printf("triagem alvo %s ohms, dentro %lu, fora %lu, errado %lu, %lu pecas/min\n", target,
+         (unsigned long)sorting->bins[SORTING_IN_TOLERANCE],
+         (unsigned long)sorting->bins[SORTING_OUT_OF_TOLERANCE],
+         (unsigned long)sorting->bins[SORTING_WRONG_VALUE],
+         (unsigned long)sorting_parts_per_minute(sorting));
+
+  printf("triagem desvio (%d%% a +%d%%):", -SORTING_HISTOGRAM_BINS / 2, SORTING_HISTOGRAM_BINS / 2);
+  for (int i = 0; i < SORTING_HISTOGRAM_BINS; ++i)
+    printf(" %lu", (unsigned long)sorting->histogram[i]);
+  printf("\n");
+}
@@ -0,0 +1,90 @@
+#ifndef SORTING_H
+#define SORTING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "eseries.h"
+#include "fixed_point.h"
+
+// Triagem de resistores soltos contra um valor alvo da E24. A primeira peça
+// medida define o alvo (o valor comercial mais próximo dela); cada peça
+// seguinte cai em um de três compartimentos:
+//
+//   dentro    desvio em relação ao alvo dentro da tolerância
+//   fora      fora da tolerância do alvo e de qualquer outro valor da E24
+//             (peça com defeito ou de tolerância pior)
+//   errado    dentro da tolerância de outro valor da E24 (peça de outro valor
+//             misturada na bandeja)
+//
+// Uma peça nova é a primeira medição válida depois das ponteiras abertas.
+// O módulo não depende do hardware e roda também no host.
+
+// Histograma do desvio em passos de 1%, de -10% a +10%. Os extremos acumulam
+// os desvios maiores.
+#define SORTING_HISTOGRAM_BINS 21
+#define SORTING_HISTOGRAM_STEP_PPM 10000
+
+// Peças usadas na vazão (peças por minuto)
+#define SORTING_RATE_WINDOW 16
+
+typedef enum {
+  SORTING_IN_TOLERANCE,
+  SORTING_OUT_OF_TOLERANCE,
+  SORTING_WRONG_VALUE,
+  SORTING_BIN_COUNT,
+} sorting_bin_t;
+
+typedef struct {
+  sorting_bin_t bin;
+  int32_t deviation_ppm;   // Desvio em relação ao alvo (saturado em +-100%)
+  eseries_value_t closest; // Valor da E24 mais próximo da peça
+} sorting_result_t;
+
+// Resumo passado à apresentação a cada medição
+typedef struct {
+  bool active;             // Modo de triagem ligado
+  bool has_target;
+  bool part_present;       // Ponteiras na última peça classificada
+  eseries_value_t target;
+  uint32_t tolerance_ppm;
+  sorting_result_t last;   // Última peça classificada
+  uint32_t bins[SORTING_BIN_COUNT];
+  uint32_t parts_per_minute;
+} sorting_status_t;
+
+typedef struct {
+  uint32_t tolerance_ppm; // 50000 => 5%
+  bool has_target;
+  eseries_value_t target;
+  resistance_t target_resistance;
+  bool part_present;
+  sorting_result_t last;
+  uint32_t parts;
+  uint32_t bins[SORTING_BIN_COUNT];
+  uint32_t histogram[SORTING_HISTOGRAM_BINS];
+  uint32_t part_times_ms[SORTING_RATE_WINDOW]; // Anel com os instantes das peças
+} sorting_t;
+
+// Sem alvo: a próxima peça o define. Zera as contagens.
+void sorting_init(sorting_t *sorting, uint32_t tolerance_ppm);
+
+// Fixa o alvo e zera as contagens.
+void sorting_set_target(sorting_t *sorting, eseries_value_t target);
+
+// Classifica `resistance` contra o alvo, sem alterar as contagens.
+void sorting_classify(const sorting_t *sorting, resistance_t resistance, sorting_result_t *result);
+
+// Alimenta uma medição feita em `timestamp_ms`. Retorna true quando ela é uma
+// peça nova, já classificada e contada (o resultado fica em sorting->last).
+// RESISTANCE_INVALID (ponteiras abertas) encerra a peça atual.
+bool sorting_feed(sorting_t *sorting, resistance_t resistance, uint32_t timestamp_ms);
+
+// Vazão nas últimas SORTING_RATE_WINDOW peças; 0 com menos de duas.
+uint32_t sorting_parts_per_minute(const sorting_t *sorting);
+
+void sorting_status(const sorting_t *sorting, sorting_status_t *status);
+
+// Contagens e histograma no stdio, prefixados por "triagem".
+void sorting_report(const sorting_t *sorting);
+
+#endif
@@ -0,0 +1,54 @@
+#include "spsc_queue.h"
+
+// Marca a posição em escrita; nenhuma sequência válida chega a esse valor
+#define SPSC_SEQ_WRITING UINT32_MAX
+
+void spsc_queue_init(spsc_queue_t *queue) {
+  for (uint32_t i = 0; i < SPSC_QUEUE_SIZE; ++i)
+    atomic_store_explicit(&queue->slots[i].seq, SPSC_SEQ_WRITING, memory_order_relaxed);
+
+  atomic_store_explicit(&queue->head, 0, memory_order_relaxed);
+  queue->tail = 0;
+  queue->dropped = 0;
+}
+
+void spsc_queue_push(spsc_queue_t *queue, const measurement_record_t *record) {
+  uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  spsc_slot_t *slot = &queue->slots[head % SPSC_QUEUE_SIZE];
+
+  // Invalida a posição antes de sobrescrever, para que uma leitura
+  // concorrente do registro antigo perceba a troca
+  atomic_store_explicit(&slot->seq, SPSC_SEQ_WRITING, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  slot->record = *record;
+
+  atomic_store_explicit(&slot->seq, head, memory_order_release);
+  atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+}
+
+bool spsc_queue_pop(spsc_queue_t *queue, measurement_record_t *record) {
+  while (true) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (queue->tail == head) return false;
+
+    // O produtor deu a volta: pula direto para o registro mais antigo que
+    // ainda está na fila
+    if (head - queue->tail > SPSC_QUEUE_SIZE) {
+      queue->dropped += head - SPSC_QUEUE_SIZE - queue->tail;
+      queue->tail = head - SPSC_QUEUE_SIZE;
+    }
+
+    spsc_slot_t *slot = &queue->slots[queue->tail % SPSC_QUEUE_SIZE];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != queue->tail) continue; // Sobrescrita em andamento
+
+    *record = slot->record;
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) continue;
+
+    queue->tail++;
+    return true;
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "measurement.h"
+
+// Fila lock-free de um produtor e um consumidor (núcleo 0 => núcleo 1) para
+// registros de medição. Quando cheia, o produtor sobrescreve o registro mais
+// antigo em vez de esperar: um display lento nunca segura a amostragem.
+//
+// O produtor é o único que escreve `head`; o consumidor, o único que escreve
+// `tail`. Cada posição guarda a sequência do registro que contém, o que
+// permite ao consumidor detectar que uma posição foi sobrescrita durante a
+// cópia e descartá-la.
+
+#define SPSC_QUEUE_SIZE 8
+
+typedef struct {
+  _Atomic uint32_t seq;
+  measurement_record_t record;
+} spsc_slot_t;
+
+typedef struct {
+  spsc_slot_t slots[SPSC_QUEUE_SIZE];
+  _Atomic uint32_t head; // Próxima sequência a escrever (produtor)
+  uint32_t tail;         // Próxima sequência a ler (consumidor)
+  uint32_t dropped;      // Registros perdidos por sobrescrita (consumidor)
+} spsc_queue_t;
+
+void spsc_queue_init(spsc_queue_t *queue);
+
+// Produtor: nunca bloqueia.
+void spsc_queue_push(spsc_queue_t *queue, const measurement_record_t *record);
+
+// Consumidor: retorna false se a fila estiver vazia.
+bool spsc_queue_pop(spsc_queue_t *queue, measurement_record_t *record);
+
+#endif
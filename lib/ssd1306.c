@@ -1,120 +1,327 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
+#include "profile.h"
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+// Cabeçalho de cada janela: seis comandos de endereçamento precedidos de
+// byte de controle com Co = 1, seguidos do controle de dados (0x40)
+#define SSD1306_WINDOW_HEADER 13
+
+// Custo aproximado, em bytes no barramento, de abrir uma janela de envio:
+// cabeçalho mais o byte de endereço da transação
+#define SSD1306_WINDOW_OVERHEAD (SSD1306_WINDOW_HEADER + 1)
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, uint8_t i2c_port) {
+  (void)external_vcc; // ssd1306_config usa a bomba de carga interna
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
-  ssd->i2c_port = i2c;
+  ssd->i2c_port = i2c_port;
   ssd->bufsize = ssd->pages * ssd->width + 1;
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->tx_buffer = calloc(ssd->bufsize + SSD1306_MAX_WINDOWS * SSD1306_WINDOW_HEADER, sizeof(uint8_t));
+  ssd->flush_busy = false;
+  ssd->shadow_valid = false;
+  ssd->bus_bytes = 0;
+  ssd1306_mark_dirty(ssd, 0xFF, 0, ssd->width - 1);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  // Sequência de inicialização em uma única transação (fluxo de comandos)
+  const uint8_t init_sequence[] = {
+    0x00,
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, HEIGHT - 1,
+    SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, 0x12,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, 0x14,
+    SET_DISP | 0x01,
+  };
+
+  hal_i2c_write(ssd->i2c_port, ssd->address, init_sequence, sizeof(init_sequence));
+  ssd->bus_bytes += sizeof(init_sequence) + 1;
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
+  hal_i2c_write(
     ssd->i2c_port,
     ssd->address,
     ssd->port_buffer,
-    2,
-    false
+    2
   );
+  ssd->bus_bytes += 3;
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
+// Inclui as colunas [x0, x1] na faixa suja de uma página
+static inline void ssd1306_mark_page(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  uint8_t bit = 1 << page;
+  if (!(ssd->dirty_pages & bit)) {
+    ssd->dirty_pages |= bit;
+    ssd->dirty_col_min[page] = x0;
+    ssd->dirty_col_max[page] = x1;
+    return;
+  }
+  if (x0 < ssd->dirty_col_min[page]) ssd->dirty_col_min[page] = x0;
+  if (x1 > ssd->dirty_col_max[page]) ssd->dirty_col_max[page] = x1;
+}
+
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  // page == 0xFF marca todas as páginas
+  if (page != 0xFF) {
+    ssd1306_mark_page(ssd, page, x0, x1);
+    return;
+  }
+  for (uint8_t p = 0; p < ssd->pages; ++p)
+    ssd1306_mark_page(ssd, p, x0, x1);
+}
+
+// Monta no tx_buffer a transação da janela de colunas [c0, c1] e páginas
+// [p0, p1]: comandos de endereçamento e dados na mesma transação. No modo de
+// endereçamento vertical os dados seguem coluna a coluna, página a página.
+static void ssd1306_stage_window(ssd1306_t *ssd, size_t *offset, uint8_t c0, uint8_t c1, uint8_t p0, uint8_t p1) {
+  uint8_t *tx = &ssd->tx_buffer[*offset];
+  size_t len = 0;
+
+  const uint8_t commands[6] = {SET_COL_ADDR, c0, c1, SET_PAGE_ADDR, p0, p1};
+  for (uint8_t i = 0; i < 6; ++i) {
+    tx[len++] = 0x80;
+    tx[len++] = commands[i];
+  }
+
+  tx[len++] = 0x40;
+  for (uint16_t x = c0; x <= c1; ++x) {
+    uint16_t index = x * ssd->pages + 1;
+    for (uint8_t p = p0; p <= p1; ++p) {
+      tx[len++] = ssd->ram_buffer[index + p];
+      ssd->shadow_buffer[index + p] = ssd->ram_buffer[index + p];
+    }
+  }
+
+  ssd->window_offset[ssd->window_count] = *offset;
+  ssd->window_len[ssd->window_count] = len;
+  uint8_t *area = ssd->window_area[ssd->window_count];
+  area[0] = c0;
+  area[1] = c1;
+  area[2] = p0;
+  area[3] = p1;
+  ssd->window_count++;
+  *offset += len;
+}
+
+// Dispara a próxima janela pendente; chamada também na conclusão de cada
+// transferência (contexto de IRQ no RP2040)
+static void ssd1306_send_next_window(void *ctx) {
+  ssd1306_t *ssd = ctx;
+
+  if (ssd->window_next >= ssd->window_count) {
+    ssd->flush_busy = false;
+    PROFILE_STOP(PROFILE_I2C);
+    return;
+  }
+
+  uint8_t w = ssd->window_next++;
+  bool started = hal_i2c_write_async(
     ssd->i2c_port,
     ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
+    &ssd->tx_buffer[ssd->window_offset[w]],
+    ssd->window_len[w],
+    ssd1306_send_next_window,
+    ssd
   );
+
+  // Sem transferência não há conclusão para disparar a próxima: o envio
+  // termina aqui, e as janelas restantes ficam para o próximo
+  if (!started) {
+    ssd->window_failed = w;
+    ssd->flush_busy = false;
+    PROFILE_STOP(PROFILE_I2C);
+    return;
+  }
+  ssd->bus_bytes += ssd->window_len[w] + 1;
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
+// Marca de novo as janelas que não chegaram ao display. O shadow_buffer já
+// tem o conteúdo delas e não serve para recortar as faixas desta vez.
+static void ssd1306_requeue_failed(ssd1306_t *ssd) {
+  if (ssd->window_failed >= ssd->window_count) return;
+
+  for (uint8_t w = ssd->window_failed; w < ssd->window_count; ++w) {
+    const uint8_t *area = ssd->window_area[w];
+    for (uint8_t p = area[2]; p <= area[3]; ++p)
+      ssd1306_mark_page(ssd, p, area[0], area[1]);
+  }
+  ssd->window_failed = ssd->window_count;
+  ssd->shadow_valid = false;
+}
+
+bool ssd1306_flush_busy(ssd1306_t *ssd) {
+  return ssd->flush_busy;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd->flush_busy)
+    hal_idle_wait();
+}
+
+bool ssd1306_send_data(ssd1306_t *ssd) {
+  // O envio anterior ainda está no barramento: as regiões sujas continuam
+  // marcadas e entram no próximo envio
+  if (ssd->flush_busy) return false;
+
+  ssd1306_requeue_failed(ssd);
+
+  // Restringe a faixa de cada página suja às colunas que de fato diferem do
+  // que já está no display (o loop limpa e redesenha o quadro inteiro)
+  if (ssd->shadow_valid) {
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      if (!(ssd->dirty_pages & (1 << p))) continue;
+
+      uint16_t c0 = ssd->dirty_col_min[p];
+      uint16_t c1 = ssd->dirty_col_max[p];
+      while (c0 <= c1 && ssd->ram_buffer[c0 * ssd->pages + p + 1] == ssd->shadow_buffer[c0 * ssd->pages + p + 1]) ++c0;
+      while (c1 > c0 && ssd->ram_buffer[c1 * ssd->pages + p + 1] == ssd->shadow_buffer[c1 * ssd->pages + p + 1]) --c1;
+
+      if (c0 > c1) {
+        ssd->dirty_pages &= ~(1 << p);
+      } else {
+        ssd->dirty_col_min[p] = c0;
+        ssd->dirty_col_max[p] = c1;
+      }
+    }
+  }
+
+  // Agrupa páginas sujas em janelas quando isso custa menos bytes do que
+  // abrir uma janela nova (comandos de endereçamento inclusos)
+  int w_p0 = -1, w_p1 = 0;
+  uint8_t w_c0 = 0, w_c1 = 0;
+  size_t offset = 0;
+
+  ssd->window_count = 0;
+  ssd->window_next = 0;
+
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    if (!(ssd->dirty_pages & (1 << p))) continue;
+
+    uint8_t c0 = ssd->dirty_col_min[p];
+    uint8_t c1 = ssd->dirty_col_max[p];
+
+    if (w_p0 >= 0) {
+      uint8_t m_c0 = c0 < w_c0 ? c0 : w_c0;
+      uint8_t m_c1 = c1 > w_c1 ? c1 : w_c1;
+      uint32_t merged = (uint32_t)(m_c1 - m_c0 + 1) * (p - w_p0 + 1);
+      uint32_t split = (uint32_t)(w_c1 - w_c0 + 1) * (w_p1 - w_p0 + 1) + (c1 - c0 + 1) + SSD1306_WINDOW_OVERHEAD;
+
+      if (merged <= split) {
+        w_c0 = m_c0;
+        w_c1 = m_c1;
+        w_p1 = p;
+        continue;
+      }
+      ssd1306_stage_window(ssd, &offset, w_c0, w_c1, w_p0, w_p1);
+    }
+
+    w_p0 = w_p1 = p;
+    w_c0 = c0;
+    w_c1 = c1;
+  }
+
+  if (w_p0 >= 0)
+    ssd1306_stage_window(ssd, &offset, w_c0, w_c1, w_p0, w_p1);
+
+  ssd->dirty_pages = 0;
+  ssd->shadow_valid = true;
+  ssd->window_failed = ssd->window_count;
+
+  // As janelas seguem por DMA enquanto o próximo quadro é renderizado no
+  // ram_buffer; o tx_buffer só é reescrito no próximo envio
+  if (ssd->window_count) {
+    ssd->flush_busy = true;
+    PROFILE_START(PROFILE_I2C);
+    ssd1306_send_next_window(ssd);
+  }
+
+  // A primeira janela não começou: o chamador tenta de novo mais tarde
+  return ssd->window_failed != 0 || ssd->window_count == 0;
+}
+
+// O ram_buffer segue o endereçamento vertical do controlador: cada coluna
+// ocupa `pages` bytes consecutivos e cada byte guarda 8 linhas (LSB em cima).
+static inline uint8_t *ssd1306_column(ssd1306_t *ssd, uint8_t x) {
+  return &ssd->ram_buffer[x * ssd->pages + 1];
+}
+
+// Aplica `mask` ao byte da página indicada: liga ou apaga os bits marcados
+static inline void ssd1306_apply_mask(uint8_t *byte, uint8_t mask, bool value) {
   if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
+    *byte |= mask;
   else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+    *byte &= ~mask;
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height) return;
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  ssd1306_mark_page(ssd, y >> 3, x, x);
+  ssd1306_apply_mask(&ssd1306_column(ssd, x)[y >> 3], 1 << (y & 0b111), value);
 }
 
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  // O buffer inteiro (exceto o byte de controle) é preenchido de uma vez
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0xFF, 0, ssd->width - 1);
+}
 
+void ssd1306_compose(ssd1306_t *ssd, const uint8_t *background) {
+  // Camada estática copiada de uma vez; a sobreposição dinâmica é desenhada
+  // por cima e o envio parcial descarta o que não mudou
+  memcpy(ssd->ram_buffer + 1, background, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0xFF, 0, ssd->width - 1);
+}
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+  if (width == 0 || height == 0) return;
+
+  uint8_t right = left + width - 1;
+  uint8_t bottom = top + height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    for (uint16_t x = left; x <= right && x < ssd->width; ++x)
+      ssd1306_vline(ssd, x, top, bottom, value);
+    return;
   }
+
+  ssd1306_hline(ssd, left, right, top, value);
+  ssd1306_hline(ssd, left, right, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom, value);
+  ssd1306_vline(ssd, right, top, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas horizontais e verticais usam os caminhos por byte
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -142,15 +349,44 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
     }
 }
 
-
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y >= ssd->height || x0 >= ssd->width || x0 > x1) return;
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+
+  // Mesma máscara em todas as colunas, com passo de uma coluna no buffer
+  uint8_t page = y >> 3;
+  uint8_t mask = 1 << (y & 0b111);
+  uint8_t *byte = &ssd1306_column(ssd, x0)[page];
+  uint8_t *end = byte + (x1 - x0 + 1) * ssd->pages;
+
+  if (value) {
+    for (; byte != end; byte += ssd->pages) *byte |= mask;
+  } else {
+    for (; byte != end; byte += ssd->pages) *byte &= ~mask;
+  }
+
+  ssd1306_mark_page(ssd, page, x0, x1);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x >= ssd->width || y0 >= ssd->height || y0 > y1) return;
+  if (y1 >= ssd->height) y1 = ssd->height - 1;
+
+  // Páginas consecutivas da mesma coluna: máscaras parciais nas pontas e
+  // bytes inteiros no meio
+  uint8_t *column = ssd1306_column(ssd, x);
+  uint8_t p0 = y0 >> 3;
+  uint8_t p1 = y1 >> 3;
+  uint8_t first_mask = 0xFF << (y0 & 0b111);
+  uint8_t last_mask = 0xFF >> (7 - (y1 & 0b111));
+
+  for (uint8_t p = p0; p <= p1; ++p) {
+    uint8_t mask = 0xFF;
+    if (p == p0) mask &= first_mask;
+    if (p == p1) mask &= last_mask;
+    ssd1306_apply_mask(&column[p], mask, value);
+    ssd1306_mark_page(ssd, p, x, x);
+  }
 }
 
 // Função para desenhar um caractere
@@ -159,7 +395,7 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
   uint16_t index = 0;
 
   // Verifica o caractere e calcula o índice correspondente na fonte
-  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
+  if ((unsigned char)c >= ' ' && (unsigned char)c <= 0x7F) // ASCII imprimível e o Ω (0x7F)
   {
     index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
   }
@@ -169,15 +405,34 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  ssd1306_blit_glyph(ssd, &font[index], x, y);
+}
+
+void ssd1306_blit_glyph(ssd1306_t *ssd, const uint8_t *glyph, uint8_t x, uint8_t y)
+{
+  if (x >= ssd->width || y >= ssd->height) return;
+
+  // Cada coluna do glifo já está no formato de um byte de página. Com o
+  // deslocamento vertical a célula de 8 linhas ocupa até duas páginas: a
+  // parte alta da coluna vai para `page` e a parte baixa para `page + 1`.
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  uint8_t upper_mask = 0xFF << shift;
+  uint8_t lower_mask = 0xFF >> (8 - shift);
+  bool has_lower = shift && page + 1 < ssd->pages;
+  uint8_t columns = ssd->width - x < 8 ? ssd->width - x : 8;
+
+  for (uint8_t i = 0; i < columns; ++i)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
+    uint8_t *column = ssd1306_column(ssd, x + i);
+    column[page] = (column[page] & ~upper_mask) | (glyph[i] << shift);
+    if (has_lower)
+      column[page + 1] = (column[page + 1] & ~lower_mask) | (glyph[i] >> (8 - shift));
   }
+
+  ssd1306_mark_page(ssd, page, x, x + columns - 1);
+  if (has_lower)
+    ssd1306_mark_page(ssd, page + 1, x, x + columns - 1);
 }
 
 // Função para desenhar uma string
@@ -198,3 +453,26 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
     }
   }
 }
+
+uint16_t ssd1306_text_width(const char *str)
+{
+  uint16_t width = 0;
+  while (*str++)
+    width += SSD1306_GLYPH_WIDTH;
+  return width;
+}
+
+void ssd1306_draw_text(ssd1306_t *ssd, const char *str, int x, uint8_t y, ssd1306_align_t align)
+{
+  if (align == SSD1306_ALIGN_RIGHT)
+    x -= ssd1306_text_width(str);
+  else if (align == SSD1306_ALIGN_CENTER)
+    x -= ssd1306_text_width(str) / 2;
+
+  for (; *str; ++str, x += SSD1306_GLYPH_WIDTH)
+  {
+    if (x < 0) continue;
+    if (x + SSD1306_GLYPH_WIDTH > ssd->width) break;
+    ssd1306_draw_char(ssd, *str, x, y);
+  }
+}
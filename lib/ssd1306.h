@@ -1,10 +1,25 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include "hal.h"
 
 #define WIDTH 128
 #define HEIGHT 64
 
+// Máximo de janelas (uma por página) em um envio parcial
+#define SSD1306_MAX_WINDOWS 8
+
+// Fonte de largura fixa (font.h): ' ' a '~' e o Ω no código 0x7F
+#define SSD1306_GLYPH_WIDTH 8
+
+// Posição horizontal do texto de ssd1306_draw_text em relação a `x`
+typedef enum {
+  SSD1306_ALIGN_LEFT,   // `x` é a borda esquerda
+  SSD1306_ALIGN_CENTER, // `x` é o centro
+  SSD1306_ALIGN_RIGHT,  // `x` é a borda direita (primeira coluna livre)
+} ssd1306_align_t;
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -27,23 +42,56 @@ typedef enum {
 
 typedef struct {
   uint8_t width, height, pages, address;
-  i2c_inst_t *i2c_port;
+  uint8_t i2c_port;
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  // Controle de atualização parcial: páginas e colunas alteradas desde o
+  // último envio e cópia do conteúdo já presente na GDDRAM do display
+  uint8_t *shadow_buffer;
+  // Buffer de transmissão: as janelas do último envio, transmitidas por DMA
+  // enquanto o próximo quadro é desenhado no ram_buffer
+  uint8_t *tx_buffer;
+  uint16_t window_offset[SSD1306_MAX_WINDOWS];
+  uint16_t window_len[SSD1306_MAX_WINDOWS];
+  uint8_t window_area[SSD1306_MAX_WINDOWS][4]; // c0, c1, p0, p1
+  uint8_t window_count, window_next;
+  // Primeira janela que não pôde começar (I2C ou DMA ocupados); ela e as
+  // seguintes voltam a ficar sujas no próximo envio. window_count: nenhuma.
+  volatile uint8_t window_failed;
+  volatile bool flush_busy;
+  bool shadow_valid;
+  uint8_t dirty_pages;
+  uint8_t dirty_col_min[8];
+  uint8_t dirty_col_max[8];
+  uint32_t bus_bytes; // Bytes escritos no barramento I2C (incluindo endereço)
 } ssd1306_t;
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, uint8_t i2c_port);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
-void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_flush_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_compose(ssd1306_t *ssd, const uint8_t *background);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+void ssd1306_blit_glyph(ssd1306_t *ssd, const uint8_t *glyph, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+// Largura do texto em pixels.
+uint16_t ssd1306_text_width(const char *str);
+
+// Texto em uma única linha, sem a quebra de ssd1306_draw_string. Caracteres
+// que não cabem inteiros no display são omitidos.
+void ssd1306_draw_text(ssd1306_t *ssd, const char *str, int x, uint8_t y, ssd1306_align_t align);
+
+#endif
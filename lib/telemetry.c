@@ -0,0 +1,98 @@
+#include <string.h>
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "hal.h"
+
+static telemetry_sample_t ring[TELEMETRY_RING_SIZE];
+static uint32_t ring_head, ring_tail;
+static uint16_t next_sequence;
+static uint32_t dropped;
+
+static uint8_t tx_buffer[TELEMETRY_TX_PACKETS * TELEMETRY_PACKET_SIZE];
+static size_t tx_len;
+static uint64_t tx_since_us; // Desde quando há bytes esperando no buffer
+
+void telemetry_init(void) {
+  ring_head = ring_tail = 0;
+  next_sequence = 0;
+  dropped = 0;
+  tx_len = 0;
+}
+
+// Campos no formato do fio, iguais nas duas versões do pipeline
+#ifdef OHMIMETRO_FIXED_POINT
+static uint32_t wire_adc_mean(adc_mean_t value) {
+  return value;
+}
+
+static uint64_t wire_resistance(resistance_t value) {
+  return value;
+}
+#else
+static uint32_t wire_adc_mean(adc_mean_t value) {
+  return (uint32_t)(value * 65536.0f + 0.5f);
+}
+
+static uint64_t wire_resistance(resistance_t value) {
+  if (value == RESISTANCE_INVALID || value >= 1.8e16f) return UINT64_MAX;
+  return (uint64_t)(value * 1000.0f + 0.5f);
+}
+#endif
+
+void telemetry_sample_from_record(const measurement_record_t *record, telemetry_sample_t *sample) {
+  sample->type = TELEMETRY_RECORD_MEASUREMENT;
+  sample->range = record->range;
+  sample->sequence = 0;
+  sample->timestamp_ms = record->timestamp_ms;
+  sample->adc_mean_q16 = wire_adc_mean(record->average_adc);
+  sample->adc_variance = record->adc_variance;
+  sample->sample_count = record->sample_count;
+  sample->resistance_milliohms = wire_resistance(record->resistance);
+  sample->closest = record->closest_e24;
+  sample->series = ESERIES_E24;
+}
+
+void telemetry_push(const measurement_record_t *record) {
+  if (ring_head - ring_tail == TELEMETRY_RING_SIZE) {
+    ring_tail++;
+    dropped++;
+  }
+
+  telemetry_sample_t *sample = &ring[ring_head % TELEMETRY_RING_SIZE];
+  telemetry_sample_from_record(record, sample);
+  sample->sequence = next_sequence++;
+  ring_head++;
+}
+
+bool telemetry_send(const telemetry_sample_t *sample) {
+  if (tx_len + TELEMETRY_FRAME_MAX > sizeof(tx_buffer)) return false;
+  if (tx_len == 0) tx_since_us = hal_time_us();
+  tx_len += telemetry_encode_frame(sample, tx_buffer + tx_len);
+  return true;
+}
+
+void telemetry_flush(void) {
+  uint64_t now = hal_time_us();
+
+  while (ring_tail != ring_head && tx_len + TELEMETRY_FRAME_MAX <= sizeof(tx_buffer)) {
+    if (tx_len == 0) tx_since_us = now;
+    tx_len += telemetry_encode_frame(&ring[ring_tail % TELEMETRY_RING_SIZE], tx_buffer + tx_len);
+    ring_tail++;
+  }
+
+  // Só pacotes completos, exceto quando o resto já esperou demais
+  size_t ready = tx_len - tx_len % TELEMETRY_PACKET_SIZE;
+  if (ready == 0 && tx_len && now - tx_since_us >= TELEMETRY_MAX_LATENCY_US) ready = tx_len;
+  if (ready == 0) return;
+
+  size_t written = hal_usb_write(tx_buffer, ready);
+  if (written == 0) return;
+
+  tx_len -= written;
+  memmove(tx_buffer, tx_buffer + written, tx_len);
+  tx_since_us = now;
+}
+
+uint32_t telemetry_dropped(void) {
+  return dropped;
+}
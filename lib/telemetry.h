@@ -0,0 +1,42 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "measurement.h"
+#include "telemetry_frame.h"
+
+// Telemetria binária das medições pela serial USB (formato em
+// telemetry_frame.h). As medições entram num anel e são codificadas em lote
+// num buffer de transmissão enviado em pacotes USB completos de 64 bytes; um
+// pacote incompleto só sai depois de TELEMETRY_MAX_LATENCY_US. Nada bloqueia:
+// sem host conectado ou com a USB atrasada, o anel descarta os registros mais
+// antigos (a sequência mostra a lacuna ao decodificador).
+
+#define TELEMETRY_RING_SIZE 64        // Registros aguardando codificação
+#define TELEMETRY_PACKET_SIZE 64      // Pacote bulk da USB full-speed
+#define TELEMETRY_TX_PACKETS 8
+#define TELEMETRY_MAX_LATENCY_US 100000
+
+void telemetry_init(void);
+
+// Campos da medição no formato do fio, com sequência 0.
+void telemetry_sample_from_record(const measurement_record_t *record, telemetry_sample_t *sample);
+
+// Enfileira a medição. Com o anel cheio, sobrescreve a mais antiga.
+void telemetry_push(const measurement_record_t *record);
+
+// Codifica o registro direto no buffer de transmissão, depois do que já
+// estiver nele, se houver espaço (false do contrário). Para envios em lote
+// que não podem perder registros, como a exportação do registro na flash.
+bool telemetry_send(const telemetry_sample_t *sample);
+
+// Codifica o que couber no buffer de transmissão e envia os pacotes
+// completos que a USB aceitar. Chamada periodicamente, no mesmo núcleo de
+// telemetry_push.
+void telemetry_flush(void);
+
+// Registros descartados com o anel cheio desde telemetry_init.
+uint32_t telemetry_dropped(void);
+
+#endif
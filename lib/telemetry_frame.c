@@ -0,0 +1,110 @@
+#include "telemetry_frame.h"
+#include "crc.h"
+
+size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst) {
+  size_t code_at = 0, out = 1;
+  uint8_t code = 1;
+
+  for (size_t i = 0; i < len; ++i) {
+    if (src[i]) {
+      dst[out++] = src[i];
+      code++;
+    }
+    // Fim do bloco: no zero ou com 254 bytes não nulos
+    if (!src[i] || code == 0xFF) {
+      dst[code_at] = code;
+      code_at = out++;
+      code = 1;
+    }
+  }
+
+  dst[code_at] = code;
+  return out;
+}
+
+size_t cobs_decode(const uint8_t *src, size_t len, uint8_t *dst) {
+  size_t in = 0, out = 0;
+
+  while (in < len) {
+    uint8_t code = src[in++];
+    if (code == 0 || in + code - 1 > len) return 0;
+
+    for (uint8_t i = 1; i < code; ++i) {
+      if (!src[in]) return 0;
+      dst[out++] = src[in++];
+    }
+    // Bloco curto implica um zero, exceto no fim do quadro
+    if (code != 0xFF && in < len) dst[out++] = 0;
+  }
+
+  return out;
+}
+
+static void put_u16(uint8_t *dst, uint16_t value) {
+  dst[0] = value;
+  dst[1] = value >> 8;
+}
+
+static void put_u32(uint8_t *dst, uint32_t value) {
+  put_u16(dst, value);
+  put_u16(dst + 2, value >> 16);
+}
+
+static void put_u64(uint8_t *dst, uint64_t value) {
+  put_u32(dst, value);
+  put_u32(dst + 4, value >> 32);
+}
+
+static uint16_t get_u16(const uint8_t *src) {
+  return src[0] | (uint16_t)src[1] << 8;
+}
+
+static uint32_t get_u32(const uint8_t *src) {
+  return get_u16(src) | (uint32_t)get_u16(src + 2) << 16;
+}
+
+static uint64_t get_u64(const uint8_t *src) {
+  return get_u32(src) | (uint64_t)get_u32(src + 4) << 32;
+}
+
+size_t telemetry_encode_frame(const telemetry_sample_t *sample, uint8_t *frame) {
+  uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+
+  payload[0] = sample->type;
+  payload[1] = sample->range;
+  put_u16(payload + 2, sample->sequence);
+  put_u32(payload + 4, sample->timestamp_ms);
+  put_u32(payload + 8, sample->adc_mean_q16);
+  put_u32(payload + 12, sample->adc_variance);
+  put_u32(payload + 16, sample->sample_count);
+  put_u64(payload + 20, sample->resistance_milliohms);
+  put_u16(payload + 28, sample->closest.mantissa);
+  payload[30] = (uint8_t)sample->closest.exponent;
+  payload[31] = sample->series;
+  put_u32(payload + TELEMETRY_RECORD_SIZE, crc32_update(0, payload, TELEMETRY_RECORD_SIZE));
+
+  size_t len = cobs_encode(payload, sizeof(payload), frame);
+  frame[len++] = 0;
+  return len;
+}
+
+bool telemetry_decode_frame(const uint8_t *frame, size_t len, telemetry_sample_t *sample) {
+  uint8_t payload[TELEMETRY_FRAME_MAX];
+
+  if (len > sizeof(payload) || cobs_decode(frame, len, payload) != TELEMETRY_PAYLOAD_SIZE) return false;
+  if (get_u32(payload + TELEMETRY_RECORD_SIZE) != crc32_update(0, payload, TELEMETRY_RECORD_SIZE)) return false;
+  if (payload[0] != TELEMETRY_RECORD_MEASUREMENT && payload[0] != TELEMETRY_RECORD_LOG) return false;
+
+  sample->type = payload[0];
+  sample->range = payload[1];
+  sample->sequence = get_u16(payload + 2);
+  sample->timestamp_ms = get_u32(payload + 4);
+  sample->adc_mean_q16 = get_u32(payload + 8);
+  sample->adc_variance = get_u32(payload + 12);
+  sample->sample_count = get_u32(payload + 16);
+  sample->resistance_milliohms = get_u64(payload + 20);
+  sample->closest.mantissa = get_u16(payload + 28);
+  sample->closest.exponent = (int8_t)payload[30];
+  sample->series = payload[31];
+  return true;
+}
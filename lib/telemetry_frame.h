@@ -0,0 +1,68 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "eseries.h"
+
+// Formato binário da telemetria, compartilhado pelo firmware e pelo
+// decodificador de host (host/telemetry_decode.c).
+//
+// Cada quadro é o registro de 32 bytes (little-endian) seguido do CRC-32 do
+// registro, codificado em COBS e terminado por um byte 0. O COBS garante que
+// o 0 só aparece como delimitador: um leitor que comece no meio do fluxo, ou
+// que encontre texto do stdio entre quadros, se ressincroniza no próximo 0.
+//
+//   off  tipo  campo
+//    0   u8    tipo do registro (TELEMETRY_RECORD_*)
+//    1   u8    faixa de referência
+//    2   u16   sequência (detecta registros perdidos)
+//    4   u32   instante, em ms desde a partida
+//    8   u32   código médio do ADC, Q16
+//   12   u32   variância das médias dos blocos, em 1/65536 de código²
+//   16   u32   amostras na medição
+//   20   u64   resistência, em mΩ (UINT64_MAX: fundo de escala)
+//   28   u16   mantissa do valor comercial (0: fora da faixa)
+//   30   i8    expoente do valor comercial
+//   31   u8    série do valor comercial (eseries_t)
+//
+// Os registros exportados do registro na flash (flash_log.h) usam o mesmo
+// formato, com a sequência própria do registro e variância 0.
+
+#define TELEMETRY_RECORD_MEASUREMENT 1 // Medição ao vivo
+#define TELEMETRY_RECORD_LOG 2         // Medição lida do registro na flash
+
+#define TELEMETRY_RECORD_SIZE 32
+#define TELEMETRY_PAYLOAD_SIZE (TELEMETRY_RECORD_SIZE + 4)
+
+// Maior quadro: payload + 1 byte de COBS (até 254 bytes) + delimitador
+#define TELEMETRY_FRAME_MAX (TELEMETRY_PAYLOAD_SIZE + 2)
+
+typedef struct {
+  uint8_t type;
+  uint8_t range;
+  uint16_t sequence;
+  uint32_t timestamp_ms;
+  uint32_t adc_mean_q16;
+  uint32_t adc_variance;
+  uint32_t sample_count;
+  uint64_t resistance_milliohms;
+  eseries_value_t closest;
+  uint8_t series;
+} telemetry_sample_t;
+
+// COBS: `dst` precisa de len + len / 254 + 1 bytes. Retorna o tamanho escrito.
+size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+
+// Decodifica um quadro sem o delimitador. Retorna o tamanho decodificado, ou
+// 0 se o quadro for inválido (contém 0 ou termina no meio de um bloco).
+size_t cobs_decode(const uint8_t *src, size_t len, uint8_t *dst);
+
+// Quadro completo, com o delimitador. Retorna o tamanho (até TELEMETRY_FRAME_MAX).
+size_t telemetry_encode_frame(const telemetry_sample_t *sample, uint8_t *frame);
+
+// Quadro sem o delimitador. false se o tamanho, o tipo ou o CRC não conferirem.
+bool telemetry_decode_frame(const uint8_t *frame, size_t len, telemetry_sample_t *sample);
+
+#endif
@@ -1,17 +1,22 @@
 #include <stdio.h>
-#include "pico/stdlib.h"
-#include "hardware/pio.h"
-#include "hardware/clocks.h"
-
-// Biblioteca gerada pelo arquivo .pio durante compilação.
-#include "ws2818b.pio.h"
+#include "hal.h"
 
 // Definição do número de LEDs e pino.
 #define LED_COUNT 25
 #define LED_PIN 7
 
-// Global brightness setting (0-255, default is full brightness)
-uint8_t global_brightness = 128;
+// Matriz 5x5 da BitDogLab: (0, 0) é o canto superior esquerdo e a cadeia
+// percorre as linhas em serpentina a partir do canto inferior direito
+#define MATRIX_SIZE 5
+
+// Desenho de 5x5 para npDrawSprite: uma linha por byte, de cima para baixo,
+// com o bit 4 na coluna 0
+typedef uint8_t np_sprite_t[MATRIX_SIZE];
+
+// Brilho da matriz (0-255), fixado na compilação junto com a gama
+#ifndef NP_BRIGHTNESS
+#define NP_BRIGHTNESS 255
+#endif
 
 // Definição de pixel GRB
 struct pixel_t {
@@ -23,33 +28,55 @@ typedef pixel_t npLED_t; // Mudança de nome de "struct pixel_t" para "npLED_t"
 // Declaração do buffer de pixels que formam a matriz.
 npLED_t leds[LED_COUNT];
 
-// Variáveis para uso da máquina PIO.
-PIO np_pio;
-uint sm;
+// Quadro empacotado enviado por DMA: uma palavra por LED com G, R e B nos
+// bits 31..8 (a máquina PIO desloca 24 bits por palavra, MSB primeiro).
+uint32_t np_frame[LED_COUNT];
+
+// Correção de gama 2,2: os LEDs respondem de forma linear à intensidade,
+// enquanto a vista percebe o brilho em escala próxima da logarítmica; sem a
+// correção, os tons escuros (marrom, cinza) saem claros demais e se
+// confundem. Cada entrada é round(255 * (v / 255)^2,2), escalada por
+// NP_BRIGHTNESS na compilação
+#define G(v) (uint8_t)(((v) * (NP_BRIGHTNESS + 1)) >> 8)
+const uint8_t brightness_lut[256] = {
+  G(  0), G(  0), G(  0), G(  0), G(  0), G(  0), G(  0), G(  0), G(  0), G(  0), G(  0), G(  0),
+  G(  0), G(  0), G(  0), G(  1), G(  1), G(  1), G(  1), G(  1), G(  1), G(  1), G(  1), G(  1),
+  G(  1), G(  2), G(  2), G(  2), G(  2), G(  2), G(  2), G(  2), G(  3), G(  3), G(  3), G(  3),
+  G(  3), G(  4), G(  4), G(  4), G(  4), G(  5), G(  5), G(  5), G(  5), G(  6), G(  6), G(  6),
+  G(  6), G(  7), G(  7), G(  7), G(  8), G(  8), G(  8), G(  9), G(  9), G(  9), G( 10), G( 10),
+  G( 11), G( 11), G( 11), G( 12), G( 12), G( 13), G( 13), G( 13), G( 14), G( 14), G( 15), G( 15),
+  G( 16), G( 16), G( 17), G( 17), G( 18), G( 18), G( 19), G( 19), G( 20), G( 20), G( 21), G( 22),
+  G( 22), G( 23), G( 23), G( 24), G( 25), G( 25), G( 26), G( 26), G( 27), G( 28), G( 28), G( 29),
+  G( 30), G( 30), G( 31), G( 32), G( 33), G( 33), G( 34), G( 35), G( 35), G( 36), G( 37), G( 38),
+  G( 39), G( 39), G( 40), G( 41), G( 42), G( 43), G( 43), G( 44), G( 45), G( 46), G( 47), G( 48),
+  G( 49), G( 49), G( 50), G( 51), G( 52), G( 53), G( 54), G( 55), G( 56), G( 57), G( 58), G( 59),
+  G( 60), G( 61), G( 62), G( 63), G( 64), G( 65), G( 66), G( 67), G( 68), G( 69), G( 70), G( 71),
+  G( 73), G( 74), G( 75), G( 76), G( 77), G( 78), G( 79), G( 81), G( 82), G( 83), G( 84), G( 85),
+  G( 87), G( 88), G( 89), G( 90), G( 91), G( 93), G( 94), G( 95), G( 97), G( 98), G( 99), G(100),
+  G(102), G(103), G(105), G(106), G(107), G(109), G(110), G(111), G(113), G(114), G(116), G(117),
+  G(119), G(120), G(121), G(123), G(124), G(126), G(127), G(129), G(130), G(132), G(133), G(135),
+  G(137), G(138), G(140), G(141), G(143), G(145), G(146), G(148), G(149), G(151), G(153), G(154),
+  G(156), G(158), G(159), G(161), G(163), G(165), G(166), G(168), G(170), G(172), G(173), G(175),
+  G(177), G(179), G(181), G(182), G(184), G(186), G(188), G(190), G(192), G(194), G(196), G(197),
+  G(199), G(201), G(203), G(205), G(207), G(209), G(211), G(213), G(215), G(217), G(219), G(221),
+  G(223), G(225), G(227), G(229), G(231), G(234), G(236), G(238), G(240), G(242), G(244), G(246),
+  G(248), G(251), G(253), G(255),
+};
+#undef G
 
-// Function to set the global brightness
-void npSetBrightness(uint8_t brightness) {
-  global_brightness = brightness;
-}
+// Hash (FNV-1a por palavra) do último quadro enviado: um quadro igual não é
+// retransmitido
+uint32_t np_sent_hash;
+bool np_has_sent = false;
+uint32_t np_frames_skipped = 0;
 
 /**
  * Inicializa a máquina PIO para controle da matriz de LEDs.
  */
 void npInit(uint pin) {
-
-  // Cria programa PIO.
-  uint offset = pio_add_program(pio0, &ws2818b_program);
-  np_pio = pio0;
-
-  // Toma posse de uma máquina PIO.
-  sm = pio_claim_unused_sm(np_pio, false);
-  if (sm < 0) {
-    np_pio = pio1;
-    sm = pio_claim_unused_sm(np_pio, true); // Se nenhuma máquina estiver livre, panic!
-  }
-
-  // Inicia programa na máquina PIO obtida.
-  ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+  // Carrega o programa ws2818b em uma máquina PIO livre.
+  hal_ws2818b_init(pin);
+  np_has_sent = false;
 
   // Limpa buffer de pixels.
   for (uint i = 0; i < LED_COUNT; ++i) {
@@ -68,6 +95,62 @@ void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t
   leds[index].B = b;
 }
 
+/**
+ * Índice na cadeia do LED na coluna `x` e na linha `y`.
+ */
+uint npIndex(uint x, uint y) {
+  uint k = y * MATRIX_SIZE + (y % 2 == 0 ? x : MATRIX_SIZE - 1 - x);
+  return LED_COUNT - 1 - k;
+}
+
+/**
+ * Atribui uma cor ao LED em (x, y); fora da matriz não faz nada.
+ */
+void npSetPixel(int x, int y, const uint8_t r, const uint8_t g, const uint8_t b) {
+  if (x < 0 || y < 0 || x >= MATRIX_SIZE || y >= MATRIX_SIZE) return;
+  npSetLED(npIndex(x, y), r, g, b);
+}
+
+/**
+ * Acende na cor dada os pontos marcados do desenho; os demais não mudam.
+ */
+void npDrawSprite(const np_sprite_t sprite, const uint8_t r, const uint8_t g, const uint8_t b) {
+  for (int y = 0; y < MATRIX_SIZE; ++y)
+    for (int x = 0; x < MATRIX_SIZE; ++x)
+      if (sprite[y] & (0x10 >> x)) npSetPixel(x, y, r, g, b);
+}
+
+/**
+ * Barra na linha `y`, da coluna 0 para a direita, com `value` de
+ * `full_scale` (arredondado para o LED mais próximo e limitado à linha).
+ */
+void npDrawBar(int y, uint32_t value, uint32_t full_scale, const uint8_t r, const uint8_t g, const uint8_t b) {
+  if (full_scale == 0) return;
+  if (value > full_scale) value = full_scale;
+
+  uint32_t lit = (value * MATRIX_SIZE + full_scale / 2) / full_scale;
+  for (uint32_t x = 0; x < lit; ++x)
+    npSetPixel(x, y, r, g, b);
+}
+
+/**
+ * Indicador de desvio na linha `y`: o LED central, na cor `zero`, marca o
+ * zero e a barra, na cor `bar`, cresce para a esquerda (negativo) ou para a
+ * direita (positivo), com os dois LEDs de cada lado valendo `full_scale`.
+ */
+void npDrawGauge(int y, int32_t value, uint32_t full_scale, const uint8_t zero[3], const uint8_t bar[3]) {
+  int half = MATRIX_SIZE / 2;
+  uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+
+  npSetPixel(half, y, zero[0], zero[1], zero[2]);
+  if (full_scale == 0) return;
+  if (magnitude > full_scale) magnitude = full_scale;
+
+  int lit = (int)((magnitude * half + full_scale / 2) / full_scale);
+  for (int i = 1; i <= lit; ++i)
+    npSetPixel(value < 0 ? half - i : half + i, y, bar[0], bar[1], bar[2]);
+}
+
 /**
  * Limpa o buffer de pixels.
  */
@@ -80,16 +163,30 @@ void npClear() {
  * Escreve os dados do buffer nos LEDs.
  */
 void npWrite() {
-  // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
+  // O quadro anterior ainda está sendo lido pelo DMA (ou no intervalo de RESET)
+  while (hal_ws2818b_busy())
+    hal_idle_wait();
+
+  // Monta o quadro empacotado com o brilho já aplicado pela tabela, e o
+  // hash dele na mesma passada
+  uint32_t hash = 2166136261u;
   for (uint i = 0; i < LED_COUNT; ++i) {
-    // Scale each color component by the global brightness
-    uint8_t g = (leds[i].G * (global_brightness + 1)) >> 8;
-    uint8_t r = (leds[i].R * (global_brightness + 1)) >> 8;
-    uint8_t b = (leds[i].B * (global_brightness + 1)) >> 8;
-
-    pio_sm_put_blocking(np_pio, sm, g);
-    pio_sm_put_blocking(np_pio, sm, r);
-    pio_sm_put_blocking(np_pio, sm, b);
+    np_frame[i] = ((uint32_t)brightness_lut[leds[i].G] << 24) |
+                  ((uint32_t)brightness_lut[leds[i].R] << 16) |
+                  ((uint32_t)brightness_lut[leds[i].B] << 8);
+    hash = (hash ^ np_frame[i]) * 16777619u;
+  }
+
+  // Os LEDs mantêm as cores sem atualização: um quadro igual ao último
+  // enviado não ocupa o DMA nem a PIO
+  if (np_has_sent && hash == np_sent_hash) {
+    np_frames_skipped++;
+    return;
+  }
+
+  // O DMA alimenta a máquina PIO e um alarme encerra o sinal de RESET
+  if (hal_ws2818b_write(np_frame, LED_COUNT)) {
+    np_sent_hash = hash;
+    np_has_sent = true;
   }
-  sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
 }
@@ -1,82 +1,343 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
-#include "pico/stdlib.h"
-#include "pico/bootrom.h"
-#include "hardware/adc.h"
-#include "hardware/i2c.h"
-#include "hardware/pio.h"
-#include "hardware/clocks.h"
+#include "lib/hal.h"
 #include "lib/ssd1306.h"
-#include "lib/font.h"
 #include "lib/ws2818b.h"
-
-// Biblioteca gerada pelo arquivo .pio durante compilação.
-#include "ws2818b.pio.h"
+#include "lib/acquisition.h"
+#include "lib/sample_stats.h"
+#include "lib/ranging.h"
+#include "lib/probe.h"
+#include "lib/multichannel.h"
+#include "lib/calibration.h"
+#include "lib/scheduler.h"
+#include "lib/telemetry.h"
+#include "lib/flash_log.h"
+#include "lib/sorting.h"
+#include "lib/measurement.h"
+#include "lib/spsc_queue.h"
+#include "lib/layout_bitmap.h"
+#include "lib/profile.h"
 
 // Definição de macros gerais
 #define ADC_PIN 28
 #define BTN_B_PIN 6
 #define BTN_A_PIN 5
-float adc_resolution = 4095;
+
+// Aquisição a 200 amostras por ciclo da rede (12 kHz em 60 Hz), em blocos de
+// 100 amostras somados dois a dois pelo filtro do zumbido (mains_filter.h):
+// cada janela de um ciclo (16,7 ms) é vista pelo detector das ponteiras. Com
+// a peça acomodada, uma medição estável termina em 2 janelas (400 amostras,
+// 33 ms); com ruído, segue até 1000 amostras (5 janelas, 83 ms) ou até o
+// intervalo de confiança ficar dentro de 10% do passo da E24 (cerca de 1%)
+#define MAINS_HZ 60 // 50 onde a rede for de 50 Hz
+#define ADC_INPUT 2
+#define MIN_SAMPLES_PER_MEASURE 300
+#define MAX_SAMPLES_PER_MEASURE 1000
+#define STEP_FRACTION FRACTION(0.1)
+
+#ifdef OHMIMETRO_RATIOMETRIC
+// Modo ratiométrico: o trilho de 3,3 V que alimenta os GPIOs das faixas (o
+// topo do divisor) chega à entrada 1 (GPIO 27, eixo do joystick da BitDogLab,
+// sem uso aqui) por dois resistores iguais, abaixo da referência do ADC. As
+// duas entradas se alternam, cada uma com metade da taxa, e a medição mínima
+// passa a levar 3 janelas (50 ms).
+#define ADC_REFERENCE_INPUT 1
+#define ADC_REFERENCE_GAIN_Q16 (2u << 16)
+#endif
+
+#ifdef OHMIMETRO_MULTICHANNEL
+// Modo multicanal (multichannel.h): um divisor em cada entrada externa do
+// ADC, da 0 (GPIO 26) à 2 (GPIO 28, o divisor da placa). As entradas 0 e 1
+// são as do joystick da BitDogLab, desligado no gabarito. O round-robin dá a
+// cada canal as mesmas 200 amostras por ciclo da rede (36 kHz no total), e
+// os três medem ao mesmo tempo, no tempo de um.
+#define CHANNEL_COUNT 3
+#define CHANNEL_FIRST_INPUT 0
+#define ADC_SAMPLE_RATE_HZ (CHANNEL_COUNT * 200 * MAINS_HZ)
+#else
+#define ADC_SAMPLE_RATE_HZ (200 * MAINS_HZ)
+#endif
+
+// Detector das ponteiras: abertas a menos de 2 códigos do fundo de escala (o
+// ruído impede que a média chegue ao código cheio), em curto abaixo de 2
+// códigos e acomodadas com 2 janelas seguidas a menos de 4 códigos uma da outra
+const probe_config_t probe_config = {
+  .open_code = ADC_MEAN(ADC_RESOLUTION - 2),
+  .short_code = ADC_MEAN(2),
+  .settle_codes = ADC_MEAN(4),
+  .settle_blocks = 2,
+};
+
+// Prazo de cada tarefa, em us, contado da liberação ao fim. A aquisição
+// precisa consumir cada janela antes da próxima (16,7 ms); o relatório dos
+// escalonadores sai pelo stdio a cada 10 s.
+#define INPUT_DEADLINE_US 20000
+#define ACQUISITION_DEADLINE_US 10000
+#define COMPUTE_DEADLINE_US 20000
+#define TELEMETRY_PERIOD_US 10000
+#define TELEMETRY_DEADLINE_US 10000
+#define REPORT_PERIOD_US 10000000
+#define REPORT_DEADLINE_US 100000
+#define RENDER_DEADLINE_US 20000
+#define DISPLAY_DEADLINE_US 100000
+#define LEDS_DEADLINE_US 20000
+#define LOG_DEADLINE_US 100000
+#define DISPLAY_RETRY_US 2000 // Nova tentativa com o DMA do I2C ocupado
+#define LEDS_RETRY_US 200     // Nova tentativa com o quadro anterior no RESET
 
 // Definição de macros para o protocolo I2C (SSD1306)
-#define I2C_PORT i2c1
+#define I2C_PORT 1 // i2c1
 #define I2C_SDA 14
 #define I2C_SCL 15
 #define SSD1306_ADDRESS 0x3C
 
-// Inicialização de variáveis
+// Centro da área do valor, entre o ícone do resistor (x = 25) e a borda (x = 126)
+#define VALUE_TEXT_CENTER_X 77
+
+// Faixas de referência: cada resistor liga um GPIO ao nó do ADC (GPIO 28).
+// A calibração (resistência de saída do GPIO e offset do ADC) parte de zero
+// e deve ser medida com resistores padrão em cada placa.
+#define RANGE_COUNT 5
+#define INITIAL_RANGE 1 // 470 ohms, a referência fixa da versão anterior
+
+const reference_range_t reference_ranges[RANGE_COUNT] = {
+  {16, RESISTANCE_OHMS(47)    , RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {17, RESISTANCE_OHMS(470)   , RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {18, RESISTANCE_OHMS(4700)  , RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {19, RESISTANCE_OHMS(47000) , RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {20, RESISTANCE_OHMS(470000), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+};
+
+#ifdef OHMIMETRO_MULTICHANNEL
+// Referência de cada canal, do GPIO ao nó da entrada CHANNEL_FIRST_INPUT +
+// canal, com a calibração dela. O canal 2 usa o resistor de 4,7k da placa; os
+// GPIOs das outras faixas são postos em alta impedância na partida, sem os
+// pull-downs, que carregariam o nó. Os canais 0 e 1 usam resistores do
+// gabarito em GPIOs livres, uma década abaixo e acima.
+const reference_range_t channel_references[CHANNEL_COUNT] = {
+  {8 , RESISTANCE_OHMS(1000) , RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {9 , RESISTANCE_OHMS(10000), RESISTANCE_OHMS(0), ADC_MEAN(0)},
+  {18, RESISTANCE_OHMS(4700) , RESISTANCE_OHMS(0), ADC_MEAN(0)},
+};
+#endif
+
+// Calibração do ADC: com o botão A pressionado na partida, o display pede
+// cada referência abaixo, ligada no lugar do resistor desconhecido, e o
+// botão A confirma. As medições usam a faixa de 470 ohms, sem correção.
+#define CALIBRATION_RANGE 1
+#define CALIBRATION_SAMPLES 20000 // 2 s por referência
+#define CALIBRATION_STEP_COUNT 7
+
+typedef struct {
+  const char *label;
+  resistance_t resistor; // RESISTANCE_INVALID: ponteiras abertas
+} calibration_step_t;
+
+const calibration_step_t calibration_steps[CALIBRATION_STEP_COUNT] = {
+  {"curto"    , RESISTANCE_OHMS(0)   },
+  {"100 ohms" , RESISTANCE_OHMS(100) },
+  {"220 ohms" , RESISTANCE_OHMS(220) },
+  {"470 ohms" , RESISTANCE_OHMS(470) },
+  {"1000 ohms", RESISTANCE_OHMS(1000)},
+  {"2200 ohms", RESISTANCE_OHMS(2200)},
+  {"aberto"   , RESISTANCE_INVALID   },
+};
+
+// Registro das medições na flash: cada valor novo apresentado (ou peça
+// contada na triagem) é guardado; o byte 'L' recebido pela serial USB exporta
+// o registro inteiro como quadros da telemetria (TELEMETRY_RECORD_LOG)
+#define LOG_EXPORT_COMMAND 'L'
+
+// Perfil dos estágios (lib/profile.h), pela serial USB: 'P' imprime o resumo
+// de cada sonda, 'Z' zera os histogramas e 'D' liga ou desliga a página de
+// depuração no display (p99 de cada sonda em us, redesenhada a cada 0,5 s)
+#define PROFILE_REPORT_COMMAND 'P'
+#define PROFILE_RESET_COMMAND 'Z'
+#define PROFILE_PAGE_COMMAND 'D'
+#define PROFILE_PAGE_PERIOD_US 500000
+
+// Modo de triagem: com o botão B pressionado na partida, cada peça inserida
+// nas ponteiras é classificada contra o valor da primeira (o alvo), com a
+// tolerância do layout. O botão A descarta o alvo e as contagens.
+#define SORTING_TOLERANCE_PPM 50000 // Ouro (5%)
+
+const char *sorting_bin_names[SORTING_BIN_COUNT] = {"ok", "fora", "errado"};
+
+const uint8_t sorting_bin_colors[SORTING_BIN_COUNT][3] = {
+  {0  , 180, 0  }, // dentro da tolerância
+  {230, 120, 0  }, // fora da tolerância
+  {230, 0  , 0  }, // valor errado
+};
+
+// Símbolo de cada compartimento na matriz: certo, x e exclamação
+const np_sprite_t sorting_bin_sprites[SORTING_BIN_COUNT] = {
+  {0x00, 0x01, 0x12, 0x0A, 0x04},
+  {0x11, 0x0A, 0x04, 0x0A, 0x11},
+  {0x04, 0x04, 0x04, 0x00, 0x04},
+};
 
-int reference_resistor = 470; // Resistência conhecida
+// Inicialização de variáveis
 
-float cumulative_adc_measure = 0.0f;
-float average_adc_measures = 0.0f;
-float unknown_resistor = 0.0;
-float closest_e24_resistor = 0.0;
+acquisition_result_t adc_result;
+sample_stats_t adc_stats;
+sample_stats_config_t stats_config;
+adc_mean_t average_adc_measures = 0;
+resistance_t unknown_resistor = 0;
+eseries_value_t closest_e24_resistor = {0, 0};
+
+// Estado da medição em curso: leitura rápida da faixa ou acumulação de blocos
+typedef enum {
+  MEASURE_RANGING,
+  MEASURE_ACCUMULATING,
+} measure_state_t;
+
+measure_state_t measure_state = MEASURE_RANGING;
+uint8_t range_switches = 0;
+
+// A medição completa só roda com a peça acomodada nas ponteiras
+probe_t probe;
+
+// Triagem: com o alvo definido a faixa fica fixa na dele, sem leitura rápida
+bool sorting_mode = false;
+bool sorting_range_locked = false;
+sorting_t sorter;
+
+// Resultado da última medição, entregue pela aquisição ao cálculo
+uint32_t measured_samples = 0;
+uint32_t measured_variance = 0;
+uint8_t measured_range = 0;
+
+#ifdef OHMIMETRO_MULTICHANNEL
+// Detector e estatística de cada canal, e as leituras entregues ao cálculo
+// (mais de um canal pode completar na mesma janela)
+multichannel_channel_t channels[CHANNEL_COUNT];
+multichannel_reading_t channel_readings[CHANNEL_COUNT];
+bool channel_pending[CHANNEL_COUNT];
+
+// Valor comercial de cada canal enviado por último ao núcleo 1, e se a peça
+// tinha saído
+eseries_value_t published_channel_e24[CHANNEL_COUNT];
+bool published_channel_open[CHANNEL_COUNT];
+bool has_published_channel[CHANNEL_COUNT];
+
+// Última medição de cada canal recebida pelo núcleo 1
+measurement_record_t presented_channels[CHANNEL_COUNT];
+bool has_presented_channel[CHANNEL_COUNT];
+#endif
+
+// Valor comercial enviado por último ao núcleo 1: medições repetidas da mesma
+// peça não geram quadros novos
+eseries_value_t published_e24 = {0, 0};
+bool has_published = false;
+
+// Última medição recebida pelo núcleo 1, redesenhada quando a matriz é ligada
+// ou desligada
+measurement_record_t presented_record;
+bool has_presented_record = false;
+
+// Registro na flash e a exportação em curso (um quadro pode esperar espaço
+// no buffer da telemetria)
+flash_log_t measurement_log;
+flash_log_cursor_t log_export_cursor;
+telemetry_sample_t log_export_sample;
+bool log_exporting = false;
+bool log_export_holding = false;
+uint32_t log_exported = 0;
+
+#ifdef OHMIMETRO_PROFILE
+// Página de depuração no lugar da medição (núcleo 1)
+volatile bool profile_page_enabled = false;
+#endif
+
+// Calibração em uso e a tabela de correção aplicada pela aquisição
+calibration_t adc_calibration;
+uint16_t adc_correction[CALIBRATION_LUT_SIZE];
 
 // define variáveis para debounce do botão
 volatile uint32_t last_time_btn_press = 0;
-bool is_matrix_enabled = true;
+volatile bool is_matrix_enabled = true;
+
+// Pressionamentos contados pela IRQ; a tarefa de entrada trata os novos. No
+// modo de calibração, antes de os escalonadores rodarem, o botão A só
+// confirma cada etapa.
+volatile uint32_t btn_a_presses = 0;
+volatile uint32_t btn_b_presses = 0;
+uint32_t handled_a_presses = 0;
+uint32_t handled_b_presses = 0;
+
+// Escalonadores e tarefas de cada núcleo (as funções ficam mais abaixo)
+void input_task_run(void);
+void acquisition_task_run(void);
+void compute_task_run(void);
+void telemetry_task_run(void);
+void log_task_run(void);
+void report_task_run(void);
+void render_task_run(void);
+void display_task_run(void);
+void leds_task_run(void);
+
+scheduler_t core0_scheduler;
+scheduler_t core1_scheduler;
+
+scheduler_task_t input_task = {.name = "entrada", .run = input_task_run, .deadline_us = INPUT_DEADLINE_US};
+scheduler_task_t acquisition_task = {.name = "aquisicao", .run = acquisition_task_run, .deadline_us = ACQUISITION_DEADLINE_US};
+scheduler_task_t compute_task = {.name = "calculo", .run = compute_task_run, .deadline_us = COMPUTE_DEADLINE_US};
+scheduler_task_t telemetry_task = {.name = "telemetria", .run = telemetry_task_run, .period_us = TELEMETRY_PERIOD_US, .deadline_us = TELEMETRY_DEADLINE_US};
+scheduler_task_t log_task = {.name = "registro", .run = log_task_run, .deadline_us = LOG_DEADLINE_US};
+scheduler_task_t report_task = {.name = "relatorio", .run = report_task_run, .period_us = REPORT_PERIOD_US, .deadline_us = REPORT_DEADLINE_US};
+scheduler_task_t render_task = {.name = "desenho", .run = render_task_run, .deadline_us = RENDER_DEADLINE_US};
+scheduler_task_t display_task = {.name = "display", .run = display_task_run, .deadline_us = DISPLAY_DEADLINE_US};
+scheduler_task_t leds_task = {.name = "leds", .run = leds_task_run, .deadline_us = LEDS_DEADLINE_US};
+
+// Medições do núcleo 0 (aquisição e cálculo) para o núcleo 1 (apresentação)
+spsc_queue_t measurement_queue;
 
 // debounce delay
 const uint32_t debounce_delay_ms = 260;
 
 ssd1306_t ssd;
 
-// Definição de tabela para valores dos resistores da série e24
-const float e24_resistor_values[24] = {1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0, 3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1};
-const int num_e24_resistor_values = sizeof(e24_resistor_values) / sizeof(e24_resistor_values[0]);
-
-const char *available_digit_colors[10] = {"preto", "marrom", "vermelho", "laranja", "amarelo", "verde", "azul", "violeta", "cinza", "branco"};
-const char *resistor_band_colors[3] = {0};
-int resistor_band_color_indexes[3] = {
-  0, // primeira banda
-  0, // segunda banda
-  0  // multiplicador
-};
-int resistor_band_list[10][3] = {
+// Cores como vistas (antes da correção de gama de npWrite)
+int resistor_band_list[12][3] = {
   {0  , 0  , 0  }, // preto
-  {255, 50 , 0  }, // marrom
-  {255, 0   , 0  }, // vermelho
-  {255, 180, 0  }, // laranja
-  {215, 215, 0  }, // amarelo
-  {0  , 255, 0  }, // verde
+  {150, 75 , 0  }, // marrom
+  {255, 0  , 0  }, // vermelho
+  {255, 140, 0  }, // laranja
+  {255, 220, 0  }, // amarelo
+  {0  , 200, 0  }, // verde
   {0  , 0  , 255}, // azul
-  {130, 0, 250}, // violeta
-  {80, 80, 30}, // cinza
-  {255, 255, 255}  // branco
+  {150, 0  , 255}, // violeta
+  {110, 110, 110}, // cinza
+  {255, 255, 255}, // branco
+  {210, 160, 30 }, // dourado
+  {170, 170, 170}  // prata
 };
 
+// Matriz na medição: as faixas na linha do meio (colunas 1 a 3, na ordem do
+// resistor) e, na linha de baixo, o desvio em relação ao valor comercial,
+// com os dois LEDs de cada lado valendo meio passo da E24 (5%)
+#define MATRIX_BANDS_ROW 2
+#define MATRIX_BANDS_COLUMN 1
+#define MATRIX_GAUGE_ROW 4
+#define MATRIX_GAUGE_FULL_SCALE_PPM 50000
+
+#ifdef OHMIMETRO_MULTICHANNEL
+// Multicanal: uma linha do display por canal (entrada, valor comercial e
+// desvio) e, na matriz, as faixas de cada canal nas linhas 0, 2 e 4
+#define CHANNEL_ROW_Y(channel) (4 + 22 * (channel))
+#define CHANNEL_VALUE_X 24
+#define MATRIX_CHANNEL_ROW(channel) (2 * (channel))
+#endif
+
+const uint8_t gauge_zero_color[3] = {90, 90, 90};
+const uint8_t gauge_bar_color[3] = {0, 90, 160};
+
 char display_text[20] = {0};
 
 void i2c_setup(uint baud_in_kilo) {
-  i2c_init(I2C_PORT, baud_in_kilo * 1000);
-
-  gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-  gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-  gpio_pull_up(I2C_SDA);
-  gpio_pull_up(I2C_SCL);
+  hal_i2c_init(I2C_PORT, baud_in_kilo * 1000, I2C_SDA, I2C_SCL);
 }
 
 void ssd1306_setup(ssd1306_t *ssd_ptr) {
@@ -86,243 +347,741 @@ void ssd1306_setup(ssd1306_t *ssd_ptr) {
 
   // Limpa o display. O display inicia com todos os pixels apagados.
   ssd1306_fill(ssd_ptr, false);
+  ssd1306_wait(ssd_ptr);
   ssd1306_send_data(ssd_ptr);
+  ssd1306_wait(ssd_ptr);
 }
 
 void gpio_irq_handler(uint gpio, uint32_t events) {
-  uint32_t current_time = to_ms_since_boot(get_absolute_time()); // retorna o tempo total em ms desde o boot do rp2040
+  (void)events; // Só a borda de descida é habilitada
+  uint32_t current_time = hal_time_ms(); // retorna o tempo total em ms desde o boot do rp2040
 
   // verifica se a diff entre o tempo atual e a ultima vez que o botão foi pressionado é maior que o tempo de debounce
   if (current_time - last_time_btn_press > debounce_delay_ms) {
     last_time_btn_press = current_time;
 
+    // A ação (inclusive o reset para o BOOTSEL) fica para a tarefa de entrada,
+    // fora do contexto de interrupção
     if (gpio == BTN_A_PIN) {
-      is_matrix_enabled = !is_matrix_enabled;
+      btn_a_presses++;
     } else if (gpio == BTN_B_PIN) {
-      reset_usb_boot(0, 0);
+      btn_b_presses++;
     }
+    scheduler_post(&input_task);
   }
 }
 
-float get_closest_e24_resistor(float resistor_value) {
-  if (resistor_value <= 0) {
-     return 0.0;
+// Espera o botão mantido na partida ser solto e os repiques da soltura
+// passarem; a borda de descida de um repique conta como um toque
+void wait_button_release(uint gpio) {
+  while (!hal_gpio_read(gpio))
+    hal_sleep_ms(10);
+  hal_sleep_ms(debounce_delay_ms);
+}
+
+// Núcleo 0, por evento: trata os botões pressionados desde a última execução
+void input_task_run(void) {
+  if (btn_b_presses != handled_b_presses) {
+    handled_b_presses = btn_b_presses;
+    hal_reset_to_bootloader();
   }
 
-  float normalized_resistor = resistor_value;
-  float exponent = 0.0f;
+  if (btn_a_presses != handled_a_presses && sorting_mode) {
+    // Triagem: a próxima peça define um novo alvo
+    handled_a_presses = btn_a_presses;
+    sorting_init(&sorter, SORTING_TOLERANCE_PPM);
+    sorting_range_locked = false;
+  }
 
-  // Normaliza o valor fornecido para a faixa [0-10]
-  while (normalized_resistor >= 10) {
-    normalized_resistor = normalized_resistor / 10;
-    exponent = exponent + 1.0;
+  if (btn_a_presses != handled_a_presses) {
+    // Um número par de toques desde a última execução se cancela
+    if ((btn_a_presses - handled_a_presses) & 1) {
+      is_matrix_enabled = !is_matrix_enabled;
+      scheduler_post(&render_task); // Redesenha a última medição
+    }
+    handled_a_presses = btn_a_presses;
   }
+}
 
-  float closest_resistor = e24_resistor_values[0];
-  float min_diff = fabs(normalized_resistor - e24_resistor_values[0]);
+// IRQ do DMA do ADC: uma janela nova libera a tarefa de aquisição
+void on_adc_block(void) {
+  scheduler_post(&acquisition_task);
+}
 
-  for (int i = 0; i < num_e24_resistor_values; i++) {
-    float curr_diff = fabs(normalized_resistor - e24_resistor_values[i]);
+// Entrega à tarefa de cálculo uma leitura sem estatística (curto ou retirada)
+void publish_reading(adc_mean_t block_mean, resistance_t resistance) {
+  average_adc_measures = block_mean;
+  unknown_resistor = resistance;
+  measured_samples = adc_result.count;
+  measured_variance = 0;
+  measured_range = ranging_current();
+  scheduler_post(&compute_task);
+}
 
-    if (curr_diff < min_diff) {
-      min_diff = curr_diff;
-      closest_resistor = e24_resistor_values[i];
-    }
+#ifdef OHMIMETRO_MULTICHANNEL
+// Núcleo 0, por janela do ADC: o resumo de cada canal passa pelo detector e
+// pela estatística dele. Curtos, retiradas e medições completas seguem para a
+// tarefa de cálculo.
+void acquisition_task_run(void) {
+  multichannel_reading_t reading;
+
+  PROFILE_START(PROFILE_ACQUISITION);
+  while (acquisition_poll(&adc_result)) {
+    uint8_t channel = adc_result.channel;
+    if (channel >= CHANNEL_COUNT) continue;
+    if (multichannel_update(&channels[channel], &adc_result, &stats_config, &reading) == MULTICHANNEL_NONE)
+      continue;
+
+    channel_readings[channel] = reading;
+    channel_pending[channel] = true;
+    scheduler_post(&compute_task);
   }
+  PROFILE_STOP(PROFILE_ACQUISITION);
+}
+#else
+// Núcleo 0, por bloco do ADC. O detector decide se há uma peça acomodada nas
+// ponteiras; sem ela, nada é medido. Com as ponteiras abertas a faixa mais
+// alta fica ativa, onde qualquer peça sai do fundo de escala, e um curto fora
+// da faixa mais baixa leva a ela antes de ser confirmado.
+//
+// Com a peça acomodada, uma leitura rápida (o próprio bloco) decide a faixa
+// da medição; após uma troca, o bloco em andamento é descartado e a leitura
+// se repete. Em seguida, acumula blocos até a medição atingir a precisão
+// desejada (o bloco da leitura rápida já é da faixa escolhida e entra na
+// conta) e entrega o resultado à tarefa de cálculo.
+void acquisition_task_run(void) {
+  PROFILE_START(PROFILE_ACQUISITION);
+  while (acquisition_poll(&adc_result)) {
+    adc_mean_t block_mean = measurement_average(adc_result.sum, adc_result.count);
+
+    switch (probe_update(&probe, block_mean)) {
+      case PROBE_EVENT_REMOVED:
+        // O display mantém a última leitura; a triagem precisa saber que a
+        // peça saiu
+        if (!sorting_range_locked && ranging_current() != RANGE_COUNT - 1) {
+          ranging_select(RANGE_COUNT - 1);
+          acquisition_flush();
+        }
+        if (sorting_mode) publish_reading(block_mean, RESISTANCE_INVALID);
+        continue;
+
+      case PROBE_EVENT_SHORTED:
+        if (!sorting_range_locked && ranging_current() != 0) {
+          ranging_select(0);
+          acquisition_flush();
+          probe_restart(&probe);
+          continue;
+        }
+        publish_reading(block_mean, RESISTANCE_OHMS(0));
+        continue;
+
+      case PROBE_EVENT_SETTLED:
+        range_switches = 0;
+        measure_state = MEASURE_RANGING;
+        break;
+
+      default:
+        break;
+    }
+
+    if (probe.state != PROBE_SETTLED) continue;
 
-  return closest_resistor * powf(10.0, exponent);
+    if (measure_state == MEASURE_RANGING) {
+      uint8_t best_range = sorting_range_locked ? ranging_current() : ranging_choose(block_mean);
+      if (best_range != ranging_current() && ++range_switches < RANGE_COUNT) {
+        ranging_select(best_range);
+        acquisition_flush();
+        continue;
+      }
+
+      range_switches = 0;
+      sample_stats_reset(&adc_stats);
+      measure_state = MEASURE_ACCUMULATING;
+    }
+
+    sample_stats_add_block(&adc_stats, adc_result.sum, adc_result.count);
+    if (!sample_stats_done(&adc_stats, &stats_config)) continue;
+
+    // A resistência usa a faixa da medição; a próxima leitura rápida pode trocá-la
+    average_adc_measures = sample_stats_estimate(&adc_stats, &stats_config);
+    unknown_resistor = ranging_resistance(average_adc_measures);
+    measured_samples = adc_stats.samples;
+    measured_variance = sample_stats_variance(&adc_stats);
+    measured_range = ranging_current();
+    measure_state = MEASURE_RANGING;
+    scheduler_post(&compute_task);
+  }
+  PROFILE_STOP(PROFILE_ACQUISITION);
 }
+#endif
+
+// Valor comercial, desvio e cores das faixas de `resistance` no registro
+void fill_record(measurement_record_t *record, resistance_t resistance) {
+  PROFILE_START(PROFILE_ESERIES);
+  get_closest_e24_resistor(resistance, &closest_e24_resistor);
+  get_band_color(&closest_e24_resistor);
+  PROFILE_STOP(PROFILE_ESERIES);
+
+  record->timestamp_ms = hal_time_ms();
+  record->resistance = resistance;
+  record->closest_e24 = closest_e24_resistor;
+  if (closest_e24_resistor.mantissa != 0)
+    record->deviation_ppm = measurement_deviation_ppm(resistance, measurement_nominal_resistance(closest_e24_resistor));
+  for (int i = 0; i < 3; ++i) {
+    record->band_names[i] = resistor_band_colors[i];
+    record->band_indexes[i] = resistor_band_color_indexes[i];
+  }
+}
+
+// Envia a medição ao núcleo 1 (só se `changed`), à telemetria e ao registro
+void publish_record(const measurement_record_t *record, bool changed) {
+  // Nunca bloqueia: se o núcleo 1 atrasar, a medição mais antiga é descartada
+  if (changed) {
+    spsc_queue_push(&measurement_queue, record);
+    scheduler_post(&render_task);
+  }
 
-void get_band_color(float *resistor_value) {
-  // Cálculo das cores de cada banda do resistor (4 bandas)
-  float normalized_resistor = *resistor_value;
-  int exponent = -1;
+  // A telemetria também descarta a mais antiga se a USB não acompanhar
+  telemetry_push(record);
 
-  // Normaliza o valor fornecido para a faixa [0-10]
-  while (normalized_resistor >= 10.0) {
-    normalized_resistor = normalized_resistor / 10;
-    exponent = exponent + 1;
+  // O registro guarda o que foi apresentado; a página completa vai para a
+  // flash fora desta tarefa
+  if (changed && record->resistance != RESISTANCE_INVALID) {
+    telemetry_sample_t sample;
+    telemetry_sample_from_record(record, &sample);
+    if (flash_log_append(&measurement_log, &sample)) scheduler_post(&log_task);
+  }
+}
+
+#ifdef OHMIMETRO_MULTICHANNEL
+// Núcleo 0, por medição: cada canal com leitura nova vira um registro, com o
+// canal no lugar da faixa para a telemetria e o registro na flash
+void compute_task_run(void) {
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; ++channel) {
+    if (!channel_pending[channel]) continue;
+    channel_pending[channel] = false;
+
+    const multichannel_reading_t *reading = &channel_readings[channel];
+    measurement_record_t record = {
+      .average_adc = reading->average_adc,
+      .adc_variance = reading->adc_variance,
+      .sample_count = reading->sample_count,
+      .range = channel,
+      .channel = channel,
+    };
+    fill_record(&record, reading->resistance);
+
+    // Só um valor comercial diferente do último do canal, ou a peça saindo,
+    // muda o que é apresentado
+    bool open = reading->resistance == RESISTANCE_INVALID;
+    bool changed = !has_published_channel[channel] || open != published_channel_open[channel] ||
+                   record.closest_e24.mantissa != published_channel_e24[channel].mantissa ||
+                   record.closest_e24.exponent != published_channel_e24[channel].exponent;
+    if (changed) {
+      published_channel_e24[channel] = record.closest_e24;
+      published_channel_open[channel] = open;
+      has_published_channel[channel] = true;
+    }
+    publish_record(&record, changed);
+  }
+}
+#else
+// Núcleo 0, por medição: valor comercial, cores e envio ao núcleo 1
+void compute_task_run(void) {
+  measurement_record_t record = {
+    .average_adc = average_adc_measures,
+    .adc_variance = measured_variance,
+    .sample_count = measured_samples,
+    .range = measured_range,
+  };
+  fill_record(&record, unknown_resistor);
+
+  // Só um valor comercial diferente do último muda o que é apresentado
+  bool changed = !has_published || closest_e24_resistor.mantissa != published_e24.mantissa ||
+                 closest_e24_resistor.exponent != published_e24.exponent;
+
+  // Triagem: classifica a peça nova e, com o alvo recém-definido, fixa a
+  // faixa dele (a medição em curso é descartada). A tela muda a cada peça
+  // contada e quando ela sai das ponteiras.
+  if (sorting_mode) {
+    bool counted = sorting_feed(&sorter, unknown_resistor, record.timestamp_ms);
+    if (counted && !sorting_range_locked) {
+      ranging_select(ranging_best(sorter.target_resistance));
+      acquisition_flush();
+      probe_restart(&probe);
+      sorting_range_locked = true;
+    }
+    sorting_status(&sorter, &record.sorting);
+    changed = counted || unknown_resistor == RESISTANCE_INVALID;
   }
 
-  // Obtenção do valor da primeira banda
-  // EX.: 3.7 => (int)(3.7) => 3
-  int first_band_value = (int)normalized_resistor;
+  if (changed) {
+    published_e24 = closest_e24_resistor;
+    has_published = true;
+  }
+  publish_record(&record, changed);
+}
+#endif
+
+// Núcleo 0, por página completa: grava o registro na flash. O núcleo 1 e as
+// interrupções param durante a gravação (e o apagamento de um setor, dezenas
+// de ms); sem a IRQ o DMA não é rearmado, então o ADC fica parado nesse
+// intervalo e recomeça com os filtros zerados
+void log_task_run(void) {
+  acquisition_stop();
+  PROFILE_START(PROFILE_FLASH);
+  flash_log_commit(&measurement_log);
+  PROFILE_STOP(PROFILE_FLASH);
+  acquisition_start();
+}
 
-  // Obtenção do valor da segunda banda
-  // EX.: 3.7 => 3.7 * 10 => 37 => 37 % 10 => 7.0 => (int)(7.0) => 7
-  int second_band_value = (int)(normalized_resistor * 10) % 10;
+// Exporta o registro até encher o buffer da telemetria; continua no próximo
+// período
+void log_export_run(void) {
+  while (log_exporting) {
+    if (!log_export_holding) {
+      if (!flash_log_next(&measurement_log, &log_export_cursor, &log_export_sample)) {
+        log_exporting = false;
+        printf("registro: %lu medicoes exportadas\n", (unsigned long)log_exported);
+        break;
+      }
+      log_export_holding = true;
+    }
+    if (!telemetry_send(&log_export_sample)) break;
+    log_export_holding = false;
+    log_exported++;
+  }
+}
 
-  // Definição da das Bandas 1, 2 e multiplicador
-  resistor_band_colors[0] = available_digit_colors[first_band_value % 10];
-  resistor_band_colors[1] = available_digit_colors[second_band_value % 10];
-  resistor_band_colors[2] = (exponent >= 0 && exponent <= 9) ? available_digit_colors[exponent] : "erro";
+// Núcleo 0, periódica: comandos recebidos pela serial USB e envio das
+// medições acumuladas (e do registro, durante a exportação)
+void telemetry_task_run(void) {
+  uint8_t command;
+  while (hal_usb_read(&command, 1)) {
+    if (command == LOG_EXPORT_COMMAND && !log_exporting) {
+      flash_log_cursor_init(&measurement_log, &log_export_cursor);
+      log_exporting = true;
+      log_export_holding = false;
+      log_exported = 0;
+    }
+#ifdef OHMIMETRO_PROFILE
+    if (command == PROFILE_REPORT_COMMAND) profile_report();
+    if (command == PROFILE_RESET_COMMAND) profile_reset();
+    if (command == PROFILE_PAGE_COMMAND) {
+      profile_page_enabled = !profile_page_enabled;
+      scheduler_post(&render_task);
+    }
+#endif
+  }
 
-  resistor_band_color_indexes[0] = first_band_value % 10;
-  resistor_band_color_indexes[1] = second_band_value % 10;
-  resistor_band_color_indexes[2] = (exponent >= 0 && exponent <= 9) ? exponent : 0;
+  log_export_run();
+  telemetry_flush();
 }
 
-void draw_display_layout(ssd1306_t *ssd_ptr) {
-  // desenho dos contornos do layout do display
-  ssd1306_rect(ssd_ptr, 1, 1, 126, 62, 1, 0);
-  //cima
-  ssd1306_line(ssd_ptr, 5, 5, 5, 11, 1);
-  ssd1306_line(ssd_ptr, 6, 4, 10, 4, 1);
-  ssd1306_line(ssd_ptr, 10, 5, 20, 5, 1);
-  //baixo
-  ssd1306_line(ssd_ptr, 6, 12, 10, 12, 1);
-  ssd1306_line(ssd_ptr, 10, 11, 20, 11, 1);
-  //primeira faixa
-  ssd1306_line(ssd_ptr, 8, 4, 8, 12, 1);
-  ssd1306_line(ssd_ptr, 9, 4, 9, 12, 1);
-  //segunda faixa
-  ssd1306_line(ssd_ptr, 13, 5, 13, 11, 1);
-  ssd1306_line(ssd_ptr, 14, 5, 14, 11, 1);
-  //multiplicador
-  ssd1306_line(ssd_ptr, 17, 5, 17, 11, 1);
-  ssd1306_line(ssd_ptr, 18, 5, 18, 11, 1);
-  //tolerancia
-  ssd1306_line(ssd_ptr, 21, 5, 21, 11, 1);
-  ssd1306_line(ssd_ptr, 22, 5, 22, 11, 1);
-  //cima
-  ssd1306_line(ssd_ptr, 20, 4, 24, 4, 1);
-  ssd1306_line(ssd_ptr, 20, 12, 24, 12, 1);
-  ssd1306_line(ssd_ptr, 25, 5, 25, 11, 1);
-
-  // seta para a tolerancia
-  ssd1306_line(ssd_ptr, 21, 15, 21, 23, 1);
-  ssd1306_line(ssd_ptr, 22, 15, 22, 23, 1);
-
-  ssd1306_line(ssd_ptr, 22, 22, 50, 22, 1);
-  ssd1306_line(ssd_ptr, 22, 23, 50, 23, 1);
-
-  ssd1306_line(ssd_ptr, 50, 20, 50, 25, 1);
-  ssd1306_line(ssd_ptr, 51, 21, 51, 24, 1);
-  ssd1306_line(ssd_ptr, 52, 22, 52, 23, 1);
-
-  // seta para o multiplicador
-  ssd1306_line(ssd_ptr, 17, 15, 17, 35, 1);
-  ssd1306_line(ssd_ptr, 18, 15, 18, 35, 1);
-
-  ssd1306_line(ssd_ptr, 18, 34, 50, 34, 1);
-  ssd1306_line(ssd_ptr, 18, 35, 50, 35, 1);
-
-  ssd1306_line(ssd_ptr, 50, 32, 50, 37, 1);
-  ssd1306_line(ssd_ptr, 51, 33, 51, 36, 1);
-  ssd1306_line(ssd_ptr, 52, 34, 52, 35, 1);
-
-  // seta para a segunda faixa
-  ssd1306_line(ssd_ptr, 13, 15, 13, 47, 1);
-  ssd1306_line(ssd_ptr, 14, 15, 14, 47, 1);
-
-  ssd1306_line(ssd_ptr, 14, 46, 50, 46, 1);
-  ssd1306_line(ssd_ptr, 14, 47, 50, 47, 1);
-
-  ssd1306_line(ssd_ptr, 50, 44, 50, 49, 1);
-  ssd1306_line(ssd_ptr, 51, 45, 51, 48, 1);
-  ssd1306_line(ssd_ptr, 52, 46, 52, 47, 1);
-
-  // seta para a primeira faixa
-  ssd1306_line(ssd_ptr, 8, 15, 8, 57, 1);
-  ssd1306_line(ssd_ptr, 9, 15, 9, 57, 1);
-
-  ssd1306_line(ssd_ptr, 9, 56, 50, 56, 1);
-  ssd1306_line(ssd_ptr, 9, 57, 50, 57, 1);
-
-  ssd1306_line(ssd_ptr, 50, 54, 50, 59, 1);
-  ssd1306_line(ssd_ptr, 51, 55, 51, 58, 1);
-  ssd1306_line(ssd_ptr, 52, 56, 52, 57, 1);
+// Núcleo 0, periódica: estatísticas dos dois escalonadores no stdio
+void report_task_run(void) {
+  scheduler_report(&core0_scheduler, "nucleo0");
+  scheduler_report(&core1_scheduler, "nucleo1");
+  if (sorting_mode) sorting_report(&sorter);
+  printf("registro: %lu paginas gravadas, %lu setores apagados, %lu paginas puladas\n",
+         (unsigned long)measurement_log.pages_written, (unsigned long)measurement_log.sectors_erased,
+         (unsigned long)measurement_log.pages_skipped);
 }
 
-int main() {
-  // [INÍCIO] modo BOOTSEL associado ao botão B (apenas para desenvolvedores)
-  gpio_init(BTN_B_PIN);
-  gpio_set_dir(BTN_B_PIN, GPIO_IN);
-  gpio_pull_up(BTN_B_PIN);
-  gpio_set_irq_enabled_with_callback(BTN_B_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
-  // [FIM] modo BOOTSEL associado ao botão B (apenas para desenvolvedores)
+// Núcleo 1: tela da triagem (alvo, última peça, contagens e vazão) e o
+// símbolo do compartimento na matriz enquanto a peça estiver nas ponteiras
+void render_sorting(const sorting_status_t *sorting) {
+  char text[32];
 
-  gpio_init(BTN_A_PIN);
-  gpio_set_dir(BTN_A_PIN, GPIO_IN);
-  gpio_pull_up(BTN_A_PIN);
-  gpio_set_irq_enabled(BTN_A_PIN, GPIO_IRQ_EDGE_FALL, true);
+  ssd1306_fill(&ssd, false);
+  npClear();
 
-  // Inicialização do protocolo I2C com 400Khz e inicialização do display
-  i2c_setup(400);
-  ssd1306_setup(&ssd);
+  if (!sorting->has_target) {
+    ssd1306_draw_string(&ssd, "Triagem", 4, 8);
+    ssd1306_draw_string(&ssd, "insira a peca", 4, 28);
+    ssd1306_draw_string(&ssd, "de referencia", 4, 40);
+    return;
+  }
 
-  // Inicialização do ADC para o pino 28
-  adc_init();
-  adc_gpio_init(ADC_PIN);
+  strcpy(text, "Alvo ");
+  size_t length = 5 + measurement_format_engineering(text + 5, sizeof(text) - 5, &sorting->target);
+  snprintf(text + length, sizeof(text) - length, " %lu%%",
+           (unsigned long)(sorting->tolerance_ppm / 10000));
+  ssd1306_draw_string(&ssd, text, 4, 4);
+
+  // Última peça: desvio em décimos de %, ou o valor dela se for de outro valor
+  const sorting_result_t *last = &sorting->last;
+  if (last->bin == SORTING_WRONG_VALUE) {
+    strcpy(text, "> errado ");
+    measurement_format_engineering(text + 9, sizeof(text) - 9, &last->closest);
+  } else {
+    uint32_t magnitude = last->deviation_ppm < 0 ? -last->deviation_ppm : last->deviation_ppm;
+    uint32_t tenths = (magnitude + 500) / 1000;
+    snprintf(text, sizeof(text), "> %s %c%lu.%lu%%", sorting_bin_names[last->bin],
+             last->deviation_ppm < 0 ? '-' : '+', (unsigned long)(tenths / 10), (unsigned long)(tenths % 10));
+  }
+  ssd1306_draw_string(&ssd, text, 4, 16);
+
+  snprintf(text, sizeof(text), "ok %lu fora %lu",
+           (unsigned long)sorting->bins[SORTING_IN_TOLERANCE],
+           (unsigned long)sorting->bins[SORTING_OUT_OF_TOLERANCE]);
+  ssd1306_draw_string(&ssd, text, 4, 30);
+  snprintf(text, sizeof(text), "errado %lu", (unsigned long)sorting->bins[SORTING_WRONG_VALUE]);
+  ssd1306_draw_string(&ssd, text, 4, 40);
+  snprintf(text, sizeof(text), "%lu pecas/min", (unsigned long)sorting->parts_per_minute);
+  ssd1306_draw_string(&ssd, text, 4, 52);
+
+  if (sorting->part_present) {
+    const uint8_t *color = sorting_bin_colors[last->bin];
+    npDrawSprite(sorting_bin_sprites[last->bin], color[0], color[1], color[2]);
+  }
+}
 
-  // Inicializa matriz de LEDs NeoPixel.
-  npInit(LED_PIN);
+#ifdef OHMIMETRO_PROFILE
+// Núcleo 1: página de depuração, com o nome e o p99 (em us) de cada sonda
+void render_profile_page(void) {
+  char text[12];
+  profile_summary_t summary;
+
+  ssd1306_fill(&ssd, false);
+  for (int i = 0; i < PROFILE_PROBE_COUNT; ++i) {
+    profile_summary(i, &summary);
+    snprintf(text, sizeof(text), "%lu",
+             (unsigned long)((summary.p99 + HAL_CYCLES_PER_US / 2) / HAL_CYCLES_PER_US));
+    ssd1306_draw_string(&ssd, profile_probes[i].name, 0, i * 8);
+    ssd1306_draw_text(&ssd, text, WIDTH, i * 8, SSD1306_ALIGN_RIGHT);
+  }
+}
+#endif
+
+#ifdef OHMIMETRO_MULTICHANNEL
+// Núcleo 1: uma linha por canal, com a entrada do ADC, o valor comercial (ou
+// "aberto") e o desvio em décimos de %, e as faixas de cada canal na matriz
+void render_channels(void) {
+  char text[12];
+
+  ssd1306_fill(&ssd, false);
+  ssd1306_hline(&ssd, 0, WIDTH - 1, CHANNEL_ROW_Y(1) - 4, true);
+  ssd1306_hline(&ssd, 0, WIDTH - 1, CHANNEL_ROW_Y(2) - 4, true);
   npClear();
 
-  npSetBrightness(255);
-  npWrite();
+  PROFILE_START(PROFILE_TEXT);
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; ++channel) {
+    const measurement_record_t *record = &presented_channels[channel];
+    uint8_t y = CHANNEL_ROW_Y(channel);
+
+    snprintf(text, sizeof(text), "A%u", CHANNEL_FIRST_INPUT + channel);
+    ssd1306_draw_string(&ssd, text, 2, y);
+
+    if (!has_presented_channel[channel]) {
+      ssd1306_draw_string(&ssd, "--", CHANNEL_VALUE_X, y);
+      continue;
+    }
+    if (record->resistance == RESISTANCE_INVALID) {
+      ssd1306_draw_string(&ssd, "aberto", CHANNEL_VALUE_X, y);
+      continue;
+    }
 
-  while (true) {
-    // Seleciona o ADC para pino 28 como entrada analógica
-    adc_select_input(2);
+    measurement_format_engineering(display_text, sizeof(display_text), &record->closest_e24);
+    ssd1306_draw_string(&ssd, display_text, CHANNEL_VALUE_X, y);
+    if (record->closest_e24.mantissa == 0) continue;
 
-    // Obtenção de várias leituras seguidas e média
-    cumulative_adc_measure = 0.0f;
+    uint32_t magnitude = record->deviation_ppm < 0 ? -record->deviation_ppm : record->deviation_ppm;
+    uint32_t tenths = (magnitude + 500) / 1000;
+    snprintf(text, sizeof(text), "%c%lu.%lu%%", record->deviation_ppm < 0 ? '-' : '+',
+             (unsigned long)(tenths / 10), (unsigned long)(tenths % 10));
+    ssd1306_draw_text(&ssd, text, WIDTH - 2, y, SSD1306_ALIGN_RIGHT);
 
-    for (int i = 0; i < 500; i++) {
-      cumulative_adc_measure += adc_read();
-      sleep_ms(1);
+    if (is_matrix_enabled) {
+      for (int i = 0; i < 3; ++i) {
+        const int *color = resistor_band_list[record->band_indexes[i]];
+        npSetPixel(MATRIX_BANDS_COLUMN + i, MATRIX_CHANNEL_ROW(channel), color[0], color[1], color[2]);
+      }
     }
+  }
+  PROFILE_STOP(PROFILE_TEXT);
+}
+#endif
+
+// Núcleo 1, por medição (ou troca do botão A): desenha a medição mais recente
+// no display e na matriz de LEDs
+void render_task_run(void) {
+#ifdef OHMIMETRO_MULTICHANNEL
+  // A última medição de cada canal que estiver na fila
+  measurement_record_t record_in;
+  while (spsc_queue_pop(&measurement_queue, &record_in)) {
+    if (record_in.channel >= CHANNEL_COUNT) continue;
+    presented_channels[record_in.channel] = record_in;
+    has_presented_channel[record_in.channel] = true;
+  }
+#else
+  // Apresenta sempre a medição mais recente que estiver na fila
+  while (spsc_queue_pop(&measurement_queue, &presented_record))
+    has_presented_record = true;
+#endif
+
+#ifdef OHMIMETRO_PROFILE
+  // Página de depuração: só o display, redesenhado periodicamente
+  if (profile_page_enabled) {
+    render_profile_page();
+    scheduler_post(&display_task);
+    scheduler_defer(&render_task, PROFILE_PAGE_PERIOD_US);
+    return;
+  }
+#endif
+
+#ifdef OHMIMETRO_MULTICHANNEL
+  render_channels();
+  scheduler_post(&display_task);
+  scheduler_post(&leds_task);
+  return;
+#endif
+
+  // Nenhuma peça medida desde a partida: só o layout
+  if (!has_presented_record) {
+    ssd1306_compose(&ssd, layout_background);
+    npClear();
+    scheduler_post(&display_task);
+    scheduler_post(&leds_task);
+    return;
+  }
 
-    average_adc_measures = cumulative_adc_measure / 500.0f;
+  const measurement_record_t *record = &presented_record;
 
-    // Cálculo da resistencia em ohms e obtenção do valor comercial mais próximo
-    unknown_resistor = (reference_resistor * average_adc_measures) / (adc_resolution - average_adc_measures);
-    closest_e24_resistor = get_closest_e24_resistor(unknown_resistor);
+  if (record->sorting.active) {
+    render_sorting(&record->sorting);
+    scheduler_post(&display_task);
+    scheduler_post(&leds_task);
+    return;
+  }
 
-    get_band_color(&closest_e24_resistor);
+  // Quadro base: layout estático pré-renderizado (inclui o rótulo da tolerância)
+  PROFILE_START(PROFILE_LAYOUT);
+  ssd1306_compose(&ssd, layout_background);
+  PROFILE_STOP(PROFILE_LAYOUT);
 
-    // Limpeza do display
-    ssd1306_fill(&ssd, false);
-    draw_display_layout(&ssd);
+  // Exibição do valor comercial da resistência mais próxima, centralizado
+  // entre o ícone do resistor e a borda
+  PROFILE_START(PROFILE_TEXT);
+  measurement_format_engineering(display_text, sizeof(display_text), &record->closest_e24);
+  ssd1306_draw_text(&ssd, display_text, VALUE_TEXT_CENTER_X, 5, SSD1306_ALIGN_CENTER);
 
-    // Exibição do valor comercial da resistência mais próxima
-    sprintf(display_text, "%.0f ohms", closest_e24_resistor);
-    ssd1306_draw_string(&ssd, display_text, 29, 5);
+  // Exibição das cores de cada banda (Multiplicador Faixa_2 Faixa_1)
+  ssd1306_draw_string(&ssd, record->band_names[2], 60, 31);
+  ssd1306_draw_string(&ssd, record->band_names[1], 60, 42);
+  ssd1306_draw_string(&ssd, record->band_names[0], 60, 52);
+  PROFILE_STOP(PROFILE_TEXT);
 
-    // Exibição das cores de cada banda (Tolerância Multiplicador Faixa_2 Faixa_1)
-    ssd1306_draw_string(&ssd, "Au (5%)", 60, 20);
-    ssd1306_draw_string(&ssd, resistor_band_colors[2], 60, 31);
-    ssd1306_draw_string(&ssd, resistor_band_colors[1], 60, 42);
-    ssd1306_draw_string(&ssd, resistor_band_colors[0], 60, 52);
+  npClear();
 
-    // Verifica se matriz está habilitada
-    if (is_matrix_enabled) {
-      // Exibe as cores na matriz
-      npSetLED(13,
-        resistor_band_list[resistor_band_color_indexes[0]][0],
-        resistor_band_list[resistor_band_color_indexes[0]][1],
-        resistor_band_list[resistor_band_color_indexes[0]][2]
-      ); // primeira banda
-      npSetLED(12,
-        resistor_band_list[resistor_band_color_indexes[1]][0],
-        resistor_band_list[resistor_band_color_indexes[1]][1],
-        resistor_band_list[resistor_band_color_indexes[1]][2]
-      ); // segunda banda
-      npSetLED(11,
-        resistor_band_list[resistor_band_color_indexes[2]][0],
-        resistor_band_list[resistor_band_color_indexes[2]][1],
-        resistor_band_list[resistor_band_color_indexes[2]][2]
-      ); // multiplicador
-    } else {
-      npClear();
+  // Verifica se matriz está habilitada (e se o valor está na série)
+  if (is_matrix_enabled && record->closest_e24.mantissa != 0) {
+    // Primeira banda, segunda banda e multiplicador, e o desvio abaixo
+    for (int i = 0; i < 3; ++i) {
+      const int *color = resistor_band_list[record->band_indexes[i]];
+      npSetPixel(MATRIX_BANDS_COLUMN + i, MATRIX_BANDS_ROW, color[0], color[1], color[2]);
+    }
+    npDrawGauge(MATRIX_GAUGE_ROW, record->deviation_ppm, MATRIX_GAUGE_FULL_SCALE_PPM,
+                gauge_zero_color, gauge_bar_color);
+  }
+
+  scheduler_post(&display_task);
+  scheduler_post(&leds_task);
+}
+
+// Núcleo 1: envio por DMA do quadro desenhado. Com o envio anterior ainda no
+// barramento, as regiões alteradas continuam marcadas e a tarefa tenta de novo.
+void display_task_run(void) {
+  if (!ssd1306_send_data(&ssd))
+    scheduler_defer(&display_task, DISPLAY_RETRY_US);
+}
+
+// Núcleo 1: envio do quadro da matriz, sem esperar o RESET do anterior
+void leds_task_run(void) {
+  if (hal_ws2818b_busy()) {
+    scheduler_defer(&leds_task, LEDS_RETRY_US);
+    return;
+  }
+  PROFILE_START(PROFILE_LEDS);
+  npWrite();
+  PROFILE_STOP(PROFILE_LEDS);
+}
+
+// Mensagem de até três linhas do modo de calibração (núcleo 0, antes de o
+// núcleo 1 assumir o display)
+void show_calibration_message(const char *line1, const char *line2, const char *line3) {
+  ssd1306_fill(&ssd, false);
+  ssd1306_draw_string(&ssd, line1, 4, 8);
+  ssd1306_draw_string(&ssd, line2, 4, 28);
+  ssd1306_draw_string(&ssd, line3, 4, 48);
+
+  // Na calibração nenhuma outra tarefa envia o quadro: a mensagem só volta
+  // quando o envio começou
+  ssd1306_wait(&ssd);
+  while (!ssd1306_send_data(&ssd))
+    ssd1306_wait(&ssd);
+}
+
+// Mede cada referência de calibration_steps sem correção, ajusta offset,
+// ganho e INL e grava o resultado na flash
+void run_adc_calibration(void) {
+  const reference_range_t *range = &reference_ranges[CALIBRATION_RANGE];
+  calibration_point_t points[CALIBRATION_STEP_COUNT];
+
+  ranging_select(CALIBRATION_RANGE);
+  acquisition_set_correction(NULL);
+
+  // O A da partida ainda está pressionado: o toque de cada referência só
+  // conta depois de ele ser solto
+  show_calibration_message("Calibracao ADC", "solte A", "");
+  wait_button_release(BTN_A_PIN);
+
+  for (int i = 0; i < CALIBRATION_STEP_COUNT; ++i) {
+    show_calibration_message("Calibracao ADC", calibration_steps[i].label, "aperte A");
+    uint32_t presses = btn_a_presses;
+    while (btn_a_presses == presses)
+      hal_idle_wait();
+
+    show_calibration_message("Calibracao ADC", calibration_steps[i].label, "medindo...");
+    acquisition_flush();
+
+    uint32_t sum = 0, count = 0;
+    while (count < CALIBRATION_SAMPLES) {
+      acquisition_wait(&adc_result);
+      sum += adc_result.sum;
+      count += adc_result.count;
     }
 
-    npWrite();
+    points[i].measured = measurement_average(sum, count);
+    printf("calibracao: %s medido\n", calibration_steps[i].label);
+    points[i].expected = calibration_divider_code(range->reference + range->series, calibration_steps[i].resistor);
+  }
+
+  if (calibration_fit(points, CALIBRATION_STEP_COUNT, &adc_calibration)) {
+    // Com as interrupções paradas o DMA não é rearmado e passaria do anel
+    acquisition_stop();
+    calibration_save(&adc_calibration);
+    acquisition_start();
+    calibration_build_lut(&adc_calibration, adc_correction);
+    show_calibration_message("Calibracao ADC", "gravada", "");
+  } else {
+    show_calibration_message("Calibracao ADC", "falhou", "");
+  }
+
+  acquisition_set_correction(adc_correction);
+  acquisition_flush();
+  handled_a_presses = btn_a_presses; // Os toques da calibração não trocam a matriz
+  hal_sleep_ms(1500);
+}
+
+void core1_entry(void) {
+  scheduler_init(&core1_scheduler);
+  scheduler_add(&core1_scheduler, &render_task);
+  scheduler_add(&core1_scheduler, &display_task);
+  scheduler_add(&core1_scheduler, &leds_task);
+  scheduler_post(&render_task); // Layout vazio até a primeira peça
+  scheduler_run(&core1_scheduler);
+}
+
+int main() {
+  // [INÍCIO] modo BOOTSEL associado ao botão B (apenas para desenvolvedores)
+  hal_gpio_input_pullup(BTN_B_PIN);
+  hal_gpio_irq_enable(BTN_B_PIN, &gpio_irq_handler);
+  // [FIM] modo BOOTSEL associado ao botão B (apenas para desenvolvedores)
+
+  hal_gpio_input_pullup(BTN_A_PIN);
+  hal_gpio_irq_enable(BTN_A_PIN, &gpio_irq_handler);
+
+  // Inicialização do protocolo I2C com 400Khz e inicialização do display
+  i2c_setup(400);
+  ssd1306_setup(&ssd);
+
+  // Calibração do ADC gravada na flash; sem ela, os códigos passam inalterados
+  if (!calibration_load(&adc_calibration))
+    calibration_identity(&adc_calibration);
+  calibration_build_lut(&adc_calibration, adc_correction);
+
+  // Registro das medições: continua depois da página mais recente na flash
+  flash_log_mount(&measurement_log);
+
+  // Inicialização do ADC para o pino 28 em modo free-running com DMA. Cada
+  // janela completa do filtro da rede libera a tarefa de aquisição.
+  acquisition_config_t acquisition_config = {
+#ifdef OHMIMETRO_MULTICHANNEL
+    .input = CHANNEL_FIRST_INPUT,
+    .channels = CHANNEL_COUNT,
+#else
+    .input = ADC_INPUT,
+#endif
+    .sample_rate_hz = ADC_SAMPLE_RATE_HZ,
+    .correction = adc_correction,
+    .on_block = on_adc_block,
+#ifdef OHMIMETRO_RATIOMETRIC
+    .ratiometric = true,
+    .reference_input = ADC_REFERENCE_INPUT,
+    .reference_gain_q16 = ADC_REFERENCE_GAIN_Q16,
+#endif
+    .mains_hz = MAINS_HZ,
+  };
+  if (!acquisition_init(&acquisition_config))
+    printf("Filtro da rede desligado: sem janela de ciclos inteiros a %d Hz\n", ADC_SAMPLE_RATE_HZ);
+#ifdef OHMIMETRO_MULTICHANNEL
+  // Sem a troca de faixa, ninguém solta os GPIOs das faixas; o de 4,7k volta
+  // a ser a referência do canal 2 logo abaixo
+  for (uint8_t i = 0; i < RANGE_COUNT; ++i)
+    hal_gpio_float(reference_ranges[i].gpio);
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+    multichannel_init(&channels[channel], CHANNEL_FIRST_INPUT + channel, &channel_references[channel], &probe_config);
+#else
+  ranging_init(reference_ranges, RANGE_COUNT, INITIAL_RANGE);
+  probe_init(&probe, &probe_config);
+#endif
+
+  stats_config = (sample_stats_config_t){
+    .estimator = SAMPLE_STATS_TRIMMED_MEAN,
+    .min_samples = MIN_SAMPLES_PER_MEASURE,
+    .max_samples = MAX_SAMPLES_PER_MEASURE,
+    .relative_step = eseries_relative_step(ESERIES_E24),
+    .step_fraction = STEP_FRACTION,
+  };
+
+  // Inicializa matriz de LEDs NeoPixel.
+  npInit(LED_PIN);
+  npClear();
+  npWrite();
 
-    ssd1306_send_data(&ssd);
-    sleep_ms(700);
+  acquisition_start();
+
+#ifndef OHMIMETRO_MULTICHANNEL
+  // Botão A pressionado na partida: modo de calibração, antes de o núcleo 1
+  // começar a rodar da flash. A tabela gravada vale também no multicanal.
+  if (!hal_gpio_read(BTN_A_PIN))
+    run_adc_calibration();
+
+  // Botão B pressionado na partida: modo de triagem. B é também o botão do
+  // BOOTSEL: o repique da soltura não pode chegar à tarefa de entrada
+  if (!hal_gpio_read(BTN_B_PIN)) {
+    sorting_mode = true;
+    sorting_init(&sorter, SORTING_TOLERANCE_PPM);
+    wait_button_release(BTN_B_PIN);
+    handled_b_presses = btn_b_presses;
   }
+#endif
+
+  // Renderização, display e LEDs passam a rodar no núcleo 1
+  spsc_queue_init(&measurement_queue);
+  telemetry_init();
+  hal_core1_launch(core1_entry);
+
+  // Núcleo 0: entrada, aquisição e cálculo; dorme em WFE entre as tarefas
+  scheduler_init(&core0_scheduler);
+  scheduler_add(&core0_scheduler, &input_task);
+  scheduler_add(&core0_scheduler, &acquisition_task);
+  scheduler_add(&core0_scheduler, &compute_task);
+  scheduler_add(&core0_scheduler, &telemetry_task);
+  scheduler_add(&core0_scheduler, &log_task);
+  scheduler_add(&core0_scheduler, &report_task);
+  scheduler_run(&core0_scheduler);
 
   return 0;
 }